@@ -40,15 +40,24 @@
 #include "password.h"
 #include "terminal.h"
 #include "process.h"
+#include "clipboard.h"
+#include "session.h"
+#include "endpoints.h"
+#include "list.h"
 #include <unistd.h>
+#include <stdint.h>
+#include <poll.h>
 #include <string.h>
 #include <fcntl.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 #include <sys/un.h>
 #include <sys/mman.h>
+#include <sys/wait.h>
 #include <errno.h>
 #include <signal.h>
+#include <time.h>
 #if (defined(__unix__) || defined(unix)) && !defined(USG)
 #include <sys/param.h>
 #endif
@@ -67,17 +76,108 @@ struct ucred {
 };
 #endif
 
+#if !defined(MSG_NOSIGNAL)
+#define MSG_NOSIGNAL 0
+#endif
+
 #define AGENT_VERIFICATION_STRING "`lpass` was written by LastPass.\n"
 
+/*
+ * One agent holds the keys of every profile.  A client first names its
+ * profile: a hello, then name_len bytes of name, then for AGENT_ADD the
+ * key to keep for timeout seconds (0 for ever).  The agent answers with
+ * one status byte, followed for AGENT_GET by the profile's key.
+ *
+ * After the key, a client may send the agent one request: a header,
+ * then meta_len bytes of metadata and data_len bytes of data.  The
+ * agent answers with one status byte.
+ *
+ * A client has AGENT_REQUEST_TIMEOUT_MS to start either, and each read
+ * or write after that must make progress within AGENT_IO_TIMEOUT_SEC,
+ * so that a stalled client cannot hold up the agent.
+ */
+#define AGENT_REQUEST_TIMEOUT_MS 250
+#define AGENT_IO_TIMEOUT_SEC 1
+#define AGENT_PROFILE_NAME_MAX 255
+
+enum agent_op {
+	AGENT_GET,
+	AGENT_ADD,
+	AGENT_DROP,
+};
+
+struct agent_hello {
+	char magic[4];
+	uint32_t op;
+	uint32_t name_len;
+	uint32_t timeout;
+};
+
+struct agent_profile {
+	char *name;
+	unsigned char key[KDF_HASH_LEN];
+	time_t expires;
+
+	struct list_head list;
+};
+
+static LIST_HEAD(profiles);
+
+struct agent_request {
+	char magic[4];
+	uint32_t meta_len;
+	uint32_t data_len;
+	uint32_t clear_after;
+};
+
+/*
+ * The server session is kept alive with a login_check every
+ * LPASS_AGENT_KEEPALIVE seconds, from a child so that a slow request
+ * never holds up a client.
+ */
+#define AGENT_KEEPALIVE_DEFAULT (10 * 60)
+
+static unsigned int keepalive_interval;
+static time_t keepalive_deadline;
+static volatile pid_t keepalive_pid;
+
+/*
+ * The clipboard owner makes and clears every copy for the agent.  It is
+ * started with the first copy and kept, so that copies do not each
+ * leave a process behind to clear them.
+ */
+static int clipboard_fd = -1;
+static volatile pid_t clipboard_pid;
+
+/*
+ * Check a decryption key against the verification string written at
+ * login time.
+ */
+bool agent_verify_key(unsigned const char key[KDF_HASH_LEN])
+{
+	_cleanup_free_ char *verify = config_read_encrypted_string("verify", key);
+
+	return verify && !strcmp(verify, AGENT_VERIFICATION_STRING);
+}
+
 static inline char *agent_socket_path(void)
 {
 	return config_path("agent.sock");
 }
 
+/* how long the agent keeps a key, from LPASS_AGENT_TIMEOUT */
+static unsigned int agent_timeout(void)
+{
+	char *agent_timeout_str = getenv("LPASS_AGENT_TIMEOUT");
+
+	if (agent_timeout_str && strlen(agent_timeout_str))
+		return strtoul(agent_timeout_str, NULL, 10);
+	return 60 * 60; /* One hour by default. */
+}
+
 bool agent_load_key(unsigned char key[KDF_HASH_LEN])
 {
 	_cleanup_free_ char *iterationbuf = NULL;
-	_cleanup_free_ char *verify = NULL;
 	_cleanup_free_ char *username = NULL;
 	_cleanup_free_ char *password = NULL;
 	int iterations;
@@ -100,14 +200,29 @@ bool agent_load_key(unsigned char key[KDF_HASH_LEN])
 		/* no longer need password contents, zero it */
 		secure_clear_str(password);
 
-		verify = config_read_encrypted_string("verify", key);
-		if (verify && !strcmp(verify, AGENT_VERIFICATION_STRING))
+		if (agent_verify_key(key))
 			break;
 	}
 
 	return true;
 }
 
+static void agent_reap_children(int signal)
+{
+	int saved_errno = errno;
+
+	pid_t pid;
+
+	UNUSED(signal);
+	while ((pid = waitpid(-1, NULL, WNOHANG)) > 0) {
+		if (pid == keepalive_pid)
+			keepalive_pid = 0;
+		if (pid == clipboard_pid)
+			clipboard_pid = 0;
+	}
+	errno = saved_errno;
+}
+
 _noreturn_ static void agent_cleanup(int signal)
 {
 	UNUSED(signal);
@@ -156,13 +271,301 @@ int _setup_agent_socket(struct sockaddr_un *sa, char *path)
 	return fd;
 }
 
-static void agent_run(unsigned const char key[KDF_HASH_LEN])
+static bool agent_start_clipboard(void)
+{
+	struct agent_profile *profile;
+	sigset_t mask, old_mask;
+	int fds[2];
+	pid_t child;
+
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0)
+		return false;
+
+	/* the child must not be reaped before its pid is recorded */
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGCHLD);
+	sigprocmask(SIG_BLOCK, &mask, &old_mask);
+
+	child = fork();
+	if (child == 0) {
+		signal(SIGHUP, SIG_DFL);
+		signal(SIGINT, SIG_DFL);
+		signal(SIGQUIT, SIG_DFL);
+		signal(SIGTERM, SIG_DFL);
+		signal(SIGCHLD, SIG_DFL);
+		sigprocmask(SIG_SETMASK, &old_mask, NULL);
+		close(fds[0]);
+		/* it has no use for the keys */
+		list_for_each_entry(profile, &profiles, list)
+			secure_clear(profile->key, KDF_HASH_LEN);
+		clipboard_owner_run(fds[1], NULL);
+	}
+	close(fds[1]);
+	if (child > 0) {
+		clipboard_pid = child;
+		clipboard_fd = fds[0];
+		fcntl(clipboard_fd, F_SETFD, FD_CLOEXEC);
+	} else {
+		close(fds[0]);
+	}
+	sigprocmask(SIG_SETMASK, &old_mask, NULL);
+	return child > 0;
+}
+
+/*
+ * Pass a client's copy on to the clipboard owner, starting it again if
+ * it has gone.  Takes ownership of meta and data.
+ */
+static bool agent_clipboard(char *meta, size_t meta_len, char *data, size_t data_len,
+			    unsigned int clear_after)
+{
+	bool ret = false;
+	int attempt;
+
+	for (attempt = 0; attempt < 2 && !ret; attempt++) {
+		if (clipboard_fd >= 0 && !clipboard_pid) {
+			close(clipboard_fd);
+			clipboard_fd = -1;
+		}
+		if (clipboard_fd < 0 && !agent_start_clipboard())
+			break;
+		ret = clipboard_send(clipboard_fd, meta, meta_len, data, data_len,
+				     clear_after);
+		if (!ret)
+			clipboard_pid = 0;
+	}
+	free(meta);
+	secure_clear(data, data_len);
+	free(data);
+	return ret;
+}
+
+static void agent_handle_request(int fd)
+{
+	struct pollfd pfd = { .fd = fd, .events = POLLIN };
+	struct agent_request request;
+	char *meta, *data;
+	char status = 0;
+
+	/* most clients only want the key, and hang up */
+	if (poll(&pfd, 1, AGENT_REQUEST_TIMEOUT_MS) <= 0 ||
+	    !read_all(fd, &request, sizeof(request)))
+		return;
+
+	if (memcmp(request.magic, "CLIP", 4) ||
+	    request.meta_len > CLIPBOARD_META_MAX ||
+	    request.data_len > CLIPBOARD_DATA_MAX)
+		goto out;
+
+	meta = xmalloc(request.meta_len + 1);
+	data = xmalloc(request.data_len + 1);
+	if (read_all(fd, meta, request.meta_len) &&
+	    read_all(fd, data, request.data_len)) {
+		status = agent_clipboard(meta, request.meta_len, data, request.data_len,
+					 request.clear_after);
+	} else {
+		free(meta);
+		secure_clear(data, request.data_len);
+		free(data);
+	}
+out:
+	send_all(fd, &status, 1);
+}
+
+/*
+ * Refresh the session saved on disk, so that the next command finds a
+ * current token instead of failing and sending the user back to login.
+ */
+static void agent_keepalive(void)
+{
+	struct agent_profile *profile;
+	struct session *session;
+	sigset_t mask, old_mask;
+	pid_t child;
+	int ret = 0;
+
+	keepalive_deadline = time(NULL) + keepalive_interval;
+	if (keepalive_pid)
+		return;
+
+	/* the child must not be reaped before its pid is recorded */
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGCHLD);
+	sigprocmask(SIG_BLOCK, &mask, &old_mask);
+
+	child = fork();
+	if (child == 0) {
+		/* only the agent itself removes the socket on the way out */
+		signal(SIGHUP, SIG_DFL);
+		signal(SIGINT, SIG_DFL);
+		signal(SIGQUIT, SIG_DFL);
+		signal(SIGTERM, SIG_DFL);
+		sigprocmask(SIG_SETMASK, &old_mask, NULL);
+		list_for_each_entry(profile, &profiles, list) {
+			if (*profile->name)
+				setenv("LPASS_PROFILE", profile->name, 1);
+			else
+				unsetenv("LPASS_PROFILE");
+			session = session_load(profile->key);
+			if (!session)
+				continue;
+			ret |= lastpass_check_session(session, profile->key);
+			session_free(session);
+		}
+		_exit(ret ? EXIT_FAILURE : EXIT_SUCCESS);
+	}
+	if (child > 0)
+		keepalive_pid = child;
+
+	sigprocmask(SIG_SETMASK, &old_mask, NULL);
+}
+
+static struct agent_profile *agent_find_profile(const char *name)
+{
+	struct agent_profile *profile;
+
+	list_for_each_entry(profile, &profiles, list) {
+		if (!strcmp(profile->name, name))
+			return profile;
+	}
+	return NULL;
+}
+
+static void agent_add_profile(char *name, unsigned const char key[KDF_HASH_LEN],
+			      unsigned int timeout)
+{
+	struct agent_profile *profile = agent_find_profile(name);
+
+	if (profile) {
+		free(name);
+	} else {
+		profile = new0(struct agent_profile, 1);
+		profile->name = name;
+		mlock(profile->key, KDF_HASH_LEN);
+		list_add_tail(&profile->list, &profiles);
+	}
+	memcpy(profile->key, key, KDF_HASH_LEN);
+	profile->expires = timeout ? time(NULL) + timeout : 0;
+}
+
+/*
+ * A keepalive still running could save the session of a profile after
+ * logout has removed it, so it is stopped before the profile goes.
+ */
+static void agent_stop_keepalive(void)
 {
-	char *agent_timeout_str;
-	unsigned int agent_timeout;
+	sigset_t mask, old_mask;
+
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGCHLD);
+	sigprocmask(SIG_BLOCK, &mask, &old_mask);
+	if (keepalive_pid) {
+		kill(keepalive_pid, SIGTERM);
+		waitpid(keepalive_pid, NULL, 0);
+		keepalive_pid = 0;
+	}
+	sigprocmask(SIG_SETMASK, &old_mask, NULL);
+}
+
+static void agent_drop_profile(struct agent_profile *profile)
+{
+	agent_stop_keepalive();
+	list_del(&profile->list);
+	secure_clear(profile->key, KDF_HASH_LEN);
+	free(profile->name);
+	free(profile);
+}
+
+static void agent_expire_profiles(void)
+{
+	struct agent_profile *profile, *tmp;
+	time_t now = time(NULL);
+
+	list_for_each_entry_safe(profile, tmp, &profiles, list) {
+		if (profile->expires && now >= profile->expires)
+			agent_drop_profile(profile);
+	}
+}
+
+/* milliseconds until the next keepalive or expiry, or -1 */
+static int agent_poll_timeout(void)
+{
+	struct agent_profile *profile;
+	time_t now = time(NULL);
+	time_t deadline = 0;
+
+	if (keepalive_interval)
+		deadline = keepalive_deadline;
+	list_for_each_entry(profile, &profiles, list) {
+		if (profile->expires && (!deadline || profile->expires < deadline))
+			deadline = profile->expires;
+	}
+	if (!deadline)
+		return -1;
+	return deadline > now ? (deadline - now) * 1000 : 0;
+}
+
+static void agent_handle_client(int fd)
+{
+	struct pollfd pfd = { .fd = fd, .events = POLLIN };
+	struct agent_profile *profile;
+	struct agent_hello hello;
+	unsigned char key[KDF_HASH_LEN];
+	char *name;
+	char status = 0;
+
+	if (poll(&pfd, 1, AGENT_REQUEST_TIMEOUT_MS) <= 0 ||
+	    !read_all(fd, &hello, sizeof(hello)) ||
+	    memcmp(hello.magic, "PROF", 4) ||
+	    hello.name_len > AGENT_PROFILE_NAME_MAX)
+		return;
+
+	name = xcalloc(hello.name_len + 1, 1);
+	if (!read_all(fd, name, hello.name_len)) {
+		free(name);
+		return;
+	}
+	profile = agent_find_profile(name);
+
+	switch (hello.op) {
+	case AGENT_GET:
+		free(name);
+		status = profile != NULL;
+		if (send_all(fd, &status, 1) && profile &&
+		    send_all(fd, profile->key, KDF_HASH_LEN))
+			agent_handle_request(fd);
+		return;
+	case AGENT_ADD:
+		if (read_all(fd, key, KDF_HASH_LEN)) {
+			agent_add_profile(name, key, hello.timeout);
+			status = 1;
+		} else {
+			free(name);
+		}
+		secure_clear(key, KDF_HASH_LEN);
+		break;
+	case AGENT_DROP:
+		free(name);
+		if (profile)
+			agent_drop_profile(profile);
+		status = 1;
+		break;
+	default:
+		free(name);
+	}
+	send_all(fd, &status, 1);
+}
+
+static void agent_run(char *name, unsigned const char key[KDF_HASH_LEN],
+		      unsigned int key_timeout)
+{
+	char *keepalive_str;
 	struct sockaddr_un sa, listensa;
 	struct ucred cred;
-	int fd, listenfd;
+	struct sigaction reap;
+	struct pollfd pfd;
+	struct timeval io_timeout = { .tv_sec = AGENT_IO_TIMEOUT_SEC };
+	int fd, listenfd, timeout;
 	socklen_t len;
 
 	signal(SIGHUP, agent_cleanup);
@@ -170,19 +573,30 @@ static void agent_run(unsigned const char key[KDF_HASH_LEN])
 	signal(SIGQUIT, agent_cleanup);
 	signal(SIGTERM, agent_cleanup);
 	signal(SIGALRM, agent_cleanup);
+	signal(SIGPIPE, SIG_IGN);
 
-	agent_timeout_str = getenv("LPASS_AGENT_TIMEOUT");
-	agent_timeout = 60 * 60; /* One hour by default. */
-	if (agent_timeout_str && strlen(agent_timeout_str))
-		agent_timeout = strtoul(agent_timeout_str, NULL, 10);
-	if (agent_timeout)
-		alarm(agent_timeout);
+	/* children are reaped as they exit, not waited for */
+	memset(&reap, 0, sizeof(reap));
+	reap.sa_handler = agent_reap_children;
+	reap.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+	sigaction(SIGCHLD, &reap, NULL);
+
+	agent_add_profile(name, key, key_timeout);
+
+	keepalive_str = getenv("LPASS_AGENT_KEEPALIVE");
+	keepalive_interval = AGENT_KEEPALIVE_DEFAULT;
+	if (keepalive_str && strlen(keepalive_str))
+		keepalive_interval = strtoul(keepalive_str, NULL, 10);
+	keepalive_deadline = time(NULL) + keepalive_interval;
 
 	_cleanup_free_ char *path = agent_socket_path();
 	fd = _setup_agent_socket(&sa, path);
 
 	unlink(path);
 
+	/* keep the sockets from the clipboard commands we start */
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+
 	if (bind(fd, (struct sockaddr *)&sa, SUN_LEN(&sa)) < 0 || listen(fd, 16) < 0) {
 		listenfd = errno;
 		close(fd);
@@ -191,7 +605,28 @@ static void agent_run(unsigned const char key[KDF_HASH_LEN])
 		die_errno("bind|listen");
 	}
 
-	for (len = sizeof(listensa); (listenfd = accept(fd, (struct sockaddr *)&listensa, &len)) > 0; len = sizeof(listensa)) {
+	pfd.fd = fd;
+	pfd.events = POLLIN;
+	for (;;) {
+		timeout = agent_poll_timeout();
+		listenfd = poll(&pfd, 1, timeout);
+		if (listenfd < 0 && errno == EINTR)
+			continue;
+		if (keepalive_interval && time(NULL) >= keepalive_deadline)
+			agent_keepalive();
+		agent_expire_profiles();
+		if (list_empty(&profiles))
+			agent_cleanup(0);
+		if (listenfd == 0)
+			continue;
+
+		len = sizeof(listensa);
+		listenfd = accept(fd, (struct sockaddr *)&listensa, &len);
+		if (listenfd < 0)
+			break;
+		fcntl(listenfd, F_SETFD, FD_CLOEXEC);
+		setsockopt(listenfd, SOL_SOCKET, SO_RCVTIMEO, &io_timeout, sizeof(io_timeout));
+		setsockopt(listenfd, SOL_SOCKET, SO_SNDTIMEO, &io_timeout, sizeof(io_timeout));
 		if (agent_socket_get_cred(listenfd, &cred) < 0) {
 			close(listenfd);
 			continue;
@@ -205,8 +640,10 @@ static void agent_run(unsigned const char key[KDF_HASH_LEN])
 		pid_t pid = getpid();
 		IGNORE_RESULT(write(listenfd, &pid, sizeof(pid)));
 #endif
-		IGNORE_RESULT(write(listenfd, key, KDF_HASH_LEN));
+		agent_handle_client(listenfd);
 		close(listenfd);
+		if (list_empty(&profiles))
+			agent_cleanup(0);
 	}
 
 	listenfd = errno;
@@ -216,7 +653,46 @@ static void agent_run(unsigned const char key[KDF_HASH_LEN])
 	die_errno("accept");
 }
 
-void agent_kill(void)
+/*
+ * Connect to the agent and name our profile.  Returns the socket, or -1
+ * if no agent is running.
+ */
+static int agent_connect(enum agent_op op, unsigned int timeout)
+{
+	struct sockaddr_un sa;
+	const char *profile = config_profile();
+	struct agent_hello hello = {
+		.magic = "PROF",
+		.op = op,
+		.name_len = strlen(profile),
+		.timeout = timeout,
+	};
+	int fd;
+
+	_cleanup_free_ char *path = agent_socket_path();
+	fd = _setup_agent_socket(&sa, path);
+
+	if (connect(fd, (struct sockaddr *)&sa, SUN_LEN(&sa)) < 0)
+		goto fail;
+
+#if SOCKET_SEND_PID == 1
+	pid_t pid = getpid();
+	if (write(fd, &pid, sizeof(pid)) != sizeof(pid) ||
+	    read(fd, &pid, sizeof(pid)) != sizeof(pid))
+		goto fail;
+#endif
+	if (!send_all(fd, &hello, sizeof(hello)) ||
+	    !send_all(fd, profile, hello.name_len))
+		goto fail;
+	return fd;
+
+fail:
+	close(fd);
+	return -1;
+}
+
+/* stop an agent we cannot talk to, such as one left by an older lpass */
+static void agent_terminate(void)
 {
 	struct sockaddr_un sa;
 	struct ucred cred;
@@ -243,51 +719,114 @@ out:
 	close(fd);
 }
 
+/*
+ * Have the agent forget the key of the current profile.  It exits once
+ * it holds no keys.
+ */
+void agent_kill(void)
+{
+	char status;
+	int fd;
+
+	fd = agent_connect(AGENT_DROP, 0);
+	if (fd < 0)
+		return;
+	IGNORE_RESULT(read_all(fd, &status, 1));
+	close(fd);
+}
+
 bool agent_ask(unsigned char key[KDF_HASH_LEN])
 {
-	struct sockaddr_un sa;
+	char status = 0;
+	bool ret;
+	int fd;
+
+	fd = agent_connect(AGENT_GET, 0);
+	if (fd < 0)
+		return false;
+
+	ret = read_all(fd, &status, 1) && status &&
+	      read_all(fd, key, KDF_HASH_LEN);
+	close(fd);
+	return ret;
+}
+
+/*
+ * Have the agent, if one is running, copy data to the clipboard with
+ * command, and clear it again after clear_after seconds unless that is
+ * 0.  Returns false if there is no agent to do it.
+ */
+bool agent_clipboard_copy(char **command, const char *data, size_t len,
+			  unsigned int clear_after)
+{
+	struct agent_request request = { .magic = "CLIP" };
+	unsigned char key[KDF_HASH_LEN];
+	_cleanup_free_ char *meta = NULL;
+	size_t meta_len;
+	char status = 0;
+	sig_t previous_handler;
 	int fd;
 	bool ret = false;
 
-	_cleanup_free_ char *path = agent_socket_path();
-	fd = _setup_agent_socket(&sa, path);
+	meta = clipboard_meta(command, &meta_len);
+	request.meta_len = meta_len;
+	request.data_len = len;
+	request.clear_after = clear_after;
 
-	ret = connect(fd, (struct sockaddr *)&sa, SUN_LEN(&sa)) >= 0;
-	if (!ret)
-		goto out;
+	fd = agent_connect(AGENT_GET, 0);
+	if (fd < 0)
+		return false;
 
-#if SOCKET_SEND_PID == 1
-	pid_t pid = getpid();
-	ret = write(fd, &pid, sizeof(pid)) == sizeof(pid);
-	if (!ret)
-		goto out;
-	ret = read(fd, &pid, sizeof(pid)) == sizeof(pid);
-	if (!ret)
-		goto out;
-#endif
-	ret = read(fd, key, KDF_HASH_LEN) == KDF_HASH_LEN;
-	if (!ret)
+	/* the key comes first, whether or not we need it */
+	if (!read_all(fd, &status, 1) || !status ||
+	    !read_all(fd, key, KDF_HASH_LEN))
 		goto out;
-
+	secure_clear(key, KDF_HASH_LEN);
+	status = 0;
+
+	/* an older agent hangs up instead of answering */
+	previous_handler = signal(SIGPIPE, SIG_IGN);
+	ret = send_all(fd, &request, sizeof(request)) &&
+	      send_all(fd, meta, meta_len) &&
+	      send_all(fd, data, len) &&
+	      read_all(fd, &status, 1) && status;
+	signal(SIGPIPE, previous_handler);
 out:
 	close(fd);
 	return ret;
 }
 
+/*
+ * Give the key to the agent, starting one if there is none to take it.
+ */
 static void agent_start(unsigned const char key[KDF_HASH_LEN])
 {
+	unsigned int timeout = agent_timeout();
+	char status = 0;
 	pid_t child;
+	int fd;
 
-	agent_kill();
-
-	if (config_exists("plaintext_key"))
+	if (config_exists("plaintext_key")) {
+		agent_kill();
 		return;
+	}
 
 	char *disable_str = getenv("LPASS_AGENT_DISABLE");
 	if (disable_str && !strcmp(disable_str, "1")) {
+		agent_kill();
 		return;
 	}
 
+	fd = agent_connect(AGENT_ADD, timeout);
+	if (fd >= 0) {
+		if (!send_all(fd, key, KDF_HASH_LEN) || !read_all(fd, &status, 1))
+			status = 0;
+		close(fd);
+		if (status)
+			return;
+	}
+	agent_terminate();
+
 	child = fork();
 	if (child < 0)
 		die_errno("fork(agent)");
@@ -301,12 +840,19 @@ static void agent_start(unsigned const char key[KDF_HASH_LEN])
 		dup2(null, 2);
 		close(null);
 		setsid();
+
+		/* a relative LPASS_HOME must keep naming the same place */
+		char *home = getenv("LPASS_HOME");
+		_cleanup_free_ char *abs_home = home && *home != '/' ? realpath(home, NULL) : NULL;
+		if (abs_home)
+			setenv("LPASS_HOME", abs_home, 1);
+
 		if (chdir("/") < 0)
 			_exit(EXIT_FAILURE);
 		process_disable_ptrace();
 		process_set_name("lpass [agent]");
 
-		agent_run(key);
+		agent_run(xstrdup(config_profile()), key, timeout);
 		_exit(EXIT_FAILURE);
 	}
 }
@@ -316,8 +862,7 @@ bool agent_get_decryption_key(unsigned char key[KDF_HASH_LEN])
 	if (config_exists("plaintext_key")) {
 		_cleanup_free_ unsigned char *key_buffer = NULL;
 		if (config_read_buffer("plaintext_key", &key_buffer) == KDF_HASH_LEN) {
-			_cleanup_free_ char *verify = config_read_encrypted_string("verify", (unsigned char *)key_buffer);
-			if (!verify || strcmp(verify, AGENT_VERIFICATION_STRING))
+			if (!agent_verify_key(key_buffer))
 				goto badkey;
 			memcpy(key, key_buffer, KDF_HASH_LEN);
 			secure_clear(key_buffer, KDF_HASH_LEN);
@@ -3,11 +3,14 @@
 
 #include "kdf.h"
 #include <stdbool.h>
+#include <stddef.h>
 
 bool agent_get_decryption_key(unsigned char key[KDF_HASH_LEN]);
 void agent_save(const char *username, int iterations, unsigned const char key[KDF_HASH_LEN]);
 void agent_kill(void);
 bool agent_ask(unsigned char key[KDF_HASH_LEN]);
 bool agent_load_key(unsigned char key[KDF_HASH_LEN]);
+bool agent_verify_key(unsigned const char key[KDF_HASH_LEN]);
+bool agent_clipboard_copy(char **command, const char *data, size_t len, unsigned int clear_after);
 
 #endif
@@ -46,6 +46,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <unistd.h>
+#include <pthread.h>
 #include <sys/mman.h>
 #if defined(__APPLE__) && defined(__MACH__)
 #include <libkern/OSByteOrder.h>
@@ -134,7 +135,6 @@ bool account_is_group(struct account *account)
 	return !strcmp(account->url, "http://group");
 }
 
-static
 bool account_is_secure_note(const struct account *account)
 {
 	return !strcmp(account->url, "http://sn");
@@ -352,13 +352,28 @@ static bool check_next_entry_encrypted(struct chunk *chunk) {
 	base->var = __entry_val__; \
 	} while (0)
 #define entry_crypt(var) entry_crypt_at(parsed, var)
+/*
+ * Like entry_crypt, but with lazy secrets only the ciphertext is kept
+ * and the plaintext is left NULL until account_decrypt_secrets().
+ */
+#define entry_secret(var) do { \
+	if (lazy_secrets) { \
+		struct item __entry_item__; \
+		if (!read_item(chunk, &__entry_item__)) \
+			goto error; \
+		parsed->var##_encrypted = cipher_base64(__entry_item__.data, __entry_item__.len); \
+		if (!__entry_item__.len) \
+			parsed->var = xstrdup(""); \
+	} else \
+		entry_crypt(var); \
+	} while (0)
 #define skip(placeholder) do { \
 	struct item skip_item; \
 	if (!read_item(chunk, &skip_item)) \
 		goto error; \
 	} while (0)
 
-static struct account *account_parse(struct chunk *chunk, const unsigned char key[KDF_HASH_LEN])
+static struct account *account_parse(struct chunk *chunk, const unsigned char key[KDF_HASH_LEN], bool lazy_secrets)
 {
 	struct account *parsed = new_account();
 
@@ -369,11 +384,11 @@ static struct account *account_parse(struct chunk *chunk, const unsigned char ke
 		entry_crypt(url);
 	else
 		entry_hex(url);
-	entry_crypt(note);
+	entry_secret(note);
 	entry_boolean(fav);
 	skip(sharedfromaid);
 	entry_crypt(username);
-	entry_crypt(password);
+	entry_secret(password);
 	entry_boolean(pwprotect);
 	skip(genpw);
 	skip(sn);
@@ -428,14 +443,14 @@ error:
 	return NULL;
 }
 
-static struct field *field_parse(struct chunk *chunk, const unsigned char key[KDF_HASH_LEN])
+static struct field *field_parse(struct chunk *chunk, const unsigned char key[KDF_HASH_LEN], bool lazy_secrets)
 {
 	struct field *parsed = new0(struct field, 1);
 
 	entry_plain(name);
 	entry_plain(type);
 	if (!strcmp(parsed->type, "email") || !strcmp(parsed->type, "tel") || !strcmp(parsed->type, "text") || !strcmp(parsed->type, "password") || !strcmp(parsed->type, "textarea"))
-		entry_crypt(value);
+		entry_secret(value);
 	else
 		entry_plain(value);
 	entry_boolean(checked);
@@ -590,7 +605,7 @@ error:
 #undef entry_crypt_at
 #undef skip
 
-struct blob *blob_parse(const unsigned char *blob, size_t len, const unsigned char key[KDF_HASH_LEN], const struct private_key *private_key)
+struct blob *blob_parse(const unsigned char *blob, size_t len, const unsigned char key[KDF_HASH_LEN], const struct private_key *private_key, bool lazy_secrets)
 {
 	struct blob_pos blob_pos = { .data = blob, .len = len };
 	struct chunk chunk;
@@ -612,7 +627,7 @@ struct blob *blob_parse(const unsigned char *blob, size_t len, const unsigned ch
 			versionstr = xstrndup((char *) chunk.data, chunk.len);
 			parsed->version = strtoull(versionstr, NULL, 10);
 		} else if (!strcmp(chunk.name, "ACCT")) {
-			account = account_parse(&chunk, last_share ? last_share->key : key);
+			account = account_parse(&chunk, last_share ? last_share->key : key, lazy_secrets);
 			if (!account)
 				goto error;
 
@@ -630,7 +645,7 @@ struct blob *blob_parse(const unsigned char *blob, size_t len, const unsigned ch
 			if (!account)
 				goto error;
 
-			field = field_parse(&chunk, last_share ? last_share->key : key);
+			field = field_parse(&chunk, last_share ? last_share->key : key, lazy_secrets);
 			if (!field)
 				goto error;
 
@@ -763,6 +778,11 @@ static void write_chunk(struct buffer *dstbuffer, struct buffer *srcbuffer, char
 	write_item(dstbuffer, srcbuffer->bytes, srcbuffer->len);
 }
 
+static bool field_is_encrypted(const struct field *field)
+{
+	return !strcmp(field->type, "email") || !strcmp(field->type, "tel") || !strcmp(field->type, "text") || !strcmp(field->type, "password") || !strcmp(field->type, "textarea");
+}
+
 static void write_app_chunk(struct buffer *buffer, struct account *account)
 {
 	struct buffer accbuf, fieldbuf;
@@ -790,7 +810,7 @@ static void write_app_chunk(struct buffer *buffer, struct account *account)
 	list_for_each_entry(field, &account->field_head, list) {
 		memset(&fieldbuf, 0, sizeof(fieldbuf));
 		write_plain_string(&fieldbuf, field->name);
-		if (!strcmp(field->type, "email") || !strcmp(field->type, "tel") || !strcmp(field->type, "text") || !strcmp(field->type, "password") || !strcmp(field->type, "textarea"))
+		if (field_is_encrypted(field))
 			write_crypt_string(&fieldbuf, field->value_encrypted);
 		else
 			write_plain_string(&fieldbuf, field->value);
@@ -844,8 +864,8 @@ static void write_account_chunk(struct buffer *buffer, struct account *account,
 	write_plain_string(&accbuf, "skipped");
 	write_plain_string(&accbuf, "skipped");
 	write_plain_string(&accbuf, "skipped");
-	write_plain_string(&accbuf, "skipped");
-	write_plain_string(&accbuf, "skipped");
+	write_plain_string(&accbuf, account->attachkey_encrypted ? account->attachkey_encrypted : "");
+	write_boolean(&accbuf, account->attachpresent);
 	write_plain_string(&accbuf, "skipped");
 	write_plain_string(&accbuf, "skipped");
 	write_plain_string(&accbuf, "skipped");
@@ -860,7 +880,7 @@ static void write_account_chunk(struct buffer *buffer, struct account *account,
 		memset(&fieldbuf, 0, sizeof(fieldbuf));
 		write_plain_string(&fieldbuf, field->name);
 		write_plain_string(&fieldbuf, field->type);
-		if (!strcmp(field->type, "email") || !strcmp(field->type, "tel") || !strcmp(field->type, "text") || !strcmp(field->type, "password") || !strcmp(field->type, "textarea"))
+		if (field_is_encrypted(field))
 			write_crypt_string(&fieldbuf, field->value_encrypted);
 		else
 			write_plain_string(&fieldbuf, field->value);
@@ -908,25 +928,56 @@ size_t blob_write(const struct blob *blob, const unsigned char key[KDF_HASH_LEN]
 	return buffer.len;
 }
 
-static struct blob *local_blob(const unsigned char key[KDF_HASH_LEN], const struct private_key *private_key)
+static struct blob *local_blob(const unsigned char key[KDF_HASH_LEN], const struct private_key *private_key, bool lazy_secrets)
 {
 	_cleanup_free_ unsigned char *blob = NULL;
 	size_t len = config_read_encrypted_buffer("blob", &blob, key);
 	if (!blob)
 		return NULL;
-	return blob_parse(blob, len, key, private_key);
+	return blob_parse(blob, len, key, private_key, lazy_secrets);
+}
+
+struct version_check {
+	struct session *session;
+	const unsigned char *key;
+	unsigned long long version;
+};
+
+static void *version_check_worker(void *arg)
+{
+	struct version_check *check = arg;
+
+	check->version = lastpass_get_blob_version_noexit(check->session, check->key);
+	return NULL;
 }
 
-static struct blob *blob_get_latest(struct session *session, const unsigned char key[KDF_HASH_LEN])
+/*
+ * The server is asked for its blob version while the local blob is read
+ * and parsed, which only uses the session's private key; the check
+ * itself updates the session's token.  If the check fails on its
+ * thread, it is made again from this one, which reports the error.
+ */
+static struct blob *blob_get_latest(struct session *session, const unsigned char key[KDF_HASH_LEN], bool lazy_secrets)
 {
+	struct version_check check = { .session = session, .key = key };
 	struct blob *local;
 	unsigned long long remote_version;
+	pthread_t thread;
+	bool checking;
+
+	if (!config_exists("blob"))
+		return lastpass_get_blob(session, key, lazy_secrets);
 
-	local = local_blob(key, &session->private_key);
+	checking = !pthread_create(&thread, NULL, version_check_worker, &check);
+	local = local_blob(key, &session->private_key, lazy_secrets);
+	if (checking)
+		pthread_join(thread, NULL);
 	if (!local)
-		return lastpass_get_blob(session, key);
+		return lastpass_get_blob(session, key, lazy_secrets);
 
-	remote_version = lastpass_get_blob_version(session, key);
+	remote_version = checking ? check.version : 0;
+	if (!remote_version)
+		remote_version = lastpass_get_blob_version(session, key);
 
 	if (remote_version == 0) {
 		blob_free(local);
@@ -935,7 +986,7 @@ static struct blob *blob_get_latest(struct session *session, const unsigned char
 
 	if (remote_version > local->version) {
 		blob_free(local);
-		return lastpass_get_blob(session, key);
+		return lastpass_get_blob(session, key, lazy_secrets);
 	}
 
 	config_touch("blob");
@@ -955,68 +1006,140 @@ static time_t auto_sync_time(void)
 	return time;
 }
 
-struct blob *blob_load(enum blobsync sync, struct session *session, const unsigned char key[KDF_HASH_LEN])
+struct blob *blob_load(enum blobsync sync, struct session *session, const unsigned char key[KDF_HASH_LEN], bool lazy_secrets)
 {
 	if (sync == BLOB_SYNC_YES)
-		return blob_get_latest(session, key);
+		return blob_get_latest(session, key, lazy_secrets);
 
 	if (sync == BLOB_SYNC_NO)
-		return local_blob(key, &session->private_key);
+		return local_blob(key, &session->private_key, lazy_secrets);
 
 	if (config_exists("blob") &&
 			time(NULL) - config_mtime("blob") < auto_sync_time()) {
-		return local_blob(key, &session->private_key);
+		return local_blob(key, &session->private_key, lazy_secrets);
 	}
 
-	return blob_get_latest(session, key);
-}
-
-void blob_save(const struct blob *blob, const unsigned char key[KDF_HASH_LEN], const struct feature_flag *feature_flag)
-{
-	_cleanup_free_ char *bluffer = NULL;
-	size_t len;
-
-	len = blob_write(blob, key, &bluffer, feature_flag);
-	if (!len)
-		die("Could not write blob.");
-
-	config_write_encrypted_buffer("blob", bluffer, len, key);
+	return blob_get_latest(session, key, lazy_secrets);
 }
 
 #define set_field(obj, field) do { \
+	if (!obj->field || !field || strcmp(obj->field, field)) \
+		account->dirty = true; \
 	free(obj->field); \
 	obj->field = field; \
 } while (0)
+/*
+ * Encrypted fields only drop their stale ciphertext here; the new one
+ * is made once, by account_encrypt(), when the account is committed.
+ */
 #define set_encrypted_field(obj, field) do { \
 	if (!obj->field || !field || strcmp(obj->field, field)) { \
 		set_field(obj, field); \
 		free(obj->field##_encrypted); \
-		obj->field##_encrypted = encrypt_and_base64(field, account->share ? account->share->key : key); \
+		obj->field##_encrypted = NULL; \
 	} \
 } while (0)
+#define encrypt_field(obj, field) do { \
+	if (obj->field && !obj->field##_encrypted) \
+		obj->field##_encrypted = encrypt_and_base64(obj->field, account->share ? account->share->key : key); \
+} while (0)
 #define reencrypt_field(obj, field) do { \
 	free(obj->field##_encrypted); \
 	obj->field##_encrypted = encrypt_and_base64(obj->field, account->share ? account->share->key : key); \
 } while (0)
 
+/*
+ * Encrypt the fields changed since the account was loaded, with the
+ * key of the share it is in now.  Anything that sends or stores the
+ * ciphertexts calls this first.
+ */
+void account_encrypt(struct account *account, const unsigned char key[KDF_HASH_LEN], const struct feature_flag *feature_flag)
+{
+	struct field *field;
+
+	encrypt_field(account, name);
+	encrypt_field(account, group);
+	if (feature_flag && feature_flag->url_encryption_enabled)
+		encrypt_field(account, url);
+	encrypt_field(account, username);
+	encrypt_field(account, password);
+	encrypt_field(account, note);
+
+	list_for_each_entry(field, &account->field_head, list) {
+		if (field_is_encrypted(field))
+			encrypt_field(field, value);
+	}
+}
+
+static void decrypt_secret(char **plaintext, const char *ciphertext, const unsigned char key[KDF_HASH_LEN])
+{
+	if (*plaintext)
+		return;
+	if (ciphertext && *ciphertext)
+		*plaintext = cipher_aes_decrypt_base64(ciphertext, key);
+	if (!*plaintext)
+		*plaintext = xstrdup("");
+}
+
+/*
+ * Decrypt the password, note and field values that a blob parsed with
+ * lazy secrets left encrypted.  Does nothing for an account that is
+ * already fully decrypted.
+ */
+void account_decrypt_secrets(struct account *account, const unsigned char key[KDF_HASH_LEN])
+{
+	const unsigned char *account_key = account->share ? account->share->key : key;
+	struct field *field;
+
+	decrypt_secret(&account->password, account->password_encrypted, account_key);
+	decrypt_secret(&account->note, account->note_encrypted, account_key);
+	list_for_each_entry(field, &account->field_head, list)
+		decrypt_secret(&field->value, field->value_encrypted, account_key);
+}
+
+void blob_save(struct blob *blob, const unsigned char key[KDF_HASH_LEN], const struct feature_flag *feature_flag)
+{
+	_cleanup_free_ char *bluffer = NULL;
+	struct account *account;
+	size_t len;
+
+	list_for_each_entry(account, &blob->account_head, list) {
+		if (!account->dirty)
+			continue;
+		account_encrypt(account, key, feature_flag);
+		account->dirty = false;
+	}
+
+	len = blob_write(blob, key, &bluffer, feature_flag);
+	if (!len)
+		die("Could not write blob.");
+
+	config_write_encrypted_buffer("blob", bluffer, len, key);
+}
+
 void account_set_username(struct account *account, char *username, unsigned const char key[KDF_HASH_LEN])
 {
+	UNUSED(key);
 	set_encrypted_field(account, username);
 }
 void account_set_password(struct account *account, char *password, unsigned const char key[KDF_HASH_LEN])
 {
+	UNUSED(key);
 	set_encrypted_field(account, password);
 }
 void account_set_group(struct account *account, char *group, unsigned const char key[KDF_HASH_LEN])
 {
+	UNUSED(key);
 	set_encrypted_field(account, group);
 }
 void account_set_name(struct account *account, char *name, unsigned const char key[KDF_HASH_LEN])
 {
+	UNUSED(key);
 	set_encrypted_field(account, name);
 }
 void account_set_note(struct account *account, char *note, unsigned const char key[KDF_HASH_LEN])
 {
+	UNUSED(key);
 	set_encrypted_field(account, note);
 }
 void account_set_url(struct account *account, char *url, unsigned const char key[KDF_HASH_LEN], const struct feature_flag *feature_flag)
@@ -1031,12 +1154,11 @@ void account_set_url(struct account *account, char *url, unsigned const char key
 		}
 	}
 
-	if (feature_flag && feature_flag->url_encryption_enabled) {
+	UNUSED(key);
+	if (feature_flag && feature_flag->url_encryption_enabled)
 		set_encrypted_field(account, url);
-	} else {
-		UNUSED(key);
+	else
 		set_field(account, url);
-	}
 }
 void account_set_appname(struct account *account, char *appname, unsigned const char key[KDF_HASH_LEN])
 {
@@ -1050,7 +1172,8 @@ void account_set_appname(struct account *account, char *appname, unsigned const
 }
 void field_set_value(struct account *account, struct field *field, char *value, unsigned const char key[KDF_HASH_LEN])
 {
-	if (!strcmp(field->type, "email") || !strcmp(field->type, "tel") || !strcmp(field->type, "text") || !strcmp(field->type, "password") || !strcmp(field->type, "textarea"))
+	UNUSED(key);
+	if (field_is_encrypted(field))
 		set_encrypted_field(field, value);
 	else
 		set_field(field, value);
@@ -1077,6 +1200,7 @@ void account_reencrypt(struct account *account, const unsigned char key[KDF_HASH
 	list_for_each_entry(field, &account->field_head, list) {
 		reencrypt_field(field, value);
 	}
+	account->dirty = true;
 }
 
 /*
@@ -68,6 +68,7 @@ struct account {
 	bool pwprotect;
 	bool fav;
 	bool is_app;
+	bool dirty;		/* changed since loaded; some ciphertexts may be stale */
 	char *attachkey, *attachkey_encrypted;
 	bool attachpresent;
 	size_t attach_len;
@@ -151,11 +152,16 @@ struct pwchange_su_key {
 
 enum blobsync { BLOB_SYNC_AUTO, BLOB_SYNC_YES, BLOB_SYNC_NO };
 
-struct blob *blob_parse(const unsigned char *blob, size_t len, const unsigned char key[KDF_HASH_LEN], const struct private_key *private_key);
+/*
+ * With lazy_secrets, account passwords, notes and field values are left
+ * NULL and encrypted until account_decrypt_secrets() is called; only for
+ * read-only callers.
+ */
+struct blob *blob_parse(const unsigned char *blob, size_t len, const unsigned char key[KDF_HASH_LEN], const struct private_key *private_key, bool lazy_secrets);
 void blob_free(struct blob *blob);
 size_t blob_write(const struct blob *blob, const unsigned char key[KDF_HASH_LEN], char **out, const struct feature_flag *feature_flag);
-struct blob *blob_load(enum blobsync sync, struct session *session, const unsigned char key[KDF_HASH_LEN]);
-void blob_save(const struct blob *blob, const unsigned char key[KDF_HASH_LEN], const struct feature_flag *feature_flag);
+struct blob *blob_load(enum blobsync sync, struct session *session, const unsigned char key[KDF_HASH_LEN], bool lazy_secrets);
+void blob_save(struct blob *blob, const unsigned char key[KDF_HASH_LEN], const struct feature_flag *feature_flag);
 void field_free(struct field *field);
 struct app *account_to_app(const struct account *account);
 struct app *new_app();
@@ -170,8 +176,11 @@ void account_set_url(struct account *account, char *url, unsigned const char key
 void account_set_note(struct account *account, char *note, unsigned const char key[KDF_HASH_LEN]);
 void account_set_appname(struct account *account, char *appname, unsigned const char key[KDF_HASH_LEN]);
 void account_assign_share(struct blob *blob, struct account *account, unsigned const char key[KDF_HASH_LEN], const struct feature_flag *feature_flag);
+void account_encrypt(struct account *account, const unsigned char key[KDF_HASH_LEN], const struct feature_flag *feature_flag);
+void account_decrypt_secrets(struct account *account, const unsigned char key[KDF_HASH_LEN]);
 void account_reencrypt(struct account *account, const unsigned char key[KDF_HASH_LEN], const struct feature_flag *feature_flag);
 bool account_is_group(struct account *account);
+bool account_is_secure_note(const struct account *account);
 void field_set_value(struct account *account, struct field *field, char *value, unsigned const char key[KDF_HASH_LEN]);
 struct account *notes_expand(struct account *acc);
 struct account *notes_collapse(struct account *acc);
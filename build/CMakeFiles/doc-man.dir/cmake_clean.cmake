@@ -0,0 +1,9 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/doc-man"
+  "lpass.1"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/doc-man.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,51 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/agent.c" "CMakeFiles/liblpass-shared.dir/agent.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/agent.c.o.d"
+  "/root/repo/blob.c" "CMakeFiles/liblpass-shared.dir/blob.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/blob.c.o.d"
+  "/root/repo/cipher.c" "CMakeFiles/liblpass-shared.dir/cipher.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/cipher.c.o.d"
+  "/root/repo/clipboard.c" "CMakeFiles/liblpass-shared.dir/clipboard.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/clipboard.c.o.d"
+  "/root/repo/config.c" "CMakeFiles/liblpass-shared.dir/config.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/config.c.o.d"
+  "/root/repo/edit.c" "CMakeFiles/liblpass-shared.dir/edit.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/edit.c.o.d"
+  "/root/repo/endpoints-login.c" "CMakeFiles/liblpass-shared.dir/endpoints-login.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/endpoints-login.c.o.d"
+  "/root/repo/endpoints-share.c" "CMakeFiles/liblpass-shared.dir/endpoints-share.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/endpoints-share.c.o.d"
+  "/root/repo/endpoints.c" "CMakeFiles/liblpass-shared.dir/endpoints.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/endpoints.c.o.d"
+  "/root/repo/feature-flag.c" "CMakeFiles/liblpass-shared.dir/feature-flag.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/feature-flag.c.o.d"
+  "/root/repo/format.c" "CMakeFiles/liblpass-shared.dir/format.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/format.c.o.d"
+  "/root/repo/http.c" "CMakeFiles/liblpass-shared.dir/http.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/http.c.o.d"
+  "/root/repo/json-format.c" "CMakeFiles/liblpass-shared.dir/json-format.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/json-format.c.o.d"
+  "/root/repo/kdf.c" "CMakeFiles/liblpass-shared.dir/kdf.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/kdf.c.o.d"
+  "/root/repo/liblpass.c" "CMakeFiles/liblpass-shared.dir/liblpass.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/liblpass.c.o.d"
+  "/root/repo/log.c" "CMakeFiles/liblpass-shared.dir/log.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/log.c.o.d"
+  "/root/repo/notes.c" "CMakeFiles/liblpass-shared.dir/notes.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/notes.c.o.d"
+  "/root/repo/password.c" "CMakeFiles/liblpass-shared.dir/password.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/password.c.o.d"
+  "/root/repo/pbkdf2.c" "CMakeFiles/liblpass-shared.dir/pbkdf2.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/pbkdf2.c.o.d"
+  "/root/repo/process.c" "CMakeFiles/liblpass-shared.dir/process.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/process.c.o.d"
+  "/root/repo/session.c" "CMakeFiles/liblpass-shared.dir/session.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/session.c.o.d"
+  "/root/repo/terminal.c" "CMakeFiles/liblpass-shared.dir/terminal.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/terminal.c.o.d"
+  "/root/repo/upload-queue.c" "CMakeFiles/liblpass-shared.dir/upload-queue.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/upload-queue.c.o.d"
+  "/root/repo/usage.c" "CMakeFiles/liblpass-shared.dir/usage.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/usage.c.o.d"
+  "/root/repo/util.c" "CMakeFiles/liblpass-shared.dir/util.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/util.c.o.d"
+  "/root/repo/xml.c" "CMakeFiles/liblpass-shared.dir/xml.c.o" "gcc" "CMakeFiles/liblpass-shared.dir/xml.c.o.d"
+  )
+
+# Pairs of files generated by the same build rule.
+set(CMAKE_MULTIPLE_OUTPUT_PAIRS
+  "/root/repo/build/liblpass.so" "/root/repo/build/liblpass.so.0.1.0"
+  "/root/repo/build/liblpass.so.0" "/root/repo/build/liblpass.so.0.1.0"
+  )
+
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
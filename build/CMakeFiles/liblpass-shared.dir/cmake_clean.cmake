@@ -0,0 +1,63 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/liblpass-shared.dir/agent.c.o"
+  "CMakeFiles/liblpass-shared.dir/agent.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/blob.c.o"
+  "CMakeFiles/liblpass-shared.dir/blob.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/cipher.c.o"
+  "CMakeFiles/liblpass-shared.dir/cipher.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/clipboard.c.o"
+  "CMakeFiles/liblpass-shared.dir/clipboard.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/config.c.o"
+  "CMakeFiles/liblpass-shared.dir/config.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/edit.c.o"
+  "CMakeFiles/liblpass-shared.dir/edit.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/endpoints-login.c.o"
+  "CMakeFiles/liblpass-shared.dir/endpoints-login.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/endpoints-share.c.o"
+  "CMakeFiles/liblpass-shared.dir/endpoints-share.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/endpoints.c.o"
+  "CMakeFiles/liblpass-shared.dir/endpoints.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/feature-flag.c.o"
+  "CMakeFiles/liblpass-shared.dir/feature-flag.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/format.c.o"
+  "CMakeFiles/liblpass-shared.dir/format.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/http.c.o"
+  "CMakeFiles/liblpass-shared.dir/http.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/json-format.c.o"
+  "CMakeFiles/liblpass-shared.dir/json-format.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/kdf.c.o"
+  "CMakeFiles/liblpass-shared.dir/kdf.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/liblpass.c.o"
+  "CMakeFiles/liblpass-shared.dir/liblpass.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/log.c.o"
+  "CMakeFiles/liblpass-shared.dir/log.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/notes.c.o"
+  "CMakeFiles/liblpass-shared.dir/notes.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/password.c.o"
+  "CMakeFiles/liblpass-shared.dir/password.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/pbkdf2.c.o"
+  "CMakeFiles/liblpass-shared.dir/pbkdf2.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/process.c.o"
+  "CMakeFiles/liblpass-shared.dir/process.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/session.c.o"
+  "CMakeFiles/liblpass-shared.dir/session.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/terminal.c.o"
+  "CMakeFiles/liblpass-shared.dir/terminal.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/upload-queue.c.o"
+  "CMakeFiles/liblpass-shared.dir/upload-queue.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/usage.c.o"
+  "CMakeFiles/liblpass-shared.dir/usage.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/util.c.o"
+  "CMakeFiles/liblpass-shared.dir/util.c.o.d"
+  "CMakeFiles/liblpass-shared.dir/xml.c.o"
+  "CMakeFiles/liblpass-shared.dir/xml.c.o.d"
+  "liblpass.pdb"
+  "liblpass.so"
+  "liblpass.so.0"
+  "liblpass.so.0.1.0"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/liblpass-shared.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
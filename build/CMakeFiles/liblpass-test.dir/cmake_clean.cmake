@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/liblpass-test.dir/test/lib/liblpass-test.c.o"
+  "CMakeFiles/liblpass-test.dir/test/lib/liblpass-test.c.o.d"
+  "liblpass-test"
+  "liblpass-test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/liblpass-test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,44 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/agent.c" "CMakeFiles/liblpass.dir/agent.c.o" "gcc" "CMakeFiles/liblpass.dir/agent.c.o.d"
+  "/root/repo/blob.c" "CMakeFiles/liblpass.dir/blob.c.o" "gcc" "CMakeFiles/liblpass.dir/blob.c.o.d"
+  "/root/repo/cipher.c" "CMakeFiles/liblpass.dir/cipher.c.o" "gcc" "CMakeFiles/liblpass.dir/cipher.c.o.d"
+  "/root/repo/clipboard.c" "CMakeFiles/liblpass.dir/clipboard.c.o" "gcc" "CMakeFiles/liblpass.dir/clipboard.c.o.d"
+  "/root/repo/config.c" "CMakeFiles/liblpass.dir/config.c.o" "gcc" "CMakeFiles/liblpass.dir/config.c.o.d"
+  "/root/repo/edit.c" "CMakeFiles/liblpass.dir/edit.c.o" "gcc" "CMakeFiles/liblpass.dir/edit.c.o.d"
+  "/root/repo/endpoints-login.c" "CMakeFiles/liblpass.dir/endpoints-login.c.o" "gcc" "CMakeFiles/liblpass.dir/endpoints-login.c.o.d"
+  "/root/repo/endpoints-share.c" "CMakeFiles/liblpass.dir/endpoints-share.c.o" "gcc" "CMakeFiles/liblpass.dir/endpoints-share.c.o.d"
+  "/root/repo/endpoints.c" "CMakeFiles/liblpass.dir/endpoints.c.o" "gcc" "CMakeFiles/liblpass.dir/endpoints.c.o.d"
+  "/root/repo/feature-flag.c" "CMakeFiles/liblpass.dir/feature-flag.c.o" "gcc" "CMakeFiles/liblpass.dir/feature-flag.c.o.d"
+  "/root/repo/format.c" "CMakeFiles/liblpass.dir/format.c.o" "gcc" "CMakeFiles/liblpass.dir/format.c.o.d"
+  "/root/repo/http.c" "CMakeFiles/liblpass.dir/http.c.o" "gcc" "CMakeFiles/liblpass.dir/http.c.o.d"
+  "/root/repo/json-format.c" "CMakeFiles/liblpass.dir/json-format.c.o" "gcc" "CMakeFiles/liblpass.dir/json-format.c.o.d"
+  "/root/repo/kdf.c" "CMakeFiles/liblpass.dir/kdf.c.o" "gcc" "CMakeFiles/liblpass.dir/kdf.c.o.d"
+  "/root/repo/liblpass.c" "CMakeFiles/liblpass.dir/liblpass.c.o" "gcc" "CMakeFiles/liblpass.dir/liblpass.c.o.d"
+  "/root/repo/log.c" "CMakeFiles/liblpass.dir/log.c.o" "gcc" "CMakeFiles/liblpass.dir/log.c.o.d"
+  "/root/repo/notes.c" "CMakeFiles/liblpass.dir/notes.c.o" "gcc" "CMakeFiles/liblpass.dir/notes.c.o.d"
+  "/root/repo/password.c" "CMakeFiles/liblpass.dir/password.c.o" "gcc" "CMakeFiles/liblpass.dir/password.c.o.d"
+  "/root/repo/pbkdf2.c" "CMakeFiles/liblpass.dir/pbkdf2.c.o" "gcc" "CMakeFiles/liblpass.dir/pbkdf2.c.o.d"
+  "/root/repo/process.c" "CMakeFiles/liblpass.dir/process.c.o" "gcc" "CMakeFiles/liblpass.dir/process.c.o.d"
+  "/root/repo/session.c" "CMakeFiles/liblpass.dir/session.c.o" "gcc" "CMakeFiles/liblpass.dir/session.c.o.d"
+  "/root/repo/terminal.c" "CMakeFiles/liblpass.dir/terminal.c.o" "gcc" "CMakeFiles/liblpass.dir/terminal.c.o.d"
+  "/root/repo/upload-queue.c" "CMakeFiles/liblpass.dir/upload-queue.c.o" "gcc" "CMakeFiles/liblpass.dir/upload-queue.c.o.d"
+  "/root/repo/usage.c" "CMakeFiles/liblpass.dir/usage.c.o" "gcc" "CMakeFiles/liblpass.dir/usage.c.o.d"
+  "/root/repo/util.c" "CMakeFiles/liblpass.dir/util.c.o" "gcc" "CMakeFiles/liblpass.dir/util.c.o.d"
+  "/root/repo/xml.c" "CMakeFiles/liblpass.dir/xml.c.o" "gcc" "CMakeFiles/liblpass.dir/xml.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
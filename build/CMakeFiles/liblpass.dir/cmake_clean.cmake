@@ -0,0 +1,61 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/liblpass.dir/agent.c.o"
+  "CMakeFiles/liblpass.dir/agent.c.o.d"
+  "CMakeFiles/liblpass.dir/blob.c.o"
+  "CMakeFiles/liblpass.dir/blob.c.o.d"
+  "CMakeFiles/liblpass.dir/cipher.c.o"
+  "CMakeFiles/liblpass.dir/cipher.c.o.d"
+  "CMakeFiles/liblpass.dir/clipboard.c.o"
+  "CMakeFiles/liblpass.dir/clipboard.c.o.d"
+  "CMakeFiles/liblpass.dir/config.c.o"
+  "CMakeFiles/liblpass.dir/config.c.o.d"
+  "CMakeFiles/liblpass.dir/edit.c.o"
+  "CMakeFiles/liblpass.dir/edit.c.o.d"
+  "CMakeFiles/liblpass.dir/endpoints-login.c.o"
+  "CMakeFiles/liblpass.dir/endpoints-login.c.o.d"
+  "CMakeFiles/liblpass.dir/endpoints-share.c.o"
+  "CMakeFiles/liblpass.dir/endpoints-share.c.o.d"
+  "CMakeFiles/liblpass.dir/endpoints.c.o"
+  "CMakeFiles/liblpass.dir/endpoints.c.o.d"
+  "CMakeFiles/liblpass.dir/feature-flag.c.o"
+  "CMakeFiles/liblpass.dir/feature-flag.c.o.d"
+  "CMakeFiles/liblpass.dir/format.c.o"
+  "CMakeFiles/liblpass.dir/format.c.o.d"
+  "CMakeFiles/liblpass.dir/http.c.o"
+  "CMakeFiles/liblpass.dir/http.c.o.d"
+  "CMakeFiles/liblpass.dir/json-format.c.o"
+  "CMakeFiles/liblpass.dir/json-format.c.o.d"
+  "CMakeFiles/liblpass.dir/kdf.c.o"
+  "CMakeFiles/liblpass.dir/kdf.c.o.d"
+  "CMakeFiles/liblpass.dir/liblpass.c.o"
+  "CMakeFiles/liblpass.dir/liblpass.c.o.d"
+  "CMakeFiles/liblpass.dir/log.c.o"
+  "CMakeFiles/liblpass.dir/log.c.o.d"
+  "CMakeFiles/liblpass.dir/notes.c.o"
+  "CMakeFiles/liblpass.dir/notes.c.o.d"
+  "CMakeFiles/liblpass.dir/password.c.o"
+  "CMakeFiles/liblpass.dir/password.c.o.d"
+  "CMakeFiles/liblpass.dir/pbkdf2.c.o"
+  "CMakeFiles/liblpass.dir/pbkdf2.c.o.d"
+  "CMakeFiles/liblpass.dir/process.c.o"
+  "CMakeFiles/liblpass.dir/process.c.o.d"
+  "CMakeFiles/liblpass.dir/session.c.o"
+  "CMakeFiles/liblpass.dir/session.c.o.d"
+  "CMakeFiles/liblpass.dir/terminal.c.o"
+  "CMakeFiles/liblpass.dir/terminal.c.o.d"
+  "CMakeFiles/liblpass.dir/upload-queue.c.o"
+  "CMakeFiles/liblpass.dir/upload-queue.c.o.d"
+  "CMakeFiles/liblpass.dir/usage.c.o"
+  "CMakeFiles/liblpass.dir/usage.c.o.d"
+  "CMakeFiles/liblpass.dir/util.c.o"
+  "CMakeFiles/liblpass.dir/util.c.o.d"
+  "CMakeFiles/liblpass.dir/xml.c.o"
+  "CMakeFiles/liblpass.dir/xml.c.o.d"
+  "liblpass.a"
+  "liblpass.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/liblpass.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,67 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/agent.c" "CMakeFiles/lpass-test.dir/agent.c.o" "gcc" "CMakeFiles/lpass-test.dir/agent.c.o.d"
+  "/root/repo/blob.c" "CMakeFiles/lpass-test.dir/blob.c.o" "gcc" "CMakeFiles/lpass-test.dir/blob.c.o.d"
+  "/root/repo/cipher.c" "CMakeFiles/lpass-test.dir/cipher.c.o" "gcc" "CMakeFiles/lpass-test.dir/cipher.c.o.d"
+  "/root/repo/clipboard.c" "CMakeFiles/lpass-test.dir/clipboard.c.o" "gcc" "CMakeFiles/lpass-test.dir/clipboard.c.o.d"
+  "/root/repo/cmd-add.c" "CMakeFiles/lpass-test.dir/cmd-add.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-add.c.o.d"
+  "/root/repo/cmd-attach.c" "CMakeFiles/lpass-test.dir/cmd-attach.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-attach.c.o.d"
+  "/root/repo/cmd-duplicate.c" "CMakeFiles/lpass-test.dir/cmd-duplicate.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-duplicate.c.o.d"
+  "/root/repo/cmd-edit.c" "CMakeFiles/lpass-test.dir/cmd-edit.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-edit.c.o.d"
+  "/root/repo/cmd-export.c" "CMakeFiles/lpass-test.dir/cmd-export.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-export.c.o.d"
+  "/root/repo/cmd-generate.c" "CMakeFiles/lpass-test.dir/cmd-generate.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-generate.c.o.d"
+  "/root/repo/cmd-import.c" "CMakeFiles/lpass-test.dir/cmd-import.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-import.c.o.d"
+  "/root/repo/cmd-login.c" "CMakeFiles/lpass-test.dir/cmd-login.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-login.c.o.d"
+  "/root/repo/cmd-logout.c" "CMakeFiles/lpass-test.dir/cmd-logout.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-logout.c.o.d"
+  "/root/repo/cmd-ls.c" "CMakeFiles/lpass-test.dir/cmd-ls.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-ls.c.o.d"
+  "/root/repo/cmd-materialize.c" "CMakeFiles/lpass-test.dir/cmd-materialize.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-materialize.c.o.d"
+  "/root/repo/cmd-mv.c" "CMakeFiles/lpass-test.dir/cmd-mv.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-mv.c.o.d"
+  "/root/repo/cmd-passwd.c" "CMakeFiles/lpass-test.dir/cmd-passwd.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-passwd.c.o.d"
+  "/root/repo/cmd-pick.c" "CMakeFiles/lpass-test.dir/cmd-pick.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-pick.c.o.d"
+  "/root/repo/cmd-query.c" "CMakeFiles/lpass-test.dir/cmd-query.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-query.c.o.d"
+  "/root/repo/cmd-rm.c" "CMakeFiles/lpass-test.dir/cmd-rm.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-rm.c.o.d"
+  "/root/repo/cmd-share.c" "CMakeFiles/lpass-test.dir/cmd-share.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-share.c.o.d"
+  "/root/repo/cmd-show.c" "CMakeFiles/lpass-test.dir/cmd-show.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-show.c.o.d"
+  "/root/repo/cmd-status.c" "CMakeFiles/lpass-test.dir/cmd-status.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-status.c.o.d"
+  "/root/repo/cmd-sync.c" "CMakeFiles/lpass-test.dir/cmd-sync.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd-sync.c.o.d"
+  "/root/repo/cmd.c" "CMakeFiles/lpass-test.dir/cmd.c.o" "gcc" "CMakeFiles/lpass-test.dir/cmd.c.o.d"
+  "/root/repo/config.c" "CMakeFiles/lpass-test.dir/config.c.o" "gcc" "CMakeFiles/lpass-test.dir/config.c.o.d"
+  "/root/repo/edit.c" "CMakeFiles/lpass-test.dir/edit.c.o" "gcc" "CMakeFiles/lpass-test.dir/edit.c.o.d"
+  "/root/repo/endpoints-login.c" "CMakeFiles/lpass-test.dir/endpoints-login.c.o" "gcc" "CMakeFiles/lpass-test.dir/endpoints-login.c.o.d"
+  "/root/repo/endpoints-share.c" "CMakeFiles/lpass-test.dir/endpoints-share.c.o" "gcc" "CMakeFiles/lpass-test.dir/endpoints-share.c.o.d"
+  "/root/repo/endpoints.c" "CMakeFiles/lpass-test.dir/endpoints.c.o" "gcc" "CMakeFiles/lpass-test.dir/endpoints.c.o.d"
+  "/root/repo/feature-flag.c" "CMakeFiles/lpass-test.dir/feature-flag.c.o" "gcc" "CMakeFiles/lpass-test.dir/feature-flag.c.o.d"
+  "/root/repo/format.c" "CMakeFiles/lpass-test.dir/format.c.o" "gcc" "CMakeFiles/lpass-test.dir/format.c.o.d"
+  "/root/repo/http.c" "CMakeFiles/lpass-test.dir/http.c.o" "gcc" "CMakeFiles/lpass-test.dir/http.c.o.d"
+  "/root/repo/json-format.c" "CMakeFiles/lpass-test.dir/json-format.c.o" "gcc" "CMakeFiles/lpass-test.dir/json-format.c.o.d"
+  "/root/repo/kdf.c" "CMakeFiles/lpass-test.dir/kdf.c.o" "gcc" "CMakeFiles/lpass-test.dir/kdf.c.o.d"
+  "/root/repo/liblpass.c" "CMakeFiles/lpass-test.dir/liblpass.c.o" "gcc" "CMakeFiles/lpass-test.dir/liblpass.c.o.d"
+  "/root/repo/log.c" "CMakeFiles/lpass-test.dir/log.c.o" "gcc" "CMakeFiles/lpass-test.dir/log.c.o.d"
+  "/root/repo/lpass.c" "CMakeFiles/lpass-test.dir/lpass.c.o" "gcc" "CMakeFiles/lpass-test.dir/lpass.c.o.d"
+  "/root/repo/notes.c" "CMakeFiles/lpass-test.dir/notes.c.o" "gcc" "CMakeFiles/lpass-test.dir/notes.c.o.d"
+  "/root/repo/password.c" "CMakeFiles/lpass-test.dir/password.c.o" "gcc" "CMakeFiles/lpass-test.dir/password.c.o.d"
+  "/root/repo/pbkdf2.c" "CMakeFiles/lpass-test.dir/pbkdf2.c.o" "gcc" "CMakeFiles/lpass-test.dir/pbkdf2.c.o.d"
+  "/root/repo/process.c" "CMakeFiles/lpass-test.dir/process.c.o" "gcc" "CMakeFiles/lpass-test.dir/process.c.o.d"
+  "/root/repo/session.c" "CMakeFiles/lpass-test.dir/session.c.o" "gcc" "CMakeFiles/lpass-test.dir/session.c.o.d"
+  "/root/repo/terminal.c" "CMakeFiles/lpass-test.dir/terminal.c.o" "gcc" "CMakeFiles/lpass-test.dir/terminal.c.o.d"
+  "/root/repo/test/http_mock.c" "CMakeFiles/lpass-test.dir/test/http_mock.c.o" "gcc" "CMakeFiles/lpass-test.dir/test/http_mock.c.o.d"
+  "/root/repo/upload-queue.c" "CMakeFiles/lpass-test.dir/upload-queue.c.o" "gcc" "CMakeFiles/lpass-test.dir/upload-queue.c.o.d"
+  "/root/repo/usage.c" "CMakeFiles/lpass-test.dir/usage.c.o" "gcc" "CMakeFiles/lpass-test.dir/usage.c.o.d"
+  "/root/repo/util.c" "CMakeFiles/lpass-test.dir/util.c.o" "gcc" "CMakeFiles/lpass-test.dir/util.c.o.d"
+  "/root/repo/xml.c" "CMakeFiles/lpass-test.dir/xml.c.o" "gcc" "CMakeFiles/lpass-test.dir/xml.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,41 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/cmd-add.c" "CMakeFiles/lpass.dir/cmd-add.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-add.c.o.d"
+  "/root/repo/cmd-attach.c" "CMakeFiles/lpass.dir/cmd-attach.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-attach.c.o.d"
+  "/root/repo/cmd-duplicate.c" "CMakeFiles/lpass.dir/cmd-duplicate.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-duplicate.c.o.d"
+  "/root/repo/cmd-edit.c" "CMakeFiles/lpass.dir/cmd-edit.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-edit.c.o.d"
+  "/root/repo/cmd-export.c" "CMakeFiles/lpass.dir/cmd-export.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-export.c.o.d"
+  "/root/repo/cmd-generate.c" "CMakeFiles/lpass.dir/cmd-generate.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-generate.c.o.d"
+  "/root/repo/cmd-import.c" "CMakeFiles/lpass.dir/cmd-import.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-import.c.o.d"
+  "/root/repo/cmd-login.c" "CMakeFiles/lpass.dir/cmd-login.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-login.c.o.d"
+  "/root/repo/cmd-logout.c" "CMakeFiles/lpass.dir/cmd-logout.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-logout.c.o.d"
+  "/root/repo/cmd-ls.c" "CMakeFiles/lpass.dir/cmd-ls.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-ls.c.o.d"
+  "/root/repo/cmd-materialize.c" "CMakeFiles/lpass.dir/cmd-materialize.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-materialize.c.o.d"
+  "/root/repo/cmd-mv.c" "CMakeFiles/lpass.dir/cmd-mv.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-mv.c.o.d"
+  "/root/repo/cmd-passwd.c" "CMakeFiles/lpass.dir/cmd-passwd.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-passwd.c.o.d"
+  "/root/repo/cmd-pick.c" "CMakeFiles/lpass.dir/cmd-pick.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-pick.c.o.d"
+  "/root/repo/cmd-query.c" "CMakeFiles/lpass.dir/cmd-query.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-query.c.o.d"
+  "/root/repo/cmd-rm.c" "CMakeFiles/lpass.dir/cmd-rm.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-rm.c.o.d"
+  "/root/repo/cmd-share.c" "CMakeFiles/lpass.dir/cmd-share.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-share.c.o.d"
+  "/root/repo/cmd-show.c" "CMakeFiles/lpass.dir/cmd-show.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-show.c.o.d"
+  "/root/repo/cmd-status.c" "CMakeFiles/lpass.dir/cmd-status.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-status.c.o.d"
+  "/root/repo/cmd-sync.c" "CMakeFiles/lpass.dir/cmd-sync.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-sync.c.o.d"
+  "/root/repo/cmd.c" "CMakeFiles/lpass.dir/cmd.c.o" "gcc" "CMakeFiles/lpass.dir/cmd.c.o.d"
+  "/root/repo/lpass.c" "CMakeFiles/lpass.dir/lpass.c.o" "gcc" "CMakeFiles/lpass.dir/lpass.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/build/CMakeFiles/liblpass.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,53 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/lpass.dir/cmd-add.c.o"
+  "CMakeFiles/lpass.dir/cmd-add.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-attach.c.o"
+  "CMakeFiles/lpass.dir/cmd-attach.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-duplicate.c.o"
+  "CMakeFiles/lpass.dir/cmd-duplicate.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-edit.c.o"
+  "CMakeFiles/lpass.dir/cmd-edit.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-export.c.o"
+  "CMakeFiles/lpass.dir/cmd-export.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-generate.c.o"
+  "CMakeFiles/lpass.dir/cmd-generate.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-import.c.o"
+  "CMakeFiles/lpass.dir/cmd-import.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-login.c.o"
+  "CMakeFiles/lpass.dir/cmd-login.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-logout.c.o"
+  "CMakeFiles/lpass.dir/cmd-logout.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-ls.c.o"
+  "CMakeFiles/lpass.dir/cmd-ls.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-materialize.c.o"
+  "CMakeFiles/lpass.dir/cmd-materialize.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-mv.c.o"
+  "CMakeFiles/lpass.dir/cmd-mv.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-passwd.c.o"
+  "CMakeFiles/lpass.dir/cmd-passwd.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-pick.c.o"
+  "CMakeFiles/lpass.dir/cmd-pick.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-query.c.o"
+  "CMakeFiles/lpass.dir/cmd-query.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-rm.c.o"
+  "CMakeFiles/lpass.dir/cmd-rm.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-share.c.o"
+  "CMakeFiles/lpass.dir/cmd-share.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-show.c.o"
+  "CMakeFiles/lpass.dir/cmd-show.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-status.c.o"
+  "CMakeFiles/lpass.dir/cmd-status.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-sync.c.o"
+  "CMakeFiles/lpass.dir/cmd-sync.c.o.d"
+  "CMakeFiles/lpass.dir/cmd.c.o"
+  "CMakeFiles/lpass.dir/cmd.c.o.d"
+  "CMakeFiles/lpass.dir/lpass.c.o"
+  "CMakeFiles/lpass.dir/lpass.c.o.d"
+  "lpass"
+  "lpass.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/lpass.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,88 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/build
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(test_login "/root/repo/test/tests" "test_login")
+set_tests_properties(test_login PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;231;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_login_wrong_pw_should_fail "/root/repo/test/tests" "test_login_wrong_pw_should_fail")
+set_tests_properties(test_login_wrong_pw_should_fail PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;232;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_login_background "/root/repo/test/tests" "test_login_background")
+set_tests_properties(test_login_background PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;233;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_agent_keepalive "/root/repo/test/tests" "test_agent_keepalive")
+set_tests_properties(test_agent_keepalive PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;234;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_profiles "/root/repo/test/tests" "test_profiles")
+set_tests_properties(test_profiles PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;235;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_add_account "/root/repo/test/tests" "test_add_account")
+set_tests_properties(test_add_account PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;236;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_add_note "/root/repo/test/tests" "test_add_note")
+set_tests_properties(test_add_note PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;237;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_add_note_with_field "/root/repo/test/tests" "test_add_note_with_field")
+set_tests_properties(test_add_note_with_field PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;238;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_add_site_note "/root/repo/test/tests" "test_add_site_note")
+set_tests_properties(test_add_site_note PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;239;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_add_ssn_name "/root/repo/test/tests" "test_add_ssn_name")
+set_tests_properties(test_add_ssn_name PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;240;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_add_ssh_key "/root/repo/test/tests" "test_add_ssh_key")
+set_tests_properties(test_add_ssh_key PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;241;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_edit_ssh_key "/root/repo/test/tests" "test_edit_ssh_key")
+set_tests_properties(test_edit_ssh_key PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;242;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_edit_username "/root/repo/test/tests" "test_edit_username")
+set_tests_properties(test_edit_username PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;243;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_edit_unchanged "/root/repo/test/tests" "test_edit_unchanged")
+set_tests_properties(test_edit_unchanged PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;244;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_edit_field "/root/repo/test/tests" "test_edit_field")
+set_tests_properties(test_edit_field PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;245;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_edit_reprompt "/root/repo/test/tests" "test_edit_reprompt")
+set_tests_properties(test_edit_reprompt PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;246;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_duplicate "/root/repo/test/tests" "test_duplicate")
+set_tests_properties(test_duplicate PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;247;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_add_batch "/root/repo/test/tests" "test_add_batch")
+set_tests_properties(test_add_batch PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;248;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_duplicate_template "/root/repo/test/tests" "test_duplicate_template")
+set_tests_properties(test_duplicate_template PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;249;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_mv_rm_multiple "/root/repo/test/tests" "test_mv_rm_multiple")
+set_tests_properties(test_mv_rm_multiple PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;250;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_upload_queue_batches "/root/repo/test/tests" "test_upload_queue_batches")
+set_tests_properties(test_upload_queue_batches PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;251;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_mv_rename_folder "/root/repo/test/tests" "test_mv_rename_folder")
+set_tests_properties(test_mv_rename_folder PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;252;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_generate "/root/repo/test/tests" "test_generate")
+set_tests_properties(test_generate PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;253;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_show "/root/repo/test/tests" "test_show")
+set_tests_properties(test_show PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;254;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_show_json "/root/repo/test/tests" "test_show_json")
+set_tests_properties(test_show_json PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;255;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_show_note "/root/repo/test/tests" "test_show_note")
+set_tests_properties(test_show_note PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;256;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_show_reprompt "/root/repo/test/tests" "test_show_reprompt")
+set_tests_properties(test_show_reprompt PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;257;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_show_clip "/root/repo/test/tests" "test_show_clip")
+set_tests_properties(test_show_clip PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;258;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_show_clip_clear_after "/root/repo/test/tests" "test_show_clip_clear_after")
+set_tests_properties(test_show_clip_clear_after PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;259;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_attach_add "/root/repo/test/tests" "test_attach_add")
+set_tests_properties(test_attach_add PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;260;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_materialize "/root/repo/test/tests" "test_materialize")
+set_tests_properties(test_materialize PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;261;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_ls "/root/repo/test/tests" "test_ls")
+set_tests_properties(test_ls PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;262;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_ls_by_usage "/root/repo/test/tests" "test_ls_by_usage")
+set_tests_properties(test_ls_by_usage PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;263;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_usage_compact "/root/repo/test/tests" "test_usage_compact")
+set_tests_properties(test_usage_compact PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;264;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_pick_filter "/root/repo/test/tests" "test_pick_filter")
+set_tests_properties(test_pick_filter PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;265;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_query "/root/repo/test/tests" "test_query")
+set_tests_properties(test_query PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;266;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_import_batched "/root/repo/test/tests" "test_import_batched")
+set_tests_properties(test_import_batched PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;267;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_export "/root/repo/test/tests" "test_export")
+set_tests_properties(test_export PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;268;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_export_extended "/root/repo/test/tests" "test_export_extended")
+set_tests_properties(test_export_extended PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;269;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_liblpass "/root/repo/test/tests" "test_liblpass")
+set_tests_properties(test_liblpass PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;270;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_share_limit "/root/repo/test/tests" "test_share_limit")
+set_tests_properties(test_share_limit PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;271;add_test;/root/repo/CMakeLists.txt;0;")
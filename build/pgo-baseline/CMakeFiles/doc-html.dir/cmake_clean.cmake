@@ -0,0 +1,9 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/doc-html"
+  "lpass.1.html"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/doc-html.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,93 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/lpass.dir/agent.c.o"
+  "CMakeFiles/lpass.dir/agent.c.o.d"
+  "CMakeFiles/lpass.dir/blob.c.o"
+  "CMakeFiles/lpass.dir/blob.c.o.d"
+  "CMakeFiles/lpass.dir/cipher.c.o"
+  "CMakeFiles/lpass.dir/cipher.c.o.d"
+  "CMakeFiles/lpass.dir/clipboard.c.o"
+  "CMakeFiles/lpass.dir/clipboard.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-add.c.o"
+  "CMakeFiles/lpass.dir/cmd-add.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-duplicate.c.o"
+  "CMakeFiles/lpass.dir/cmd-duplicate.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-edit.c.o"
+  "CMakeFiles/lpass.dir/cmd-edit.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-export.c.o"
+  "CMakeFiles/lpass.dir/cmd-export.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-generate.c.o"
+  "CMakeFiles/lpass.dir/cmd-generate.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-import.c.o"
+  "CMakeFiles/lpass.dir/cmd-import.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-login.c.o"
+  "CMakeFiles/lpass.dir/cmd-login.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-logout.c.o"
+  "CMakeFiles/lpass.dir/cmd-logout.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-ls.c.o"
+  "CMakeFiles/lpass.dir/cmd-ls.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-mv.c.o"
+  "CMakeFiles/lpass.dir/cmd-mv.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-passwd.c.o"
+  "CMakeFiles/lpass.dir/cmd-passwd.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-rm.c.o"
+  "CMakeFiles/lpass.dir/cmd-rm.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-share.c.o"
+  "CMakeFiles/lpass.dir/cmd-share.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-show.c.o"
+  "CMakeFiles/lpass.dir/cmd-show.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-status.c.o"
+  "CMakeFiles/lpass.dir/cmd-status.c.o.d"
+  "CMakeFiles/lpass.dir/cmd-sync.c.o"
+  "CMakeFiles/lpass.dir/cmd-sync.c.o.d"
+  "CMakeFiles/lpass.dir/cmd.c.o"
+  "CMakeFiles/lpass.dir/cmd.c.o.d"
+  "CMakeFiles/lpass.dir/config.c.o"
+  "CMakeFiles/lpass.dir/config.c.o.d"
+  "CMakeFiles/lpass.dir/edit.c.o"
+  "CMakeFiles/lpass.dir/edit.c.o.d"
+  "CMakeFiles/lpass.dir/endpoints-login.c.o"
+  "CMakeFiles/lpass.dir/endpoints-login.c.o.d"
+  "CMakeFiles/lpass.dir/endpoints-share.c.o"
+  "CMakeFiles/lpass.dir/endpoints-share.c.o.d"
+  "CMakeFiles/lpass.dir/endpoints.c.o"
+  "CMakeFiles/lpass.dir/endpoints.c.o.d"
+  "CMakeFiles/lpass.dir/feature-flag.c.o"
+  "CMakeFiles/lpass.dir/feature-flag.c.o.d"
+  "CMakeFiles/lpass.dir/format.c.o"
+  "CMakeFiles/lpass.dir/format.c.o.d"
+  "CMakeFiles/lpass.dir/http.c.o"
+  "CMakeFiles/lpass.dir/http.c.o.d"
+  "CMakeFiles/lpass.dir/json-format.c.o"
+  "CMakeFiles/lpass.dir/json-format.c.o.d"
+  "CMakeFiles/lpass.dir/kdf.c.o"
+  "CMakeFiles/lpass.dir/kdf.c.o.d"
+  "CMakeFiles/lpass.dir/log.c.o"
+  "CMakeFiles/lpass.dir/log.c.o.d"
+  "CMakeFiles/lpass.dir/lpass.c.o"
+  "CMakeFiles/lpass.dir/lpass.c.o.d"
+  "CMakeFiles/lpass.dir/notes.c.o"
+  "CMakeFiles/lpass.dir/notes.c.o.d"
+  "CMakeFiles/lpass.dir/password.c.o"
+  "CMakeFiles/lpass.dir/password.c.o.d"
+  "CMakeFiles/lpass.dir/pbkdf2.c.o"
+  "CMakeFiles/lpass.dir/pbkdf2.c.o.d"
+  "CMakeFiles/lpass.dir/process.c.o"
+  "CMakeFiles/lpass.dir/process.c.o.d"
+  "CMakeFiles/lpass.dir/session.c.o"
+  "CMakeFiles/lpass.dir/session.c.o.d"
+  "CMakeFiles/lpass.dir/terminal.c.o"
+  "CMakeFiles/lpass.dir/terminal.c.o.d"
+  "CMakeFiles/lpass.dir/upload-queue.c.o"
+  "CMakeFiles/lpass.dir/upload-queue.c.o.d"
+  "CMakeFiles/lpass.dir/util.c.o"
+  "CMakeFiles/lpass.dir/util.c.o.d"
+  "CMakeFiles/lpass.dir/xml.c.o"
+  "CMakeFiles/lpass.dir/xml.c.o.d"
+  "lpass"
+  "lpass.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/lpass.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
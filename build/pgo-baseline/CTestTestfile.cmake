@@ -0,0 +1,48 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/build/pgo-baseline
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(test_login "/root/repo/test/tests" "test_login")
+set_tests_properties(test_login PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;149;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_login_wrong_pw_should_fail "/root/repo/test/tests" "test_login_wrong_pw_should_fail")
+set_tests_properties(test_login_wrong_pw_should_fail PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;150;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_add_account "/root/repo/test/tests" "test_add_account")
+set_tests_properties(test_add_account PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;151;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_add_note "/root/repo/test/tests" "test_add_note")
+set_tests_properties(test_add_note PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;152;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_add_note_with_field "/root/repo/test/tests" "test_add_note_with_field")
+set_tests_properties(test_add_note_with_field PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;153;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_add_site_note "/root/repo/test/tests" "test_add_site_note")
+set_tests_properties(test_add_site_note PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;154;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_add_ssn_name "/root/repo/test/tests" "test_add_ssn_name")
+set_tests_properties(test_add_ssn_name PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;155;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_add_ssh_key "/root/repo/test/tests" "test_add_ssh_key")
+set_tests_properties(test_add_ssh_key PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;156;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_edit_ssh_key "/root/repo/test/tests" "test_edit_ssh_key")
+set_tests_properties(test_edit_ssh_key PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;157;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_edit_username "/root/repo/test/tests" "test_edit_username")
+set_tests_properties(test_edit_username PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;158;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_edit_field "/root/repo/test/tests" "test_edit_field")
+set_tests_properties(test_edit_field PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;159;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_edit_reprompt "/root/repo/test/tests" "test_edit_reprompt")
+set_tests_properties(test_edit_reprompt PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;160;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_duplicate "/root/repo/test/tests" "test_duplicate")
+set_tests_properties(test_duplicate PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;161;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_generate "/root/repo/test/tests" "test_generate")
+set_tests_properties(test_generate PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;162;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_show "/root/repo/test/tests" "test_show")
+set_tests_properties(test_show PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;163;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_show_json "/root/repo/test/tests" "test_show_json")
+set_tests_properties(test_show_json PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;164;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_show_note "/root/repo/test/tests" "test_show_note")
+set_tests_properties(test_show_note PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;165;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_show_reprompt "/root/repo/test/tests" "test_show_reprompt")
+set_tests_properties(test_show_reprompt PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;166;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_ls "/root/repo/test/tests" "test_ls")
+set_tests_properties(test_ls PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;167;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_export "/root/repo/test/tests" "test_export")
+set_tests_properties(test_export PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;168;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(test_export_extended "/root/repo/test/tests" "test_export_extended")
+set_tests_properties(test_export_extended PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;169;add_test;/root/repo/CMakeLists.txt;0;")
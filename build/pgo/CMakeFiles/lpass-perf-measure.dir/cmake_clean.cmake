@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/lpass-perf-measure.dir/test/perf/measure.c.o"
+  "CMakeFiles/lpass-perf-measure.dir/test/perf/measure.c.o.d"
+  "lpass-perf-measure"
+  "lpass-perf-measure.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/lpass-perf-measure.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
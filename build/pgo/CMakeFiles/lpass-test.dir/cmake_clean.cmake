@@ -0,0 +1,95 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/lpass-test.dir/agent.c.o"
+  "CMakeFiles/lpass-test.dir/agent.c.o.d"
+  "CMakeFiles/lpass-test.dir/blob.c.o"
+  "CMakeFiles/lpass-test.dir/blob.c.o.d"
+  "CMakeFiles/lpass-test.dir/cipher.c.o"
+  "CMakeFiles/lpass-test.dir/cipher.c.o.d"
+  "CMakeFiles/lpass-test.dir/clipboard.c.o"
+  "CMakeFiles/lpass-test.dir/clipboard.c.o.d"
+  "CMakeFiles/lpass-test.dir/cmd-add.c.o"
+  "CMakeFiles/lpass-test.dir/cmd-add.c.o.d"
+  "CMakeFiles/lpass-test.dir/cmd-duplicate.c.o"
+  "CMakeFiles/lpass-test.dir/cmd-duplicate.c.o.d"
+  "CMakeFiles/lpass-test.dir/cmd-edit.c.o"
+  "CMakeFiles/lpass-test.dir/cmd-edit.c.o.d"
+  "CMakeFiles/lpass-test.dir/cmd-export.c.o"
+  "CMakeFiles/lpass-test.dir/cmd-export.c.o.d"
+  "CMakeFiles/lpass-test.dir/cmd-generate.c.o"
+  "CMakeFiles/lpass-test.dir/cmd-generate.c.o.d"
+  "CMakeFiles/lpass-test.dir/cmd-import.c.o"
+  "CMakeFiles/lpass-test.dir/cmd-import.c.o.d"
+  "CMakeFiles/lpass-test.dir/cmd-login.c.o"
+  "CMakeFiles/lpass-test.dir/cmd-login.c.o.d"
+  "CMakeFiles/lpass-test.dir/cmd-logout.c.o"
+  "CMakeFiles/lpass-test.dir/cmd-logout.c.o.d"
+  "CMakeFiles/lpass-test.dir/cmd-ls.c.o"
+  "CMakeFiles/lpass-test.dir/cmd-ls.c.o.d"
+  "CMakeFiles/lpass-test.dir/cmd-mv.c.o"
+  "CMakeFiles/lpass-test.dir/cmd-mv.c.o.d"
+  "CMakeFiles/lpass-test.dir/cmd-passwd.c.o"
+  "CMakeFiles/lpass-test.dir/cmd-passwd.c.o.d"
+  "CMakeFiles/lpass-test.dir/cmd-rm.c.o"
+  "CMakeFiles/lpass-test.dir/cmd-rm.c.o.d"
+  "CMakeFiles/lpass-test.dir/cmd-share.c.o"
+  "CMakeFiles/lpass-test.dir/cmd-share.c.o.d"
+  "CMakeFiles/lpass-test.dir/cmd-show.c.o"
+  "CMakeFiles/lpass-test.dir/cmd-show.c.o.d"
+  "CMakeFiles/lpass-test.dir/cmd-status.c.o"
+  "CMakeFiles/lpass-test.dir/cmd-status.c.o.d"
+  "CMakeFiles/lpass-test.dir/cmd-sync.c.o"
+  "CMakeFiles/lpass-test.dir/cmd-sync.c.o.d"
+  "CMakeFiles/lpass-test.dir/cmd.c.o"
+  "CMakeFiles/lpass-test.dir/cmd.c.o.d"
+  "CMakeFiles/lpass-test.dir/config.c.o"
+  "CMakeFiles/lpass-test.dir/config.c.o.d"
+  "CMakeFiles/lpass-test.dir/edit.c.o"
+  "CMakeFiles/lpass-test.dir/edit.c.o.d"
+  "CMakeFiles/lpass-test.dir/endpoints-login.c.o"
+  "CMakeFiles/lpass-test.dir/endpoints-login.c.o.d"
+  "CMakeFiles/lpass-test.dir/endpoints-share.c.o"
+  "CMakeFiles/lpass-test.dir/endpoints-share.c.o.d"
+  "CMakeFiles/lpass-test.dir/endpoints.c.o"
+  "CMakeFiles/lpass-test.dir/endpoints.c.o.d"
+  "CMakeFiles/lpass-test.dir/feature-flag.c.o"
+  "CMakeFiles/lpass-test.dir/feature-flag.c.o.d"
+  "CMakeFiles/lpass-test.dir/format.c.o"
+  "CMakeFiles/lpass-test.dir/format.c.o.d"
+  "CMakeFiles/lpass-test.dir/http.c.o"
+  "CMakeFiles/lpass-test.dir/http.c.o.d"
+  "CMakeFiles/lpass-test.dir/json-format.c.o"
+  "CMakeFiles/lpass-test.dir/json-format.c.o.d"
+  "CMakeFiles/lpass-test.dir/kdf.c.o"
+  "CMakeFiles/lpass-test.dir/kdf.c.o.d"
+  "CMakeFiles/lpass-test.dir/log.c.o"
+  "CMakeFiles/lpass-test.dir/log.c.o.d"
+  "CMakeFiles/lpass-test.dir/lpass.c.o"
+  "CMakeFiles/lpass-test.dir/lpass.c.o.d"
+  "CMakeFiles/lpass-test.dir/notes.c.o"
+  "CMakeFiles/lpass-test.dir/notes.c.o.d"
+  "CMakeFiles/lpass-test.dir/password.c.o"
+  "CMakeFiles/lpass-test.dir/password.c.o.d"
+  "CMakeFiles/lpass-test.dir/pbkdf2.c.o"
+  "CMakeFiles/lpass-test.dir/pbkdf2.c.o.d"
+  "CMakeFiles/lpass-test.dir/process.c.o"
+  "CMakeFiles/lpass-test.dir/process.c.o.d"
+  "CMakeFiles/lpass-test.dir/session.c.o"
+  "CMakeFiles/lpass-test.dir/session.c.o.d"
+  "CMakeFiles/lpass-test.dir/terminal.c.o"
+  "CMakeFiles/lpass-test.dir/terminal.c.o.d"
+  "CMakeFiles/lpass-test.dir/test/http_mock.c.o"
+  "CMakeFiles/lpass-test.dir/test/http_mock.c.o.d"
+  "CMakeFiles/lpass-test.dir/upload-queue.c.o"
+  "CMakeFiles/lpass-test.dir/upload-queue.c.o.d"
+  "CMakeFiles/lpass-test.dir/util.c.o"
+  "CMakeFiles/lpass-test.dir/util.c.o.d"
+  "CMakeFiles/lpass-test.dir/xml.c.o"
+  "CMakeFiles/lpass-test.dir/xml.c.o.d"
+  "lpass-test"
+  "lpass-test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/lpass-test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,60 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/agent.c" "CMakeFiles/lpass.dir/agent.c.o" "gcc" "CMakeFiles/lpass.dir/agent.c.o.d"
+  "/root/repo/blob.c" "CMakeFiles/lpass.dir/blob.c.o" "gcc" "CMakeFiles/lpass.dir/blob.c.o.d"
+  "/root/repo/cipher.c" "CMakeFiles/lpass.dir/cipher.c.o" "gcc" "CMakeFiles/lpass.dir/cipher.c.o.d"
+  "/root/repo/clipboard.c" "CMakeFiles/lpass.dir/clipboard.c.o" "gcc" "CMakeFiles/lpass.dir/clipboard.c.o.d"
+  "/root/repo/cmd-add.c" "CMakeFiles/lpass.dir/cmd-add.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-add.c.o.d"
+  "/root/repo/cmd-duplicate.c" "CMakeFiles/lpass.dir/cmd-duplicate.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-duplicate.c.o.d"
+  "/root/repo/cmd-edit.c" "CMakeFiles/lpass.dir/cmd-edit.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-edit.c.o.d"
+  "/root/repo/cmd-export.c" "CMakeFiles/lpass.dir/cmd-export.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-export.c.o.d"
+  "/root/repo/cmd-generate.c" "CMakeFiles/lpass.dir/cmd-generate.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-generate.c.o.d"
+  "/root/repo/cmd-import.c" "CMakeFiles/lpass.dir/cmd-import.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-import.c.o.d"
+  "/root/repo/cmd-login.c" "CMakeFiles/lpass.dir/cmd-login.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-login.c.o.d"
+  "/root/repo/cmd-logout.c" "CMakeFiles/lpass.dir/cmd-logout.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-logout.c.o.d"
+  "/root/repo/cmd-ls.c" "CMakeFiles/lpass.dir/cmd-ls.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-ls.c.o.d"
+  "/root/repo/cmd-mv.c" "CMakeFiles/lpass.dir/cmd-mv.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-mv.c.o.d"
+  "/root/repo/cmd-passwd.c" "CMakeFiles/lpass.dir/cmd-passwd.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-passwd.c.o.d"
+  "/root/repo/cmd-rm.c" "CMakeFiles/lpass.dir/cmd-rm.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-rm.c.o.d"
+  "/root/repo/cmd-share.c" "CMakeFiles/lpass.dir/cmd-share.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-share.c.o.d"
+  "/root/repo/cmd-show.c" "CMakeFiles/lpass.dir/cmd-show.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-show.c.o.d"
+  "/root/repo/cmd-status.c" "CMakeFiles/lpass.dir/cmd-status.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-status.c.o.d"
+  "/root/repo/cmd-sync.c" "CMakeFiles/lpass.dir/cmd-sync.c.o" "gcc" "CMakeFiles/lpass.dir/cmd-sync.c.o.d"
+  "/root/repo/cmd.c" "CMakeFiles/lpass.dir/cmd.c.o" "gcc" "CMakeFiles/lpass.dir/cmd.c.o.d"
+  "/root/repo/config.c" "CMakeFiles/lpass.dir/config.c.o" "gcc" "CMakeFiles/lpass.dir/config.c.o.d"
+  "/root/repo/edit.c" "CMakeFiles/lpass.dir/edit.c.o" "gcc" "CMakeFiles/lpass.dir/edit.c.o.d"
+  "/root/repo/endpoints-login.c" "CMakeFiles/lpass.dir/endpoints-login.c.o" "gcc" "CMakeFiles/lpass.dir/endpoints-login.c.o.d"
+  "/root/repo/endpoints-share.c" "CMakeFiles/lpass.dir/endpoints-share.c.o" "gcc" "CMakeFiles/lpass.dir/endpoints-share.c.o.d"
+  "/root/repo/endpoints.c" "CMakeFiles/lpass.dir/endpoints.c.o" "gcc" "CMakeFiles/lpass.dir/endpoints.c.o.d"
+  "/root/repo/feature-flag.c" "CMakeFiles/lpass.dir/feature-flag.c.o" "gcc" "CMakeFiles/lpass.dir/feature-flag.c.o.d"
+  "/root/repo/format.c" "CMakeFiles/lpass.dir/format.c.o" "gcc" "CMakeFiles/lpass.dir/format.c.o.d"
+  "/root/repo/http.c" "CMakeFiles/lpass.dir/http.c.o" "gcc" "CMakeFiles/lpass.dir/http.c.o.d"
+  "/root/repo/json-format.c" "CMakeFiles/lpass.dir/json-format.c.o" "gcc" "CMakeFiles/lpass.dir/json-format.c.o.d"
+  "/root/repo/kdf.c" "CMakeFiles/lpass.dir/kdf.c.o" "gcc" "CMakeFiles/lpass.dir/kdf.c.o.d"
+  "/root/repo/log.c" "CMakeFiles/lpass.dir/log.c.o" "gcc" "CMakeFiles/lpass.dir/log.c.o.d"
+  "/root/repo/lpass.c" "CMakeFiles/lpass.dir/lpass.c.o" "gcc" "CMakeFiles/lpass.dir/lpass.c.o.d"
+  "/root/repo/notes.c" "CMakeFiles/lpass.dir/notes.c.o" "gcc" "CMakeFiles/lpass.dir/notes.c.o.d"
+  "/root/repo/password.c" "CMakeFiles/lpass.dir/password.c.o" "gcc" "CMakeFiles/lpass.dir/password.c.o.d"
+  "/root/repo/pbkdf2.c" "CMakeFiles/lpass.dir/pbkdf2.c.o" "gcc" "CMakeFiles/lpass.dir/pbkdf2.c.o.d"
+  "/root/repo/process.c" "CMakeFiles/lpass.dir/process.c.o" "gcc" "CMakeFiles/lpass.dir/process.c.o.d"
+  "/root/repo/session.c" "CMakeFiles/lpass.dir/session.c.o" "gcc" "CMakeFiles/lpass.dir/session.c.o.d"
+  "/root/repo/terminal.c" "CMakeFiles/lpass.dir/terminal.c.o" "gcc" "CMakeFiles/lpass.dir/terminal.c.o.d"
+  "/root/repo/upload-queue.c" "CMakeFiles/lpass.dir/upload-queue.c.o" "gcc" "CMakeFiles/lpass.dir/upload-queue.c.o.d"
+  "/root/repo/util.c" "CMakeFiles/lpass.dir/util.c.o" "gcc" "CMakeFiles/lpass.dir/util.c.o.d"
+  "/root/repo/xml.c" "CMakeFiles/lpass.dir/xml.c.o" "gcc" "CMakeFiles/lpass.dir/xml.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
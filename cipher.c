@@ -391,6 +391,99 @@ char *encrypt_and_base64(const char *str, unsigned const char key[KDF_HASH_LEN])
 	return base64;
 }
 
+/*
+ * Base64 @len bytes to @out, which must have room for 4 * ceil(len / 3)
+ * characters and a nul.  Unlike base64() this writes no padding when
+ * @len is a multiple of 3, so consecutive blocks of such lengths can be
+ * joined into one string.
+ */
+size_t cipher_base64_block(const unsigned char *bytes, size_t len, char *out)
+{
+	return EVP_EncodeBlock((unsigned char *)out, bytes, len);
+}
+
+/*
+ * Encryption of data too large to hold in memory, producing the same
+ * "!IV|CIPHERTEXT" form that cipher_aes_decrypt_base64() reads.  The
+ * header is returned by cipher_aes_stream_init(); each call to update
+ * and final writes the next piece of the base64 ciphertext to @out,
+ * which must hold CIPHER_AES_STREAM_OUT_LEN(len) characters.
+ */
+char *cipher_aes_stream_init(struct cipher_aes_stream *stream,
+			     const unsigned char key[KDF_HASH_LEN])
+{
+	unsigned char iv[AES_BLOCK_SIZE];
+	_cleanup_free_ char *iv_base64 = NULL;
+	char *header;
+
+	memset(stream, 0, sizeof(*stream));
+	if (!RAND_bytes(iv, AES_BLOCK_SIZE))
+		die("Could not generate random bytes for CBC IV.");
+
+	stream->ctx = EVP_CIPHER_CTX_new();
+	if (!stream->ctx ||
+	    !EVP_EncryptInit_ex(stream->ctx, EVP_aes_256_cbc(), NULL, key, iv))
+		die("Failed to encrypt data.");
+
+	iv_base64 = base64(iv, AES_BLOCK_SIZE);
+	xasprintf(&header, "!%s|", iv_base64);
+	return header;
+}
+
+static unsigned char *cipher_aes_stream_buffer(struct cipher_aes_stream *stream,
+					       size_t len)
+{
+	len += sizeof(stream->carry) + AES_BLOCK_SIZE;
+	if (stream->buf_len < len) {
+		stream->buf = xrealloc(stream->buf, len);
+		stream->buf_len = len;
+	}
+	memcpy(stream->buf, stream->carry, stream->carry_len);
+	return stream->buf + stream->carry_len;
+}
+
+size_t cipher_aes_stream_update(struct cipher_aes_stream *stream,
+				const char *plaintext, size_t len, char *out)
+{
+	unsigned char *ctext;
+	size_t total, whole;
+	int out_len;
+
+	ctext = cipher_aes_stream_buffer(stream, len);
+	if (!EVP_EncryptUpdate(stream->ctx, ctext, &out_len,
+			       (const unsigned char *)plaintext, len))
+		die("Failed to encrypt data.");
+
+	/* base64 whole groups of three bytes, and carry the rest */
+	total = stream->carry_len + out_len;
+	whole = total - total % 3;
+	stream->carry_len = total - whole;
+	memcpy(stream->carry, stream->buf + whole, stream->carry_len);
+	return cipher_base64_block(stream->buf, whole, out);
+}
+
+size_t cipher_aes_stream_final(struct cipher_aes_stream *stream, char *out)
+{
+	unsigned char *ctext;
+	size_t len;
+	int out_len;
+
+	ctext = cipher_aes_stream_buffer(stream, 0);
+	if (!EVP_EncryptFinal_ex(stream->ctx, ctext, &out_len))
+		die("Failed to encrypt data.");
+
+	len = cipher_base64_block(stream->buf, stream->carry_len + out_len, out);
+	cipher_aes_stream_free(stream);
+	return len;
+}
+
+void cipher_aes_stream_free(struct cipher_aes_stream *stream)
+{
+	EVP_CIPHER_CTX_free(stream->ctx);
+	free(stream->buf);
+	memset(stream, 0, sizeof(*stream));
+}
+
 /*
  * Decrypt the LastPass sharing RSA private key.  The key has start_str
  * and end_str prepended / appended before encryption, and the result
@@ -4,6 +4,17 @@
 #include "kdf.h"
 #include "session.h"
 
+struct cipher_aes_stream {
+	void *ctx;
+	unsigned char *buf;
+	size_t buf_len;
+	unsigned char carry[2];
+	size_t carry_len;
+};
+
+/* output space needed by cipher_aes_stream_update() for @len bytes of input */
+#define CIPHER_AES_STREAM_OUT_LEN(len) ((((len) + 18) / 3 + 1) * 4 + 1)
+
 char *cipher_rsa_decrypt(const unsigned char *ciphertext, size_t len, const struct private_key *private_key);
 int cipher_rsa_encrypt_bytes(const unsigned char *plaintext,
 			     size_t in_len,
@@ -19,6 +30,11 @@ char *cipher_base64(const unsigned char *bytes, size_t len);
 size_t cipher_unbase64(const char *ciphertext, unsigned char **b64data);
 size_t unbase64(const char *ptext, unsigned char **b64data);
 char *encrypt_and_base64(const char *str, unsigned const char key[KDF_HASH_LEN]);
+size_t cipher_base64_block(const unsigned char *bytes, size_t len, char *out);
+char *cipher_aes_stream_init(struct cipher_aes_stream *stream, const unsigned char key[KDF_HASH_LEN]);
+size_t cipher_aes_stream_update(struct cipher_aes_stream *stream, const char *plaintext, size_t len, char *out);
+size_t cipher_aes_stream_final(struct cipher_aes_stream *stream, char *out);
+void cipher_aes_stream_free(struct cipher_aes_stream *stream);
 void cipher_decrypt_private_key(const char *key_hex, unsigned const char key[KDF_HASH_LEN], struct private_key *out_key);
 char *cipher_encrypt_private_key(struct private_key *private_key,
 				 unsigned const char key[KDF_HASH_LEN]);
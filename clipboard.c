@@ -35,71 +35,684 @@
  */
 
 #include "clipboard.h"
+#include "agent.h"
+#include "config.h"
+#include "process.h"
 #include "util.h"
 #include <unistd.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <pthread.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
 #include <sys/wait.h>
 #include <sys/types.h>
 
-static pid_t clipboard_process = 0;
-static int saved_stdout = -1; 
+#define CLIPBOARD_MISSING "Unable to copy contents to clipboard. Please make sure you have `wl-copy`, `xclip`, `xsel`, `pbcopy`, or `putclip` installed."
+
+/* how long reading the clipboard back may take */
+#define CLIPBOARD_PASTE_TIMEOUT_MS 2000
+
+/* how long a client of the clipboard owner may stall */
+#define CLIPBOARD_IO_TIMEOUT_SEC 1
+
+struct clipboard_backend {
+	const char *name;
+	char *argv[5];
+	char *paste_argv[5];
+	/* stays running while it holds the contents, if the backend can */
+	char *owner_argv[6];
+};
+
+/* in order of preference */
+static struct clipboard_backend backends[] = {
+	{ "wl-copy", { "wl-copy", NULL }, { "wl-paste", "--no-newline", NULL },
+		     { "wl-copy", "--foreground", NULL } },
+	{ "xclip", { "xclip", "-selection", "clipboard", "-in", NULL },
+		   { "xclip", "-selection", "clipboard", "-out", NULL },
+		   { "xclip", "-selection", "clipboard", "-in", "-quiet", NULL } },
+	{ "xsel", { "xsel", "--clipboard", "--input", NULL },
+		  { "xsel", "--clipboard", "--output", NULL },
+		  { "xsel", "--clipboard", "--input", "--nodetach", NULL } },
+	{ "pbcopy", { "pbcopy", NULL }, { "pbpaste", NULL }, { NULL } },
+	{ "putclip", { "putclip", "--dos", NULL }, { "getclip", NULL }, { NULL } },
+};
+
+/* what a clipboard command needs from the caller's session */
+static const char *clipboard_env[] = {
+	"PATH", "DISPLAY", "WAYLAND_DISPLAY", "XAUTHORITY", "XDG_RUNTIME_DIR"
+};
+
+struct clipboard_capture {
+	int fd;
+	char *buf;
+	size_t len;
+	size_t alloced;
+};
+
+/*
+ * A copy handed to a clipboard owner: a header, then meta_len bytes of
+ * clipboard_meta() and data_len bytes of data.
+ */
+struct clipboard_request {
+	uint32_t meta_len;
+	uint32_t data_len;
+	uint32_t clear_after;
+};
+
+/* the last copy a clipboard owner made, until it is cleared */
+struct clipboard_owner {
+	char *meta;
+	size_t meta_len;
+	char *data;
+	size_t data_len;
+	time_t deadline;
+	/* the backend still holding the contents, or 0 */
+	pid_t holder;
+};
+
+static struct clipboard_capture capture = { .fd = -1 };
+static pthread_t capture_thread;
+static unsigned int clear_after;
+static int saved_stdout = -1;
 static bool registered_closer = false;
 
+static bool in_path(const char *name)
+{
+	_cleanup_free_ char *path = xstrdup(getenv("PATH") ? getenv("PATH") : "/usr/bin:/bin");
+	_cleanup_free_ char *file = NULL;
+	char *dir, *saveptr = NULL;
+
+	for (dir = strtok_r(path, ":", &saveptr); dir; dir = strtok_r(NULL, ":", &saveptr)) {
+		free(file);
+		xasprintf(&file, "%s/%s", *dir ? dir : ".", name);
+		if (!access(file, X_OK))
+			return true;
+	}
+	return false;
+}
+
+/* the backend copy command argv runs, if it is one of ours */
+static struct clipboard_backend *find_backend(char **argv)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(backends); i++) {
+		if (!strcmp(argv[0], backends[i].name))
+			return &backends[i];
+	}
+	return NULL;
+}
+
+/*
+ * The command that copies its input to the clipboard.  The backend
+ * found to be installed is remembered, in memory and in the config
+ * directory, so that later copies run it straight away rather than
+ * trying each in turn.
+ */
+char **clipboard_command(void)
+{
+	static char *shell_argv[4];
+	static char **command;
+	_cleanup_free_ char *cached = NULL;
+	char *clipboard_command;
+	size_t i;
+
+	if (command)
+		return command;
+
+	clipboard_command = getenv("LPASS_CLIPBOARD_COMMAND");
+	if (clipboard_command) {
+		shell_argv[0] = getenv("SHELL") ? getenv("SHELL") : "/bin/sh";
+		shell_argv[1] = "-c";
+		shell_argv[2] = clipboard_command;
+		return command = shell_argv;
+	}
+
+	cached = config_read_string("clipboard");
+	for (i = 0; cached && i < ARRAY_SIZE(backends); i++) {
+		if (!strcmp(cached, backends[i].name) && in_path(backends[i].name))
+			return command = backends[i].argv;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(backends); i++) {
+		if (in_path(backends[i].name)) {
+			config_write_string("clipboard", backends[i].name);
+			return command = backends[i].argv;
+		}
+	}
+	die(CLIPBOARD_MISSING);
+}
+
+/*
+ * Run a clipboard command with data on its standard input.  Each of
+ * env, if given, is a NAME=VALUE to set for the command.
+ */
+static pid_t clipboard_spawn(char **argv, char **env, const char *data, size_t len)
+{
+	sig_t previous_handler;
+	int pipefd[2];
+	pid_t child;
+	ssize_t ret;
+	size_t done;
+
+	if (pipe(pipefd) < 0)
+		die_errno("pipe");
+	child = fork();
+	if (child == -1)
+		die_errno("fork");
+	if (!child) {
+		close(pipefd[1]);
+		dup2(pipefd[0], STDIN_FILENO);
+		close(pipefd[0]);
+		for (; env && *env; env++)
+			putenv(*env);
+		execvp(argv[0], argv);
+		die(CLIPBOARD_MISSING);
+	}
+	close(pipefd[0]);
+
+	previous_handler = signal(SIGPIPE, SIG_IGN);
+	for (done = 0; done < len; done += ret) {
+		ret = write(pipefd[1], data + done, len - done);
+		if (ret <= 0)
+			break;
+	}
+	signal(SIGPIPE, previous_handler);
+	close(pipefd[1]);
+	return child;
+}
+
+/*
+ * Read the clipboard with the counterpart of copy command argv.
+ * Returns NULL if it has none, as with LPASS_CLIPBOARD_COMMAND, or the
+ * clipboard could not be read in time.
+ */
+static char *clipboard_paste(char **argv, char **env, size_t *len)
+{
+	struct clipboard_backend *backend = find_backend(argv);
+	struct pollfd pfd;
+	char *buf = NULL;
+	size_t alloced = 0;
+	ssize_t ret;
+	int pipefd[2], devnull;
+	pid_t child;
+	bool complete = false;
+
+	if (!backend || pipe(pipefd) < 0)
+		return NULL;
+
+	child = fork();
+	if (child == -1) {
+		close(pipefd[0]);
+		close(pipefd[1]);
+		return NULL;
+	}
+	if (!child) {
+		close(pipefd[0]);
+		dup2(pipefd[1], STDOUT_FILENO);
+		close(pipefd[1]);
+		devnull = open("/dev/null", O_RDONLY);
+		if (devnull >= 0)
+			dup2(devnull, STDIN_FILENO);
+		for (; env && *env; env++)
+			putenv(*env);
+		execvp(backend->paste_argv[0], backend->paste_argv);
+		_exit(EXIT_FAILURE);
+	}
+	close(pipefd[1]);
+
+	*len = 0;
+	pfd.fd = pipefd[0];
+	pfd.events = POLLIN;
+	while (poll(&pfd, 1, CLIPBOARD_PASTE_TIMEOUT_MS) > 0) {
+		if (alloced - *len < 4096) {
+			alloced = alloced ? alloced * 2 : 8192;
+			buf = secure_resize(buf, *len, alloced);
+		}
+		ret = read(pipefd[0], buf + *len, alloced - *len);
+		if (ret <= 0) {
+			complete = ret == 0;
+			break;
+		}
+		*len += ret;
+	}
+	close(pipefd[0]);
+	if (!complete) {
+		kill(child, SIGKILL);
+		secure_clear(buf, *len);
+		free(buf);
+		buf = NULL;
+	}
+	waitpid(child, NULL, 0);
+	return buf;
+}
+
+static bool same_contents(const char *a, size_t a_len, const char *b, size_t b_len)
+{
+	/* some backends add or drop a final newline */
+	if (a_len && a[a_len - 1] == '\n')
+		a_len--;
+	if (b_len && b[b_len - 1] == '\n')
+		b_len--;
+	return a_len == b_len && !memcmp(a, b, a_len);
+}
+
+/*
+ * Empty the clipboard, unless something else has been copied since
+ * data was.  If the clipboard cannot be read back, it is emptied.
+ */
+static void clipboard_clear(char **argv, char **env, const char *data, size_t len)
+{
+	char *current;
+	size_t current_len;
+	bool changed;
+
+	current = clipboard_paste(argv, env, &current_len);
+	if (current) {
+		changed = !same_contents(current, current_len, data, len);
+		secure_clear(current, current_len);
+		free(current);
+		if (changed)
+			return;
+	}
+	clipboard_spawn(argv, env, "", 0);
+}
+
+/*
+ * Clear the clipboard seconds after the next copy, if it still holds
+ * what was copied.
+ */
+void clipboard_set_clear_after(unsigned int seconds)
+{
+	clear_after = seconds;
+}
+
+/*
+ * Describe copy command argv to a clipboard owner: its arguments, an
+ * empty string, then those of clipboard_env that are set, all NUL
+ * terminated.
+ */
+char *clipboard_meta(char **command, size_t *len)
+{
+	char *meta, *value;
+	size_t i;
+
+	*len = 0;
+	for (i = 0; command[i]; i++)
+		*len += strlen(command[i]) + 1;
+	++*len;
+	for (i = 0; i < ARRAY_SIZE(clipboard_env); i++) {
+		value = getenv(clipboard_env[i]);
+		if (value)
+			*len += strlen(clipboard_env[i]) + strlen(value) + 2;
+	}
+	meta = xcalloc(*len, 1);
+	*len = 0;
+	for (i = 0; command[i]; i++)
+		*len += sprintf(meta + *len, "%s", command[i]) + 1;
+	++*len;
+	for (i = 0; i < ARRAY_SIZE(clipboard_env); i++) {
+		value = getenv(clipboard_env[i]);
+		if (value)
+			*len += sprintf(meta + *len, "%s=%s", clipboard_env[i], value) + 1;
+	}
+	return meta;
+}
+
+static bool parse_meta(char *meta, size_t meta_len, char **argv, size_t argv_max,
+		       char **env, size_t env_max)
+{
+	char *p = meta, *end = meta + meta_len;
+	size_t i;
+
+	if (!meta_len || meta[meta_len - 1])
+		return false;
+	for (i = 0; p < end && *p; p += strlen(p) + 1) {
+		if (i == argv_max - 1)
+			return false;
+		argv[i++] = p;
+	}
+	argv[i] = NULL;
+	if (!i || p == end)
+		return false;
+	for (i = 0, ++p; p < end; p += strlen(p) + 1) {
+		if (i == env_max - 1)
+			return false;
+		env[i++] = p;
+	}
+	env[i] = NULL;
+	return true;
+}
+
+/* Hand a copy to the clipboard owner on fd. */
+bool clipboard_send(int fd, const char *meta, size_t meta_len,
+		    const char *data, size_t len, unsigned int clear_after)
+{
+	struct clipboard_request request = {
+		.meta_len = meta_len,
+		.data_len = len,
+		.clear_after = clear_after,
+	};
+
+	return send_all(fd, &request, sizeof(request)) &&
+	       send_all(fd, meta, meta_len) &&
+	       send_all(fd, data, len);
+}
+
+static void owner_drop(struct clipboard_owner *owner)
+{
+	free(owner->meta);
+	secure_clear(owner->data, owner->data_len);
+	free(owner->data);
+	owner->meta = owner->data = NULL;
+	owner->meta_len = owner->data_len = 0;
+	owner->deadline = 0;
+}
+
+/*
+ * Make the copy sent on fd.  A backend that can hold the contents in
+ * the foreground is left running with them, and replaces the one that
+ * held the last copy.  Returns false if no request could be read.
+ */
+static bool owner_copy(struct clipboard_owner *owner, int fd)
+{
+	char *argv[16], *env[ARRAY_SIZE(clipboard_env) + 1];
+	struct clipboard_request request;
+	struct clipboard_backend *backend;
+	pid_t previous = owner->holder;
+
+	if (!read_all(fd, &request, sizeof(request)) ||
+	    request.meta_len > CLIPBOARD_META_MAX ||
+	    request.data_len > CLIPBOARD_DATA_MAX)
+		return false;
+
+	owner_drop(owner);
+	owner->meta = xmalloc(request.meta_len + 1);
+	owner->meta_len = request.meta_len;
+	owner->data = xmalloc(request.data_len + 1);
+	owner->data_len = request.data_len;
+	if (!read_all(fd, owner->meta, owner->meta_len) ||
+	    !read_all(fd, owner->data, owner->data_len)) {
+		owner_drop(owner);
+		return false;
+	}
+	if (!parse_meta(owner->meta, owner->meta_len, argv, ARRAY_SIZE(argv),
+			env, ARRAY_SIZE(env))) {
+		owner_drop(owner);
+		return true;
+	}
+
+	backend = find_backend(argv);
+	if (backend && backend->owner_argv[0]) {
+		owner->holder = clipboard_spawn(backend->owner_argv, env,
+						owner->data, owner->data_len);
+	} else {
+		clipboard_spawn(argv, env, owner->data, owner->data_len);
+		owner->holder = 0;
+	}
+	if (previous)
+		kill(previous, SIGTERM);
+
+	if (request.clear_after)
+		owner->deadline = time(NULL) + request.clear_after;
+	else
+		owner_drop(owner);
+	return true;
+}
+
+/*
+ * Clear the copy whose time is up.  A backend still holding it has
+ * not been copied over, so stopping it empties the clipboard without
+ * running anything else.  Otherwise the clipboard is read back first.
+ */
+static void owner_clear(struct clipboard_owner *owner)
+{
+	char *argv[16], *env[ARRAY_SIZE(clipboard_env) + 1];
+
+	if (owner->holder) {
+		kill(owner->holder, SIGTERM);
+		owner->holder = 0;
+	} else if (parse_meta(owner->meta, owner->meta_len, argv, ARRAY_SIZE(argv),
+			      env, ARRAY_SIZE(env))) {
+		clipboard_clear(argv, env, owner->data, owner->data_len);
+	}
+	owner_drop(owner);
+}
+
+static void owner_serve(struct clipboard_owner *owner, int listenfd)
+{
+	struct timeval io_timeout = { .tv_sec = CLIPBOARD_IO_TIMEOUT_SEC };
+	char status;
+	int fd;
+
+	fd = accept(listenfd, NULL, NULL);
+	if (fd < 0)
+		return;
+	fcntl(fd, F_SETFL, 0);
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &io_timeout, sizeof(io_timeout));
+	setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &io_timeout, sizeof(io_timeout));
+	status = owner_copy(owner, fd);
+	IGNORE_RESULT(send_all(fd, &status, 1));
+	close(fd);
+}
+
+/*
+ * Act as a clipboard owner: make each copy sent on fd, and clear it
+ * once its time is up, unless it has been copied over.  One owner
+ * serves every copy, so the processes left behind stay the same
+ * however many copies are made: the owner, and the backend holding
+ * the last copy where the backend can.  Each copy still runs the
+ * backend afresh, as lpass cannot hold the contents itself without
+ * speaking the X11, Wayland or pasteboard protocols.
+ *
+ * Without path, fd is one end of a socket pair and the owner exits
+ * once the other end is closed and nothing is left to clear.  With
+ * path, fd listens there for one copy per connection, answered with a
+ * status byte; the first has been made before the owner starts.  Once
+ * nothing is left to clear, the owner removes path and exits.
+ */
+void clipboard_owner_run(int fd, const char *path)
+{
+	struct clipboard_owner owner = { 0 };
+	struct pollfd pfd = { .fd = fd, .events = POLLIN };
+	time_t now;
+	pid_t pid;
+	int timeout;
+
+	process_set_name("lpass [clipboard]");
+	if (path)
+		owner_serve(&owner, fd);
+
+	for (;;) {
+		while ((pid = waitpid(-1, NULL, WNOHANG)) > 0) {
+			if (pid == owner.holder)
+				owner.holder = 0;
+		}
+		now = time(NULL);
+		if (owner.deadline && now >= owner.deadline)
+			owner_clear(&owner);
+
+		if (!owner.deadline && path) {
+			/* serve anyone who found the socket before it went */
+			unlink(path);
+			path = NULL;
+			fcntl(fd, F_SETFL, O_NONBLOCK);
+			pfd.fd = -1;
+			while (poll(&(struct pollfd){ .fd = fd, .events = POLLIN }, 1, 0) > 0)
+				owner_serve(&owner, fd);
+			close(fd);
+			continue;
+		}
+		if (!owner.deadline && pfd.fd < 0)
+			break;
+
+		timeout = owner.deadline ? (owner.deadline - now) * 1000 : -1;
+		if (poll(&pfd, 1, timeout) <= 0)
+			continue;
+		if (path) {
+			owner_serve(&owner, fd);
+		} else if (!owner_copy(&owner, fd)) {
+			close(fd);
+			pfd.fd = -1;
+		}
+	}
+	_exit(EXIT_SUCCESS);
+}
+
+/*
+ * Without an agent, a copy that is to be cleared later goes to a
+ * clipboard owner listening on clipboard.sock, started here if none is
+ * running.  Returns false if none could be reached or started.
+ */
+static bool clipboard_owner_copy(char **command, const char *data, size_t len)
+{
+	_cleanup_free_ char *path = config_path("clipboard.sock");
+	_cleanup_free_ char *meta = NULL;
+	struct sockaddr_un sa = { .sun_family = AF_UNIX };
+	size_t meta_len;
+	int fd, listenfd = -1, devnull;
+	mode_t mask;
+	pid_t child;
+	char status = 0;
+
+	if (strlen(path) >= sizeof(sa.sun_path))
+		return false;
+	strlcpy(sa.sun_path, path, sizeof(sa.sun_path));
+	meta = clipboard_meta(command, &meta_len);
+
+	fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		return false;
+	if (connect(fd, (struct sockaddr *)&sa, SUN_LEN(&sa)) < 0) {
+		/* none running: listen, and connect before it starts */
+		unlink(path);
+		listenfd = socket(AF_UNIX, SOCK_STREAM, 0);
+		mask = umask(0077);
+		if (listenfd < 0 ||
+		    bind(listenfd, (struct sockaddr *)&sa, SUN_LEN(&sa)) < 0 ||
+		    listen(listenfd, 16) < 0 ||
+		    connect(fd, (struct sockaddr *)&sa, SUN_LEN(&sa)) < 0) {
+			umask(mask);
+			if (listenfd >= 0)
+				close(listenfd);
+			close(fd);
+			unlink(path);
+			return false;
+		}
+		umask(mask);
+
+		child = fork();
+		if (child == -1)
+			die_errno("fork");
+		if (!child) {
+			setsid();
+			child = fork();
+			if (child < 0)
+				_exit(EXIT_FAILURE);
+			if (child)
+				_exit(EXIT_SUCCESS);
+			close(fd);
+			devnull = open("/dev/null", O_RDWR);
+			if (devnull >= 0) {
+				dup2(devnull, STDIN_FILENO);
+				dup2(devnull, STDOUT_FILENO);
+				dup2(devnull, STDERR_FILENO);
+				close(devnull);
+			}
+			clipboard_owner_run(listenfd, path);
+		}
+		close(listenfd);
+		waitpid(child, NULL, 0);
+	}
+
+	if (clipboard_send(fd, meta, meta_len, data, len, clear_after))
+		IGNORE_RESULT(read_all(fd, &status, 1));
+	close(fd);
+	return status;
+}
+
+static void *capture_output(void *arg)
+{
+	struct clipboard_capture *capture = arg;
+	ssize_t ret;
+
+	for (;;) {
+		if (capture->alloced - capture->len < 4096) {
+			capture->alloced = capture->alloced ? capture->alloced * 2 : 8192;
+			capture->buf = secure_resize(capture->buf, capture->len, capture->alloced);
+		}
+		ret = read(capture->fd, capture->buf + capture->len,
+			   capture->alloced - capture->len);
+		if (ret <= 0)
+			break;
+		capture->len += ret;
+	}
+	close(capture->fd);
+	return NULL;
+}
+
 void clipboard_close(void)
 {
-	if (!clipboard_process || saved_stdout < 0)
+	char **command;
+	pid_t child;
+
+	if (saved_stdout < 0)
 		return;
 
 	fflush(stdout);
 	dup2(saved_stdout, STDOUT_FILENO);
 	close(saved_stdout);
-	waitpid(clipboard_process, NULL, 0);
-	clipboard_process = 0;
 	saved_stdout = -1;
-}
-
-void exec_command(char *command) {
-	char *shell = getenv("SHELL");
+	pthread_join(capture_thread, NULL);
 
-	if (!shell) {
-		shell = "/bin/sh";
+	command = clipboard_command();
+	if (!agent_clipboard_copy(command, capture.buf, capture.len, clear_after) &&
+	    !(clear_after && clipboard_owner_copy(command, capture.buf, capture.len))) {
+		if (clear_after)
+			warn("Unable to clear the clipboard later.");
+		child = clipboard_spawn(command, NULL, capture.buf, capture.len);
+		waitpid(child, NULL, 0);
 	}
 
-	execlp(shell, shell, "-c", command, NULL);
+	secure_clear(capture.buf, capture.len);
+	free(capture.buf);
+	capture.buf = NULL;
+	capture.len = capture.alloced = 0;
 }
 
+/*
+ * Send everything printed to stdout from now on to the clipboard, once
+ * the command is done.  The output is collected here, and handed to the
+ * agent's clipboard owner if an agent is running.  Without one, a copy
+ * to be cleared later goes to an owner of its own; any other is made by
+ * this process.
+ */
 void clipboard_open(void)
 {
 	int pipefd[2];
 
-	if (clipboard_process > 0)
+	if (saved_stdout >= 0)
 		return;
 
+	/* find the backend while error messages still reach the terminal */
+	clipboard_command();
+
 	if (pipe(pipefd) < 0)
 		die_errno("pipe");
+	fflush(stdout);
 	saved_stdout = dup(STDOUT_FILENO);
 	if (saved_stdout < 0)
 		die_errno("dup");
-	clipboard_process = fork();
-	if (clipboard_process == -1)
-		die_errno("fork");
-	if (!clipboard_process) {
-		close(pipefd[1]);
-		dup2(pipefd[0], STDIN_FILENO);
-		close(pipefd[0]);
-		char *clipboard_command = getenv("LPASS_CLIPBOARD_COMMAND");
-		if (clipboard_command) {
-			exec_command(clipboard_command);
-			die("Unable to copy contents to clipboard. Please make sure you have `wl-clip`, `xclip`, `xsel`, `pbcopy`, or `putclip` installed.");
-		} else {
-			execlp("wl-copy", "wl-copy", NULL);
-			execlp("xclip", "xclip", "-selection", "clipboard", "-in", NULL);
-			execlp("xsel", "xsel", "--clipboard", "--input", NULL);
-			execlp("pbcopy", "pbcopy", NULL);
-			execlp("putclip", "putclip", "--dos", NULL);
-			die("Unable to copy contents to clipboard. Please make sure you have `xclip`, `xsel`, `pbcopy`, or `putclip` installed.");
-		}
-	}
-	close(pipefd[0]);
+	capture.fd = pipefd[0];
+	if (pthread_create(&capture_thread, NULL, capture_output, &capture))
+		die("Unable to start clipboard copy.");
 	dup2(pipefd[1], STDOUT_FILENO);
 	close(pipefd[1]);
 
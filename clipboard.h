@@ -1,6 +1,19 @@
 #ifndef CLIPBOARD_H
 #define CLIPBOARD_H
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#define CLIPBOARD_META_MAX 4096
+#define CLIPBOARD_DATA_MAX (16 * 1024 * 1024)
+
+char **clipboard_command(void);
+char *clipboard_meta(char **command, size_t *len);
+bool clipboard_send(int fd, const char *meta, size_t meta_len,
+		    const char *data, size_t len, unsigned int clear_after);
+void clipboard_owner_run(int fd, const char *path) __attribute__((noreturn));
+void clipboard_set_clear_after(unsigned int seconds);
 void clipboard_open(void);
 void clipboard_close(void);
 
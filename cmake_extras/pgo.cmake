@@ -0,0 +1,127 @@
+################ Profile-guided optimisation build ###############
+# Used by the "pgo" target: builds an instrumented lpass, runs the
+# training workload, rebuilds with the profile and LTO, and compares
+# the result against a plain release build.
+#
+# Expects SOURCE_DIR, BINARY_DIR, C_COMPILER and GENERATOR.
+#################################################################
+
+set(BASELINE_DIR "${BINARY_DIR}/pgo-baseline")
+set(PGO_DIR "${BINARY_DIR}/pgo")
+set(PROFILE_DIR "${PGO_DIR}/profile")
+set(TRAIN "${SOURCE_DIR}/test/perf/pgo-train")
+
+function(run_step description)
+    message(STATUS "PGO: ${description}")
+    execute_process(COMMAND ${ARGN} RESULT_VARIABLE retval)
+    if(retval)
+        message(FATAL_ERROR "PGO: ${description} failed")
+    endif()
+endfunction()
+
+function(configure dir)
+    file(MAKE_DIRECTORY ${dir})
+    run_step("configuring ${dir}"
+        ${CMAKE_COMMAND} -G ${GENERATOR}
+            -DCMAKE_C_COMPILER=${C_COMPILER}
+            -DCMAKE_BUILD_TYPE=Release
+            ${ARGN}
+            -S ${SOURCE_DIR} -B ${dir})
+endfunction()
+
+function(build dir)
+    foreach(target ${ARGN})
+        run_step("building ${target} in ${dir}"
+            ${CMAKE_COMMAND} --build ${dir} --target ${target})
+    endforeach()
+endfunction()
+
+# Run the training workload once with timing; sets ${result} to
+# "wall_us;user_us;sys_us".
+function(measure lpass result)
+    execute_process(
+        COMMAND ${CMAKE_COMMAND} -E env
+            TEST_LPASS=${BASELINE_DIR}/lpass-test
+            PERF_MEASURE=${BASELINE_DIR}/lpass-perf-measure
+            ${TRAIN} ${lpass}
+        OUTPUT_VARIABLE out
+        OUTPUT_STRIP_TRAILING_WHITESPACE
+        RESULT_VARIABLE retval)
+    if(retval)
+        message(FATAL_ERROR "PGO: timing ${lpass} failed")
+    endif()
+    string(REPLACE " " ";" out "${out}")
+    set(${result} ${out} PARENT_SCOPE)
+endfunction()
+
+# Keep the per-metric minimum of the list in ${best} and ${new}
+function(keep_best best new)
+    if(NOT ${best})
+        set(${best} ${new} PARENT_SCOPE)
+        return()
+    endif()
+    set(result "")
+    foreach(n 0 1 2)
+        list(GET ${best} ${n} old)
+        list(GET new ${n} cur)
+        if(cur LESS old)
+            list(APPEND result ${cur})
+        else()
+            list(APPEND result ${old})
+        endif()
+    endforeach()
+    set(${best} ${result} PARENT_SCOPE)
+endfunction()
+
+# 1. plain release build to compare against; it also provides the mock
+#    server build used to create the training vault
+configure(${BASELINE_DIR})
+build(${BASELINE_DIR} lpass lpass-test lpass-perf-measure)
+
+# 2. instrumented build, trained from scratch
+file(REMOVE_RECURSE ${PROFILE_DIR})
+configure(${PGO_DIR} -DPGO=generate -DLTO=OFF -DPGO_PROFILE_DIR=${PROFILE_DIR})
+build(${PGO_DIR} lpass)
+run_step("running training workload"
+    ${CMAKE_COMMAND} -E env TEST_LPASS=${BASELINE_DIR}/lpass-test
+        ${TRAIN} ${PGO_DIR}/lpass)
+
+# clang writes raw profiles which have to be merged first
+file(GLOB PROFRAW ${PROFILE_DIR}/*.profraw)
+if(PROFRAW)
+    find_program(LLVM_PROFDATA NAMES llvm-profdata)
+    if(NOT LLVM_PROFDATA)
+        message(FATAL_ERROR "PGO: llvm-profdata is needed to merge clang profiles")
+    endif()
+    run_step("merging profiles"
+        ${LLVM_PROFDATA} merge -output=${PROFILE_DIR}/default.profdata ${PROFRAW})
+endif()
+
+# 3. optimised build in the same tree, so that gcc finds its profiles
+configure(${PGO_DIR} -DPGO=use -DLTO=ON -DPGO_PROFILE_DIR=${PROFILE_DIR})
+build(${PGO_DIR} lpass)
+
+# 4. report, interleaving the runs so that both see the same conditions
+set(base "")
+set(opt "")
+foreach(run 1 2 3)
+    measure(${BASELINE_DIR}/lpass result)
+    keep_best(base "${result}")
+    measure(${PGO_DIR}/lpass result)
+    keep_best(opt "${result}")
+endforeach()
+set(i 0)
+foreach(metric "wall" "user" "sys")
+    list(GET base ${i} b)
+    list(GET opt ${i} o)
+    math(EXPR b_ms "${b} / 1000")
+    math(EXPR o_ms "${o} / 1000")
+    if(b GREATER 0)
+        math(EXPR pct "(${b} - ${o}) * 100 / ${b}")
+    else()
+        set(pct 0)
+    endif()
+    message(STATUS "PGO: ${metric} time ${b_ms} ms -> ${o_ms} ms (speedup ${pct}%)")
+    math(EXPR i "${i} + 1")
+endforeach()
+message(STATUS "PGO: optimised binary is ${PGO_DIR}/lpass")
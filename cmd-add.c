@@ -60,6 +60,7 @@ int cmd_add(int argc, char **argv)
 		{"notes", no_argument, NULL, 'O'},
 		{"app", no_argument, NULL, 'a'},
 		{"non-interactive", no_argument, NULL, 'X'},
+		{"batch", no_argument, NULL, 'B'},
 		{"note-type", required_argument, NULL, 'T'},
 		{"color", required_argument, NULL, 'C'},
 		{0, 0, 0, 0}
@@ -69,6 +70,7 @@ int cmd_add(int argc, char **argv)
 	_cleanup_free_ char *field = NULL;
 	char *name;
 	bool non_interactive = false;
+	bool batch = false;
 	enum blobsync sync = BLOB_SYNC_AUTO;
 	enum edit_choice choice = EDIT_ANY;
 	enum note_type note_type = NOTE_TYPE_NONE;
@@ -104,6 +106,9 @@ int cmd_add(int argc, char **argv)
 			case 'X':
 				non_interactive = true;
 				break;
+			case 'B':
+				batch = true;
+				break;
 			case 'a':
 				is_app = true;
 				break;
@@ -121,6 +126,13 @@ int cmd_add(int argc, char **argv)
 	}
 	#undef ensure_choice
 
+	if (batch) {
+		if (argc != optind || choice != EDIT_ANY || is_app)
+			die_usage(cmd_add_usage);
+		init_all(sync, key, &session, &blob);
+		return add_new_accounts(session, blob, sync, stdin, note_type, key);
+	}
+
 	if (argc - optind != 1)
 		die_usage(cmd_add_usage);
 	if (choice == EDIT_NONE)
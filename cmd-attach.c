@@ -0,0 +1,149 @@
+/*
+ * command for adding attachments to vault entries
+ *
+ * Copyright (C) 2014-2024 LastPass.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ *
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ *
+ * See LICENSE.OpenSSL for more details regarding this exception.
+ */
+#include "cmd.h"
+#include "util.h"
+#include "config.h"
+#include "terminal.h"
+#include "kdf.h"
+#include "blob.h"
+#include "endpoints.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+static double elapsed_since(struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start->tv_sec) +
+	       (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static int attach_add(enum blobsync sync, const char *mimetype,
+		      const char *name, const char *path)
+{
+	unsigned char key[KDF_HASH_LEN];
+	struct session *session = NULL;
+	struct blob *blob = NULL;
+	_cleanup_fclose_ FILE *fp = NULL;
+	struct account *found;
+	struct timespec start;
+	const char *filename;
+	size_t sent = 0;
+	double seconds;
+	int ret;
+
+	fp = fopen(path, "rb");
+	if (!fp)
+		die_errno("fopen(%s)", path);
+	filename = strrchr(path, '/');
+	filename = filename ? filename + 1 : path;
+
+	init_all(sync, key, &session, &blob);
+
+	found = find_unique_account(blob, name);
+	if (!found)
+		die("Could not find specified account '%s'.", name);
+	if (!strcmp(found->id, "0"))
+		die("%s has not been uploaded yet. Run lpass sync first.", found->fullname);
+	if (found->share && found->share->readonly)
+		die("%s is a readonly shared entry from %s. It cannot have attachments added.", found->fullname, found->share->name);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	ret = lastpass_upload_attachment(session, key, found, filename,
+					 mimetype, fp, &sent);
+	seconds = elapsed_since(&start);
+	if (ret == -EIO)
+		die_errno("Unable to read %s", path);
+	if (ret == -EINTR)
+		die("Upload of %s interrupted.", path);
+	if (ret)
+		die("Could not upload attachment to %s.", found->fullname);
+
+	/*
+	 * The first upload to an entry generates its attach key; keep it
+	 * so the next upload reuses it instead of orphaning this one.
+	 */
+	blob_save(blob, key, &session->feature_flag);
+
+	terminal_fprintf(stderr, TERMINAL_FG_GREEN "Uploaded %zu bytes to \"%s\" in %.2f s (%.1f MiB/s)\n" TERMINAL_RESET,
+			 sent, filename, seconds,
+			 seconds > 0 ? sent / seconds / (1024 * 1024) : 0);
+
+	session_free(session);
+	blob_free(blob);
+	return 0;
+}
+
+int cmd_attach(int argc, char **argv)
+{
+	static struct option long_options[] = {
+		{"sync", required_argument, NULL, 'S'},
+		{"color", required_argument, NULL, 'C'},
+		{"mime-type", required_argument, NULL, 'm'},
+		{0, 0, 0, 0}
+	};
+	int option;
+	int option_index;
+	enum blobsync sync = BLOB_SYNC_AUTO;
+	const char *mimetype = "application/octet-stream";
+
+	while ((option = getopt_long(argc, argv, "", long_options, &option_index)) != -1) {
+		switch (option) {
+			case 'S':
+				sync = parse_sync_string(optarg);
+				break;
+			case 'C':
+				terminal_set_color_mode(
+					parse_color_mode_string(optarg));
+				break;
+			case 'm':
+				mimetype = optarg;
+				break;
+			case '?':
+			default:
+				die_usage(cmd_attach_usage);
+		}
+	}
+
+	if (argc - optind != 3 || strcmp(argv[optind], "add"))
+		die_usage(cmd_attach_usage);
+
+	return attach_add(sync, mimetype, argv[optind + 1], argv[optind + 2]);
+}
@@ -40,9 +40,222 @@
 #include "kdf.h"
 #include "blob.h"
 #include "endpoints.h"
+#include "upload-queue.h"
 #include <getopt.h>
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
+
+struct template {
+	char **columns;
+	size_t n_columns;
+};
+
+static struct account *copy_account(struct account *found, unsigned const char key[KDF_HASH_LEN],
+				    const struct feature_flag *feature_flag)
+{
+	struct account *new;
+	struct field *field, *copy_field;
+
+	new = new_account();
+	new->share = found->share;
+	new->id = xstrdup("0");
+	account_set_name(new, xstrdup(found->name), key);
+	account_set_group(new, xstrdup(found->group), key);
+	account_set_username(new, xstrdup(found->username), key);
+	account_set_password(new, xstrdup(found->password), key);
+	account_set_note(new, xstrdup(found->note), key);
+	new->fullname = xstrdup(found->fullname);
+	account_set_url(new, xstrdup(found->url), key, feature_flag);
+	new->pwprotect = found->pwprotect;
+
+	list_for_each_entry(field, &found->field_head, list) {
+		copy_field = new0(struct field, 1);
+		copy_field->type = xstrdup(field->type);
+		copy_field->name = xstrdup(field->name);
+		field_set_value(new, copy_field, xstrdup(field->value), key);
+		copy_field->checked = field->checked;
+		list_add_tail(&copy_field->list, &new->field_head);
+	}
+	return new;
+}
+
+/*
+ * Undo the escapes a TSV cell may use for what it cannot hold: \t, \n
+ * and \\.
+ */
+static char *unescape_cell(const char *cell)
+{
+	char *value = xstrdup(cell), *out = value;
+
+	for (; *cell; cell++) {
+		if (*cell == '\\' && cell[1]) {
+			cell++;
+			if (*cell == 't')
+				*out++ = '\t';
+			else if (*cell == 'n')
+				*out++ = '\n';
+			else
+				*out++ = *cell;
+		} else
+			*out++ = *cell;
+	}
+	*out = '\0';
+	return value;
+}
+
+/* Split a TSV line into at most max cells, returning how many there are. */
+static size_t split_line(char *line, char **cells, size_t max)
+{
+	size_t len = strlen(line), n = 0;
+	char *cell;
+
+	while (len && (line[len - 1] == '\n' || line[len - 1] == '\r'))
+		line[--len] = '\0';
+	while ((cell = strsep(&line, "\t"))) {
+		if (n == max)
+			return max + 1;
+		cells[n++] = cell;
+	}
+	return n;
+}
+
+static void set_column(struct account *account, bool is_note, const char *column, const char *cell,
+		       unsigned const char key[KDF_HASH_LEN], const struct feature_flag *feature_flag)
+{
+	struct field *field;
+	char *value = unescape_cell(cell);
+
+	if (!strcmp(column, "name")) {
+		account_set_fullname(account, value, key);
+	} else if (!strcmp(column, "username")) {
+		account_set_username(account, value, key);
+	} else if (!strcmp(column, "password")) {
+		account_set_password(account, value, key);
+	} else if (!strcmp(column, "url")) {
+		account_set_url(account, value, key, feature_flag);
+	} else if (!strcmp(column, "notes")) {
+		account_set_note(account, value, key);
+	} else {
+		list_for_each_entry(field, &account->field_head, list) {
+			if (!strcmp(field->name, column)) {
+				field_set_value(account, field, value, key);
+				return;
+			}
+		}
+		if (!is_note)
+			die("%s has no field '%s'.", account->fullname, column);
+
+		field = new0(struct field, 1);
+		field->name = xstrdup(column);
+		field->type = xstrdup("text");
+		field_set_value(account, field, value, key);
+		list_add_tail(&field->list, &account->field_head);
+	}
+}
+
+/*
+ * Fill in a copy from a row of substitutions, and a new password if
+ * one is to be generated.  The fields of a secure note are set in its
+ * expansion, and folded back into the note.
+ */
+static void fill_copy(struct account *copy, struct template *template, char **cells,
+		      const char *password, unsigned const char key[KDF_HASH_LEN], const struct feature_flag *feature_flag)
+{
+	struct account *expansion, *collapsed;
+	struct account *account = copy;
+	size_t i;
+
+	expansion = notes_expand(copy);
+	if (expansion)
+		account = expansion;
+
+	if (password)
+		account_set_password(account, xstrdup(password), key);
+	for (i = 0; cells && i < template->n_columns; i++)
+		set_column(account, expansion != NULL, template->columns[i], cells[i],
+			   key, feature_flag);
+
+	if (expansion) {
+		collapsed = notes_collapse(expansion);
+		account_free(expansion);
+		account_set_note(copy, xstrdup(collapsed->note), key);
+		account_set_fullname(copy, xstrdup(collapsed->fullname), key);
+		account_free(collapsed);
+	}
+}
+
+static void read_template_header(FILE *fp, const char *path, struct template *template)
+{
+	_cleanup_free_ char *line = NULL;
+	size_t alloced = 0, i;
+	char *cells[64];
+
+	if (getline(&line, &alloced, fp) < 0)
+		die("%s: missing header line", path);
+	template->n_columns = split_line(line, cells, ARRAY_SIZE(cells));
+	if (template->n_columns > ARRAY_SIZE(cells))
+		die("%s: too many columns", path);
+
+	template->columns = xcalloc(template->n_columns, sizeof(*template->columns));
+	for (i = 0; i < template->n_columns; i++) {
+		if (!*cells[i])
+			die("%s: empty column name", path);
+		template->columns[i] = xstrdup(cells[i]);
+	}
+}
+
+/*
+ * Make the copies of found, either count of them, or one for each row
+ * of the template read from fp.
+ */
+static size_t make_copies(struct blob *blob, struct account *found, struct template *template,
+			  FILE *fp, const char *path, unsigned long count, unsigned long length,
+			  bool no_symbols, unsigned const char key[KDF_HASH_LEN],
+			  const struct feature_flag *feature_flag, struct list_head *copies)
+{
+	_cleanup_free_ char *line = NULL;
+	_cleanup_free_ char **cells = NULL;
+	char *password = NULL;
+	size_t alloced = 0, made = 0, lineno = 1;
+	struct account *copy;
+
+	if (fp)
+		cells = xcalloc(template->n_columns, sizeof(*cells));
+
+	for (;;) {
+		if (fp) {
+			if (getline(&line, &alloced, fp) < 0)
+				break;
+			lineno++;
+			if (!strcmp(line, "\n") || !strcmp(line, "\r\n"))
+				continue;
+			if (split_line(line, cells, template->n_columns) != template->n_columns)
+				die("%s:%zu: expected %zu columns", path, lineno, template->n_columns);
+		} else if (made == count)
+			break;
+
+		if (length)
+			password = generate_password(length, no_symbols);
+		copy = copy_account(found, key, feature_flag);
+		fill_copy(copy, template, fp ? cells : NULL, password, key, feature_flag);
+		free(password);
+		password = NULL;
+
+		account_assign_share(blob, copy, key, feature_flag);
+		if (copy->share && copy->share->readonly)
+			die("%s is in a readonly shared folder. It cannot be created.", copy->fullname);
+		list_add_tail(&copy->list, copies);
+		made++;
+	}
+	return made;
+}
+
+/* Whether uploadaccounts can carry all of an account. */
+static bool can_upload(struct account *account)
+{
+	return !account->share && !account->pwprotect && list_empty(&account->field_head);
+}
 
 int cmd_duplicate(int argc, char **argv)
 {
@@ -51,21 +264,48 @@ int cmd_duplicate(int argc, char **argv)
 	struct blob *blob = NULL;
 	static struct option long_options[] = {
 		{"sync", required_argument, NULL, 'S'},
+		{"count", required_argument, NULL, 'n'},
+		{"template", required_argument, NULL, 't'},
+		{"generate", required_argument, NULL, 'g'},
+		{"no-symbols", no_argument, NULL, 'X'},
 		{"color", required_argument, NULL, 'C'},
 		{0, 0, 0, 0}
 	};
 	int option;
 	int option_index;
-	char *name;
+	char *name, *end;
 	enum blobsync sync = BLOB_SYNC_AUTO;
-	struct account *found, *new;
-	struct field *field, *copy_field;
+	struct account *found, *copy, *tmp;
+	struct template template = { 0 };
+	_cleanup_fclose_ FILE *fp = NULL;
+	char *template_path = NULL;
+	unsigned long count = 1, length = 0;
+	bool no_symbols = false, batch = true;
+	struct list_head copies;
+	size_t made, failed = 0, i;
+	int ret;
 
 	while ((option = getopt_long(argc, argv, "", long_options, &option_index)) != -1) {
 		switch (option) {
 			case 'S':
 				sync = parse_sync_string(optarg);
 				break;
+			case 'n':
+				count = strtoul(optarg, &end, 10);
+				if (!*optarg || *end || !count)
+					die_usage(cmd_duplicate_usage);
+				break;
+			case 't':
+				template_path = optarg;
+				break;
+			case 'g':
+				length = strtoul(optarg, &end, 10);
+				if (!*optarg || *end || !length)
+					die_usage(cmd_duplicate_usage);
+				break;
+			case 'X':
+				no_symbols = true;
+				break;
 			case 'C':
 				terminal_set_color_mode(
 					parse_color_mode_string(optarg));
@@ -76,41 +316,64 @@ int cmd_duplicate(int argc, char **argv)
 		}
 	}
 
-	if (argc - optind != 1)
+	if (argc - optind != 1 || (template_path && count != 1))
 		die_usage(cmd_duplicate_usage);
 	name = argv[optind];
 
+	if (template_path) {
+		fp = strcmp(template_path, "-") ? fopen(template_path, "r") : stdin;
+		if (!fp)
+			die_errno("fopen(%s)", template_path);
+		read_template_header(fp, template_path, &template);
+	}
+
 	init_all(sync, key, &session, &blob);
 
 	found = find_unique_account(blob, name);
 	if (!found)
 		die("Could not find specified account '%s'.", name);
 
-	new = new_account();
-	new->share = found->share;
-	new->id = xstrdup("0");
-	account_set_name(new, xstrdup(found->name), key);
-	account_set_group(new, xstrdup(found->group), key);
-	account_set_username(new, xstrdup(found->username), key);
-	account_set_password(new, xstrdup(found->password), key);
-	account_set_note(new, xstrdup(found->note), key);
-	new->fullname = xstrdup(found->fullname);
-	account_set_url(new, xstrdup(found->url), key, &session->feature_flag);
-	new->pwprotect = found->pwprotect;
+	INIT_LIST_HEAD(&copies);
+	made = make_copies(blob, found, &template, fp, template_path, count, length,
+			   no_symbols, key, &session->feature_flag, &copies);
+	for (i = 0; i < template.n_columns; i++)
+		free(template.columns[i]);
+	free(template.columns);
 
-	list_for_each_entry(field, &found->field_head, list) {
-		copy_field = new0(struct field, 1);
-		copy_field->type = xstrdup(field->type);
-		copy_field->name = xstrdup(field->name);
-		field_set_value(found, copy_field, xstrdup(field->value), key);
-		copy_field->checked = field->checked;
-		list_add_tail(&copy_field->list, &new->field_head);
-	}
+	/*
+	 * Many copies go up in uploadaccounts batches, if that can carry
+	 * them; the rest are queued one by one.  The server gives batched
+	 * copies their ids, so the vault is fetched again afterwards.
+	 */
+	list_for_each_entry(copy, &copies, list)
+		batch = batch && can_upload(copy);
+	if (made > 1 && batch && sync != BLOB_SYNC_NO) {
+		list_for_each_entry(copy, &copies, list)
+			account_encrypt(copy, key, &session->feature_flag);
+		ret = lastpass_upload(session, &copies, NULL);
 
-	list_add(&new->list, &blob->account_head);
+		blob_free(blob);
+		blob = lastpass_get_blob(session, key, false);
+		if (!blob)
+			config_unlink("blob");
 
-	lastpass_update_account(sync, key, session, new, blob);
-	blob_save(blob, key, &session->feature_flag);
+		if (ret) {
+			list_for_each_entry(copy, &copies, list) {
+				fprintf(stderr, "Not created: %s\n", copy->fullname);
+				failed++;
+			}
+			die("Creating %zu of %zu copies failed (%d)", failed, made, ret);
+		}
+	} else {
+		list_for_each_entry_safe(copy, tmp, &copies, list) {
+			list_del(&copy->list);
+			list_add(&copy->list, &blob->account_head);
+			lastpass_update_account(BLOB_SYNC_NO, key, session, copy, blob);
+		}
+		blob_save(blob, key, &session->feature_flag);
+		if (sync != BLOB_SYNC_NO)
+			upload_queue_ensure_running(key, session);
+	}
 
 	session_free(session);
 	blob_free(blob);
@@ -44,10 +44,6 @@
 #include <stdio.h>
 #include <string.h>
 
-static char chars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890`~!@#$%^&*()-_=+[{]}\\|;:'\",<.>/?";
-#define ALL_CHARS_LEN (sizeof(chars) - 1)
-#define NICE_CHARS_LEN 62
-
 int cmd_generate(int argc, char **argv)
 {
 	unsigned char key[KDF_HASH_LEN];
@@ -106,9 +102,7 @@ int cmd_generate(int argc, char **argv)
 
 	init_all(sync, key, &session, &blob);
 
-	password = xcalloc(length + 1, 1);
-	for (size_t i = 0; i < length; ++i)
-		password[i] = chars[range_rand(0, no_symbols ? NICE_CHARS_LEN : ALL_CHARS_LEN)];
+	password = generate_password(length, no_symbols);
 
 	found = find_unique_account(blob, name);
 	if (found) {
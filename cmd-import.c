@@ -404,15 +404,23 @@ int cmd_import(int argc, char **argv)
 		csv_dedupe_accounts(&blob->account_head, &accounts);
 
 	list_for_each_entry(account, &accounts, list) {
+		account_encrypt(account, key, &session->feature_flag);
 		new_count++;
 	};
 
 	if (count - new_count)
 		printf("Removed %d duplicate accounts\n", count - new_count);
 
-	ret = lastpass_upload(session, &accounts);
-	if (ret)
-		die("Import failed (%d)\n", ret);
+	ret = lastpass_upload(session, &accounts, NULL);
+	if (ret) {
+		count = 0;
+		list_for_each_entry(account, &accounts, list) {
+			fprintf(stderr, "Not imported: %s%s%s\n", account->group,
+				*account->group ? "/" : "", account->name);
+			count++;
+		}
+		die("Import of %d of %d accounts failed (%d)\n", count, new_count, ret);
+	}
 
 	session_free(session);
 	blob_free(blob);
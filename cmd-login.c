@@ -44,7 +44,64 @@
 #include "config.h"
 #include "agent.h"
 #include "terminal.h"
+#include "http.h"
+#include "log.h"
 #include <getopt.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+static bool detached;
+
+/*
+ * With --background, the wait for an out-of-band approval is left to a
+ * daemonized child, which saves the session once the login is approved,
+ * while the command itself returns.  The parent only waits for login.pid
+ * to be written, so that commands run right after it see the pending
+ * login and wait for it.
+ */
+static void login_detach(const char *oob_name)
+{
+	_cleanup_free_ char *pid = NULL;
+	int fds[2];
+	int null;
+	char c;
+	pid_t child;
+
+	if (pipe(fds) < 0)
+		die_errno("pipe");
+
+	child = fork();
+	if (child < 0)
+		die_errno("fork(login)");
+
+	if (child) {
+		close(fds[1]);
+		IGNORE_RESULT(read(fds[0], &c, 1));
+		terminal_printf(TERMINAL_FG_YELLOW TERMINAL_BOLD "Waiting" TERMINAL_RESET " in the background for approval of out-of-band %s login.\n", oob_name);
+		exit(0);
+	}
+
+	close(fds[0]);
+	pid = xultostr(getpid());
+	config_write_string("login.pid", pid);
+	close(fds[1]);
+
+	null = open("/dev/null", O_RDWR);
+	if (null >= 0) {
+		dup2(null, 0);
+		dup2(null, 1);
+		dup2(null, 2);
+		close(null);
+	}
+	setsid();
+	process_set_name("lpass [login]");
+	if (http_init()) {
+		config_unlink("login.pid");
+		_exit(EXIT_FAILURE);
+	}
+	detached = true;
+}
 
 int cmd_login(int argc, char **argv)
 {
@@ -53,6 +110,7 @@ int cmd_login(int argc, char **argv)
 		{"plaintext-key", no_argument, NULL, 'P'},
 		{"force", no_argument, NULL, 'f'},
 		{"color", required_argument, NULL, 'C'},
+		{"background", no_argument, NULL, 'b'},
     {"sso", no_argument, NULL, 's'},
 		{0, 0, 0, 0}
 	};
@@ -61,6 +119,7 @@ int cmd_login(int argc, char **argv)
 	bool trust = false;
 	bool plaintext_key = false;
 	bool force = false;
+	bool background = false;
 	char *username;
   bool sso = false;
 	_cleanup_free_ char *error = NULL;
@@ -82,6 +141,9 @@ int cmd_login(int argc, char **argv)
 		case 'f':
 			force = true;
 			break;
+		case 'b':
+			background = true;
+			break;
     case 's':
       sso = true;
       break;
@@ -121,7 +183,12 @@ int cmd_login(int argc, char **argv)
 
 		free(error);
 		error = NULL;
-		session = lastpass_login(username, fragment, hex, key, iterations, &error, trust);
+		session = lastpass_login(username, fragment, hex, key, iterations, &error, trust, background ? login_detach : NULL);
+		if (detached && !session_is_valid(session)) {
+			lpass_log(LOG_ERROR, "Background login failed: %s\n", error);
+			config_unlink("login.pid");
+			_exit(EXIT_FAILURE);
+		}
 	} while (!session_is_valid(session));
 
 	config_unlink("plaintext_key");
@@ -134,6 +201,9 @@ int cmd_login(int argc, char **argv)
 	session_free(session);
 	session = NULL;
 
+	if (detached)
+		config_unlink("login.pid");
+
 	terminal_printf(TERMINAL_FG_GREEN TERMINAL_BOLD "Success" TERMINAL_RESET ": Logged in as " TERMINAL_UNDERLINE "%s" TERMINAL_RESET ".\n", username);
 
 	return 0;
@@ -79,7 +79,8 @@ int cmd_logout(int argc, char **argv)
 		return 1;
 	}
 
-	if (agent_ask(key)) {
+	/* a login still waiting for approval is simply abandoned */
+	if (!session_login_pending() && agent_ask(key)) {
 		init_all(0, key, &session, NULL);
 		lastpass_logout(session);
 	}
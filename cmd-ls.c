@@ -39,15 +39,13 @@
 #include "terminal.h"
 #include "format.h"
 #include "kdf.h"
+#include "usage.h"
 #include <getopt.h>
 #include <stdio.h>
 #include <unistd.h>
 #include <string.h>
 #include <time.h>
 
-static bool long_listing = false;
-static bool show_mtime = true;
-
 struct node {
 	char *name;
 	struct account *account;
@@ -228,6 +226,7 @@ int cmd_ls(int argc, char **argv)
 		{"color", required_argument, NULL, 'C'},
 		{"format", required_argument, NULL, 'f'},
 		{"long", no_argument, NULL, 'l'},
+		{"by-usage", no_argument, NULL, 'b'},
 		{0, 0, 0, 0}
 	};
 	int option;
@@ -244,6 +243,9 @@ int cmd_ls(int argc, char **argv)
 	_cleanup_free_ struct account **account_array = NULL;
 	int i, num_accounts;
 	_cleanup_free_ char *fmt_str = NULL;
+	bool long_listing = false;
+	bool show_mtime = true;
+	bool by_usage = false;
 
 	struct share *share;
 
@@ -267,6 +269,9 @@ int cmd_ls(int argc, char **argv)
 			case 'u':
 				show_mtime = false;
 				break;
+			case 'b':
+				by_usage = true;
+				break;
 			case '?':
 			default:
 				die_usage(cmd_ls_usage);
@@ -324,6 +329,12 @@ int cmd_ls(int argc, char **argv)
 	}
 	qsort(account_array, num_accounts, sizeof(struct account *),
 	      compare_account);
+	if (by_usage) {
+		struct usage *usage = usage_load(key);
+
+		usage_sort_accounts(account_array, num_accounts, usage);
+		usage_free(usage);
+	}
 
 	if (!fmt_str) {
 		xasprintf(&fmt_str,
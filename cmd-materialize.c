@@ -0,0 +1,640 @@
+/*
+ * command for keeping vault secrets written out to files
+ *
+ * Copyright (C) 2014-2024 LastPass.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ *
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ *
+ * See LICENSE.OpenSSL for more details regarding this exception.
+ */
+#include "cmd.h"
+#include "util.h"
+#include "config.h"
+#include "terminal.h"
+#include "kdf.h"
+#include "blob.h"
+#include "agent.h"
+#include "cipher.h"
+#include "endpoints.h"
+#include "list.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#if defined(__linux__)
+#include <sys/vfs.h>
+#include <linux/magic.h>
+#endif
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <signal.h>
+#include <setjmp.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MATERIALIZE_INTERVAL_DEFAULT 60
+
+/*
+ * One line of the map: the file to write, relative to the directory,
+ * and the entry and field to fill it with.
+ */
+struct materialize_entry {
+	char *path;
+	char *field;
+	char *name;
+
+	/* digest of the value last written, or the attachment id */
+	char *version;
+
+	/* resolved by the current pass */
+	struct account *account;
+	struct attach *attach;
+	char *value;
+
+	struct list_head list;
+};
+
+struct materialize {
+	char *dir;
+	bool created_dir;
+	struct list_head entries;
+	/* parent directories we created, innermost last */
+	char **dirs;
+	size_t dirs_count;
+};
+
+static volatile sig_atomic_t stop_requested;
+
+static void request_stop(int signal)
+{
+	UNUSED(signal);
+	stop_requested = true;
+}
+
+static bool valid_field(const char *field)
+{
+	static const char *plain_fields[] = {
+		"username", "password", "url", "notes", "name", "id"
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(plain_fields); ++i) {
+		if (!strcmp(field, plain_fields[i]))
+			return true;
+	}
+	return (!strncmp(field, "field:", 6) && field[6]) ||
+	       (!strncmp(field, "attach:", 7) && field[7]);
+}
+
+/* relative, and without empty, "." or ".." components */
+static bool valid_path(const char *path)
+{
+	const char *component = path, *end;
+	size_t len;
+
+	if (*path == '/')
+		return false;
+	for (;;) {
+		end = strchrnul(component, '/');
+		len = end - component;
+		if (!len || (len == 1 && component[0] == '.') ||
+		    (len == 2 && !strncmp(component, "..", 2)))
+			return false;
+		if (!*end)
+			return true;
+		component = end + 1;
+	}
+}
+
+/*
+ * Split off the next whitespace-separated word of a map line; words
+ * holding spaces are written in double quotes.
+ */
+static char *map_word(char **line)
+{
+	char *p = *line, *start;
+
+	while (isspace((unsigned char) *p))
+		++p;
+	if (!*p)
+		return NULL;
+
+	if (*p == '"') {
+		start = ++p;
+		p = strchr(p, '"');
+		if (!p)
+			return NULL;
+		*p++ = '\0';
+	} else {
+		start = p;
+		while (*p && !isspace((unsigned char) *p))
+			++p;
+		if (*p)
+			*p++ = '\0';
+	}
+	*line = p;
+	return start;
+}
+
+static void map_load(struct materialize *m, const char *filename)
+{
+	_cleanup_fclose_ FILE *fp = NULL;
+	_cleanup_free_ char *line = NULL;
+	size_t line_size = 0;
+	unsigned int line_number = 0;
+	struct materialize_entry *entry;
+	char *p, *path, *field, *name;
+
+	fp = fopen(filename, "r");
+	if (!fp)
+		die_errno("fopen(%s)", filename);
+
+	while (getline(&line, &line_size, fp) >= 0) {
+		++line_number;
+		p = line;
+		while (isspace((unsigned char) *p))
+			++p;
+		if (!*p || *p == '#')
+			continue;
+
+		path = map_word(&p);
+		field = map_word(&p);
+		name = map_word(&p);
+		if (!path || !field || !name || map_word(&p))
+			die("%s:%u: expected PATH FIELD ENTRY.", filename, line_number);
+		if (!valid_path(path))
+			die("%s:%u: '%s' is not a relative path.", filename, line_number, path);
+		if (!valid_field(field))
+			die("%s:%u: unknown field '%s'.", filename, line_number, field);
+
+		entry = new0(struct materialize_entry, 1);
+		entry->path = xstrdup(path);
+		entry->field = xstrdup(field);
+		entry->name = xstrdup(name);
+		list_add_tail(&entry->list, &m->entries);
+	}
+	if (list_empty(&m->entries))
+		die("%s: no files to write.", filename);
+}
+
+/*
+ * The directory must be ours alone; it is created if missing.  Outside
+ * of a tmpfs the secrets end up on disk, which is allowed but worth a
+ * warning.
+ */
+static void prepare_dir(struct materialize *m)
+{
+	struct stat sbuf;
+
+	if (mkdir(m->dir, 0700) == 0)
+		m->created_dir = true;
+	else if (errno != EEXIST)
+		die_errno("mkdir(%s)", m->dir);
+
+	if (lstat(m->dir, &sbuf) < 0)
+		die_errno("stat(%s)", m->dir);
+	if (!S_ISDIR(sbuf.st_mode) || sbuf.st_uid != getuid() ||
+	    (sbuf.st_mode & (S_IRWXG | S_IRWXO)))
+		die("%s must be a directory accessible only to you.", m->dir);
+
+#if defined(__linux__)
+	struct statfs fsbuf;
+
+	if (statfs(m->dir, &fsbuf) == 0 && fsbuf.f_type != TMPFS_MAGIC)
+		warn("%s is not on a tmpfs; secrets will be written to disk.", m->dir);
+#endif
+}
+
+static void make_parents(struct materialize *m, const char *path)
+{
+	_cleanup_free_ char *dir = NULL;
+	char *slash;
+
+	xasprintf(&dir, "%s/%s", m->dir, path);
+	for (slash = dir + strlen(m->dir) + 1; (slash = strchr(slash, '/')); ++slash) {
+		*slash = '\0';
+		if (mkdir(dir, 0700) == 0) {
+			m->dirs = xreallocarray(m->dirs, m->dirs_count + 1, sizeof(*m->dirs));
+			m->dirs[m->dirs_count++] = xstrdup(dir);
+		} else if (errno != EEXIST)
+			die_errno("mkdir(%s)", dir);
+		*slash = '/';
+	}
+}
+
+/*
+ * Replace the file with a read-only one holding data, through a rename
+ * so that readers see either the old value or the new one in full.
+ */
+static void write_file(struct materialize *m, const char *path,
+		       const void *data, size_t len)
+{
+	_cleanup_free_ char *final = NULL;
+	_cleanup_free_ char *temp = NULL;
+	char *slash;
+	FILE *fp;
+	int fd;
+
+	make_parents(m, path);
+	xasprintf(&final, "%s/%s", m->dir, path);
+	slash = strrchr(final, '/');
+	xasprintf(&temp, "%.*s/.%s.XXXXXX", (int)(slash - final), final, slash + 1);
+
+	fd = mkstemp(temp);
+	if (fd < 0)
+		die_errno("mkstemp(%s)", temp);
+	fp = fdopen(fd, "w");
+	if (!fp)
+		die_errno("fdopen(%s)", temp);
+	if (fwrite(data, 1, len, fp) != len || fchmod(fd, 0400) < 0) {
+		unlink(temp);
+		die_errno("write(%s)", temp);
+	}
+	if (fclose(fp) < 0) {
+		unlink(temp);
+		die_errno("fclose(%s)", temp);
+	}
+	if (rename(temp, final) < 0) {
+		unlink(temp);
+		die_errno("rename(%s)", final);
+	}
+}
+
+static char *attachment_filename(struct account *account, struct attach *attach)
+{
+	_cleanup_free_ unsigned char *key_bin = NULL;
+
+	if (!attach->filename || !account->attachkey ||
+	    strlen(account->attachkey) != KDF_HASH_LEN * 2 ||
+	    hex_to_bytes(account->attachkey, &key_bin))
+		return NULL;
+
+	return cipher_aes_decrypt_base64(attach->filename, key_bin);
+}
+
+/* by id (att-ID), or else by file name */
+static struct attach *find_attachment(struct account *account, const char *which)
+{
+	struct attach *attach;
+
+	list_for_each_entry(attach, &account->attach_head, list) {
+		_cleanup_free_ char *filename = NULL;
+
+		if (!strncmp(which, "att-", 4) && !strcmp(attach->id, which + 4))
+			return attach;
+		filename = attachment_filename(account, attach);
+		if (filename && !strcmp(filename, which))
+			return attach;
+	}
+	return NULL;
+}
+
+static void write_attachment(struct materialize *m, const struct session *session,
+			     struct materialize_entry *entry)
+{
+	_cleanup_free_ unsigned char *key_bin = NULL;
+	_cleanup_free_ char *result = NULL;
+	_cleanup_free_ char *ptext = NULL;
+	_cleanup_free_ unsigned char *bytes = NULL;
+	struct account *account = entry->account;
+	char *shareid = account->share ? account->share->id : NULL;
+	size_t len;
+
+	if (!account->attachkey || strlen(account->attachkey) != KDF_HASH_LEN * 2 ||
+	    hex_to_bytes(account->attachkey, &key_bin))
+		die("Missing attach key for account %s.", account->name);
+
+	if (lastpass_load_attachment(session, shareid, entry->attach, &result))
+		die("Could not load attachment %s.", entry->attach->id);
+	ptext = cipher_aes_decrypt_base64(result, key_bin);
+	if (!ptext)
+		die("Unable to decrypt attachment %s.", entry->attach->id);
+	len = unbase64(ptext, &bytes);
+
+	write_file(m, entry->path, bytes, len);
+	secure_clear(bytes, len);
+}
+
+/*
+ * Look up the entry's current value, or attachment, and its version;
+ * returns an error message if it cannot be found.
+ */
+static char *resolve(struct blob *blob, struct materialize_entry *entry,
+		     char **version)
+{
+	struct account *account, *expanded;
+	struct field *field;
+	const char *value = NULL;
+	char *error = NULL;
+
+	account = find_unique_account(blob, entry->name);
+	if (!account) {
+		xasprintf(&error, "Could not find entry '%s'.", entry->name);
+		return error;
+	}
+	entry->account = account;
+
+	if (!strncmp(entry->field, "attach:", 7)) {
+		entry->attach = find_attachment(account, entry->field + 7);
+		if (!entry->attach) {
+			xasprintf(&error, "Could not find attachment '%s' of '%s'.", entry->field + 7, entry->name);
+			return error;
+		}
+		xasprintf(version, "att-%s", entry->attach->id);
+		return NULL;
+	}
+
+	expanded = notes_expand(account);
+	if (expanded)
+		account = expanded;
+
+	if (!strncmp(entry->field, "field:", 6)) {
+		list_for_each_entry(field, &account->field_head, list) {
+			if (!strcmp(field->name, entry->field + 6)) {
+				value = field->value;
+				break;
+			}
+		}
+	} else if (!strcmp(entry->field, "username"))
+		value = account->username;
+	else if (!strcmp(entry->field, "password"))
+		value = account->password;
+	else if (!strcmp(entry->field, "url"))
+		value = account->url;
+	else if (!strcmp(entry->field, "notes"))
+		value = account->note;
+	else if (!strcmp(entry->field, "name"))
+		value = account->name;
+	else if (!strcmp(entry->field, "id"))
+		value = account->id;
+
+	if (value) {
+		entry->value = xstrdup(value);
+		*version = cipher_sha256_hex((unsigned char *) entry->value, strlen(entry->value));
+	} else
+		xasprintf(&error, "Could not find field '%s' of '%s'.", entry->field, entry->name);
+
+	if (expanded)
+		account_free(expanded);
+	return error;
+}
+
+/*
+ * Bring the files up to date with the blob, writing only those whose
+ * value changed or which went missing.  On the first pass every lookup
+ * must succeed before anything is written; later on, a failed lookup
+ * leaves the file as it was.
+ */
+static void materialize_pass(struct materialize *m, struct session *session,
+			     struct blob *blob, const unsigned char key[KDF_HASH_LEN],
+			     bool first)
+{
+	struct materialize_entry *entry;
+	_cleanup_free_ char *path = NULL;
+	char **versions;
+	size_t i = 0, count = 0;
+	bool reprompted = false;
+
+	list_for_each_entry(entry, &m->entries, list)
+		++count;
+	versions = new0(char *, count);
+
+	list_for_each_entry(entry, &m->entries, list) {
+		_cleanup_free_ char *error = NULL;
+
+		entry->account = NULL;
+		entry->attach = NULL;
+		error = resolve(blob, entry, &versions[i++]);
+		if (error) {
+			if (first)
+				die("%s", error);
+			warn("%s", error);
+		}
+	}
+
+	list_for_each_entry(entry, &m->entries, list) {
+		if (!entry->account || !entry->account->pwprotect || !first || reprompted)
+			continue;
+		unsigned char pwprotect_key[KDF_HASH_LEN];
+		if (!agent_load_key(pwprotect_key))
+			die("Could not authenticate for protected entry.");
+		if (memcmp(pwprotect_key, key, KDF_HASH_LEN))
+			die("Current key is not on-disk key.");
+		reprompted = true;
+	}
+
+	i = 0;
+	list_for_each_entry(entry, &m->entries, list) {
+		char *version = versions[i++];
+
+		free(path);
+		xasprintf(&path, "%s/%s", m->dir, entry->path);
+		if (version && (!entry->version || strcmp(version, entry->version) ||
+				access(path, F_OK))) {
+			if (entry->attach)
+				write_attachment(m, session, entry);
+			else
+				write_file(m, entry->path, entry->value, strlen(entry->value));
+			free(entry->version);
+			entry->version = version;
+		} else
+			free(version);
+
+		if (entry->value) {
+			secure_clear_str(entry->value);
+			free(entry->value);
+			entry->value = NULL;
+		}
+	}
+	free(versions);
+}
+
+static void materialize_remove(struct materialize *m)
+{
+	struct materialize_entry *entry;
+	_cleanup_free_ char *path = NULL;
+
+	list_for_each_entry(entry, &m->entries, list) {
+		free(path);
+		xasprintf(&path, "%s/%s", m->dir, entry->path);
+		unlink(path);
+	}
+	while (m->dirs_count)
+		rmdir(m->dirs[--m->dirs_count]);
+	if (m->created_dir)
+		rmdir(m->dir);
+}
+
+static bool blob_changed(struct stat *last)
+{
+	_cleanup_free_ char *path = config_path("blob");
+	struct stat sbuf;
+
+	if (stat(path, &sbuf) < 0)
+		return false;
+	if (sbuf.st_ino == last->st_ino && sbuf.st_mtime == last->st_mtime &&
+	    sbuf.st_size == last->st_size)
+		return false;
+	*last = sbuf;
+	return true;
+}
+
+/*
+ * Reload the blob, synced with the server if sync says so, and update
+ * the files from it.  Errors are only reported: exiting here would
+ * leave the files behind.  The session and blob are only replaced once
+ * the new ones are loaded.
+ */
+static void materialize_refresh(struct materialize *m, struct session **session,
+				struct blob **blob, const unsigned char key[KDF_HASH_LEN],
+				enum blobsync sync, struct stat *blob_stat)
+{
+	struct session *volatile new_session = NULL;
+	struct blob *new_blob;
+	struct error_trap trap;
+
+	error_trap_push(&trap);
+	if (setjmp(trap.env)) {
+		session_free(new_session);
+		warn("%s", trap.message);
+		return;
+	}
+
+	new_session = session_load(key);
+	new_blob = new_session ? blob_load(sync, new_session, key, false) : NULL;
+	session_free(*session);
+	*session = new_session;
+	new_session = NULL;
+	blob_free(*blob);
+	*blob = new_blob;
+	if (*blob) {
+		blob_changed(blob_stat);
+		materialize_pass(m, *session, *blob, key, false);
+	}
+	error_trap_pop(&trap);
+}
+
+int cmd_materialize(int argc, char **argv)
+{
+	static struct option long_options[] = {
+		{"sync", required_argument, NULL, 'S'},
+		{"color", required_argument, NULL, 'C'},
+		{"dir", required_argument, NULL, 'd'},
+		{"map", required_argument, NULL, 'm'},
+		{"once", no_argument, NULL, 'o'},
+		{"interval", required_argument, NULL, 'i'},
+		{0, 0, 0, 0}
+	};
+	int option;
+	int option_index;
+	enum blobsync sync = BLOB_SYNC_AUTO;
+	struct materialize m = { 0 };
+	const char *map = NULL;
+	bool once = false;
+	unsigned long interval = MATERIALIZE_INTERVAL_DEFAULT;
+	time_t next_sync;
+	unsigned char key[KDF_HASH_LEN];
+	struct session *session = NULL;
+	struct blob *blob = NULL;
+	struct stat blob_stat = { 0 };
+	char *end;
+
+	while ((option = getopt_long(argc, argv, "", long_options, &option_index)) != -1) {
+		switch (option) {
+			case 'S':
+				sync = parse_sync_string(optarg);
+				break;
+			case 'C':
+				terminal_set_color_mode(
+					parse_color_mode_string(optarg));
+				break;
+			case 'd':
+				m.dir = optarg;
+				break;
+			case 'm':
+				map = optarg;
+				break;
+			case 'o':
+				once = true;
+				break;
+			case 'i':
+				interval = strtoul(optarg, &end, 10);
+				if (*end || !interval)
+					die_usage(cmd_materialize_usage);
+				break;
+			case '?':
+			default:
+				die_usage(cmd_materialize_usage);
+		}
+	}
+	if (optind != argc || !m.dir || !map)
+		die_usage(cmd_materialize_usage);
+
+	INIT_LIST_HEAD(&m.entries);
+	map_load(&m, map);
+
+	init_all(sync, key, &session, &blob);
+	if (!once && !agent_ask(key))
+		die("Keeping files up to date needs the agent; use --once without it.");
+
+	umask(077);
+	prepare_dir(&m);
+	blob_changed(&blob_stat);
+	materialize_pass(&m, session, blob, key, true);
+	if (once)
+		goto out;
+
+	signal(SIGHUP, request_stop);
+	signal(SIGINT, request_stop);
+	signal(SIGTERM, request_stop);
+
+	/*
+	 * The agent is asked every second, so that the files go soon after
+	 * logout or the agent's timeout; the blob is reloaded whenever
+	 * another command has saved it, and synced every interval.
+	 */
+	next_sync = time(NULL) + interval;
+	while (!stop_requested) {
+		sleep(1);
+		if (stop_requested || !agent_ask(key))
+			break;
+		if (time(NULL) >= next_sync) {
+			next_sync = time(NULL) + interval;
+			materialize_refresh(&m, &session, &blob, key, sync, &blob_stat);
+		} else if (blob_changed(&blob_stat))
+			materialize_refresh(&m, &session, &blob, key, BLOB_SYNC_NO, &blob_stat);
+	}
+	materialize_remove(&m);
+
+out:
+	session_free(session);
+	blob_free(blob);
+	return 0;
+}
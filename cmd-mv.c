@@ -40,12 +40,136 @@
 #include "kdf.h"
 #include "endpoints.h"
 #include "agent.h"
+#include "upload-queue.h"
 #include <getopt.h>
 #include <stdio.h>
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
 
+struct move {
+	struct account *account;
+	struct share *old_share;
+};
+
+static int compare_move(const void *a, const void *b)
+{
+	const struct move *x = a, *y = b;
+
+	if (x->old_share != y->old_share)
+		return x->old_share < y->old_share ? -1 : 1;
+	if (x->account->share != y->account->share)
+		return x->account->share < y->account->share ? -1 : 1;
+	return 0;
+}
+
+/*
+ * The new fullname of an account moved into group.  Accounts taken
+ * from a folder keep their place below it, so that its subfolders
+ * move along.
+ */
+static char *moved_fullname(struct account *account, const char *folder,
+			    const char *group)
+{
+	char *new_fullname = NULL;
+	size_t len;
+
+	if (folder) {
+		len = strlen(folder);
+		if (!strncmp(account->fullname, folder, len) &&
+		    (account->fullname[len] == '/' || account->fullname[len] == '\\')) {
+			xasprintf(&new_fullname, "%s%s", group, account->fullname + len);
+			return new_fullname;
+		}
+	}
+	xasprintf(&new_fullname, "%s/%s", group, account->name);
+	return new_fullname;
+}
+
+static void print_progress(const char *operation, size_t cur, size_t max)
+{
+	char progress[41] = {0};
+	size_t len;
+
+	len = max ? (cur * (sizeof(progress) - 1)) / max : 0;
+	if (len)
+		memset(progress, '=', len);
+
+	terminal_fprintf(stderr, TERMINAL_FG_CYAN "%s " TERMINAL_RESET
+			 TERMINAL_FG_BLUE "[%-*s] " TERMINAL_RESET
+			 TERMINAL_FG_CYAN "%zu/%zu     \r" TERMINAL_RESET,
+			 operation, (int) sizeof(progress) - 1, progress, cur, max);
+}
+
+/*
+ * Rename folder old_folder, and all of its subfolders, to new_folder.
+ *
+ * Only the group of each entry changes, so only the grouping field
+ * is reencrypted, and the entries go out as the rows of a few batched
+ * updates.  Every entry is renamed before any update is queued, so a
+ * refused rename leaves the vault alone; the cache is then saved only
+ * once the whole rename is queued, and the uploader is started once to
+ * send it.
+ */
+static void rename_folder(enum blobsync sync, unsigned char key[KDF_HASH_LEN],
+			  struct session *session, struct blob *blob,
+			  const char *old_folder, const char *new_folder)
+{
+	struct list_head potential_set, targets;
+	_cleanup_free_ struct account **renamed = NULL;
+	struct account *account;
+	struct share *old_share;
+	char *new_fullname;
+	size_t len = strlen(old_folder), total = 0, done, batch;
+
+	INIT_LIST_HEAD(&potential_set);
+	INIT_LIST_HEAD(&targets);
+
+	list_for_each_entry(account, &blob->account_head, list)
+		list_add_tail(&account->match_list, &potential_set);
+	find_folder_accounts(&potential_set, old_folder, &targets);
+
+	if (list_empty(&targets))
+		die("Could not find folder '%s'.", old_folder);
+
+	list_for_each_entry(account, &targets, match_list) {
+		old_share = account->share;
+
+		xasprintf(&new_fullname, "%s%s", new_folder, account->fullname + len);
+		account_set_fullname(account, new_fullname, key);
+		account_assign_share(blob, account, key, &session->feature_flag);
+
+		if (account->share != old_share)
+			die("%s would move to another shared folder; use mv without --rename-folder.",
+			    account->fullname);
+		if (account->share && account->share->readonly)
+			die("You do not have access to rename folders in %s",
+			    account->share->name);
+		account_encrypt(account, key, &session->feature_flag);
+		total++;
+	}
+
+	renamed = new0(struct account *, total);
+	total = 0;
+	list_for_each_entry(account, &targets, match_list) {
+		if (account->dirty)
+			renamed[total++] = account;
+	}
+
+	for (done = 0; done < total; done += batch) {
+		batch = upload_batch_size(&renamed[done], total - done);
+		lastpass_update_accounts(BLOB_SYNC_NO, key, session,
+					 &renamed[done], batch, blob);
+		print_progress("Renaming", done + batch, total);
+	}
+	terminal_fprintf(stderr, "\n");
+
+	blob_save(blob, key, &session->feature_flag);
+
+	if (sync != BLOB_SYNC_NO)
+		upload_queue_ensure_running(key, session);
+}
+
 int cmd_mv(int argc, char **argv)
 {
 	unsigned char key[KDF_HASH_LEN];
@@ -54,18 +178,28 @@ int cmd_mv(int argc, char **argv)
 	static struct option long_options[] = {
 		{"sync", required_argument, NULL, 'S'},
 		{"color", required_argument, NULL, 'C'},
+		{"basic-regexp", no_argument, NULL, 'G'},
+		{"fixed-strings", no_argument, NULL, 'F'},
+		{"folder", required_argument, NULL, 'f'},
+		{"rename-folder", no_argument, NULL, 'r'},
 		{0, 0, 0, 0}
 	};
 	enum blobsync sync = BLOB_SYNC_AUTO;
+	enum search_type search = SEARCH_EXACT_MATCH;
 	int option;
 	int option_index;
-	char *name;
-	char *folder;
-	char *new_fullname = NULL;
+	char *folder = NULL;
+	char *group;
+	char *new_fullname;
+	struct list_head targets;
 	struct account *account;
-	struct share *old_share;
+	_cleanup_free_ struct move *moves = NULL;
+	_cleanup_free_ struct account **batch = NULL;
+	size_t n_moves = 0, n_targets = 0, i, j, count;
+	bool changed = false;
+	bool rename = false;
 
-	while ((option = getopt_long(argc, argv, "SC", long_options, &option_index)) != -1) {
+	while ((option = getopt_long(argc, argv, "GF", long_options, &option_index)) != -1) {
 		switch (option) {
 			case 'S':
 				sync = parse_sync_string(optarg);
@@ -74,50 +208,116 @@ int cmd_mv(int argc, char **argv)
 				terminal_set_color_mode(
 					parse_color_mode_string(optarg));
 				break;
+			case 'G':
+				search = SEARCH_BASIC_REGEX;
+				break;
+			case 'F':
+				search = SEARCH_FIXED_SUBSTRING;
+				break;
+			case 'f':
+				folder = optarg;
+				break;
+			case 'r':
+				rename = true;
+				break;
 			case '?':
 			default:
 				die_usage(cmd_mv_usage);
 		}
 	}
 
-	if (argc - optind != 2)
+	if (rename) {
+		if (argc - optind != 2 || folder || search != SEARCH_EXACT_MATCH)
+			die_usage(cmd_mv_usage);
+
+		init_all(sync, key, &session, &blob);
+		rename_folder(sync, key, session, blob, argv[optind], argv[optind + 1]);
+
+		session_free(session);
+		blob_free(blob);
+		return 0;
+	}
+
+	if (argc - optind < (folder ? 1 : 2))
 		die_usage(cmd_mv_usage);
 
-	name = argv[optind++];
-	folder = argv[optind++];
+	group = argv[--argc];
 
 	init_all(sync, key, &session, &blob);
 
-	account = find_unique_account(blob, name);
-	if (!account) {
-		die("Unable to find account %s", name);
-	}
+	INIT_LIST_HEAD(&targets);
+	find_target_accounts(blob, search, folder, &argv[optind],
+			     argc - optind, &targets);
 
-	xasprintf(&new_fullname, "%s/%s", folder, account->name);
-	old_share = account->share;
+	list_for_each_entry(account, &targets, match_list)
+		n_targets++;
+	moves = new0(struct move, n_targets);
 
-	account_set_fullname(account, new_fullname, key);
-	account_assign_share(blob, account, key, &session->feature_flag);
-	if (account->share && account->share->readonly) {
-		die("You do not have access to move %s into %s",
-		    account->name, account->share->name);
+	/*
+	 * Rename everything first, so that an entry we may not move
+	 * stops the command before anything is sent.
+	 */
+	list_for_each_entry(account, &targets, match_list) {
+		/*
+		 * The folder's own entry stays where it is; those of its
+		 * subfolders move along with their contents.
+		 */
+		if (folder && account_is_group(account) &&
+		    !strcmp(account->group, folder))
+			continue;
+
+		new_fullname = moved_fullname(account, folder, group);
+		moves[n_moves].account = account;
+		moves[n_moves].old_share = account->share;
+		n_moves++;
+
+		account_set_fullname(account, new_fullname, key);
+		account_assign_share(blob, account, key, &session->feature_flag);
+		if (account->share && account->share->readonly) {
+			die("You do not have access to move %s into %s",
+			    account->name, account->share->name);
+		}
 	}
 
-	if (old_share != account->share) {
+	/*
+	 * Moves into or out of a shared folder need the reencrypted
+	 * entries sent with a special api call; that and plain updates
+	 * both take many entries at once, so group the entries by their
+	 * source and destination.
+	 */
+	qsort(moves, n_moves, sizeof(*moves), compare_move);
+	batch = new0(struct account *, n_moves);
+
+	for (i = 0; i < n_moves; i = j) {
+		bool same_share = moves[i].old_share == moves[i].account->share;
+
+		count = 0;
+		for (j = i; j < n_moves && !compare_move(&moves[i], &moves[j]); j++) {
+			/* unless it was already in that folder */
+			if (!same_share || moves[j].account->dirty)
+				batch[count++] = moves[j].account;
+		}
+		if (!count)
+			continue;
+		changed = true;
+
+		if (same_share) {
+			/* standard case: accounts just changing group name */
+			lastpass_update_accounts(sync, key, session, batch, count, blob);
+			continue;
+		}
+
 		/*
-		 * when moving into / out of a shared folder, we need to
-		 * reencrypt and make a special api call for that.
+		 * The entries are kept in the local blob with their new
+		 * share, until the queue has sent them and the blob is
+		 * fetched again.
 		 */
-		int ret = lastpass_share_move(session, account, old_share);
-		if (ret) {
-			die("Move to/from shared folder failed (%d)\n", ret);
-		}
-		list_del(&account->list);
-	} else {
-		/* standard case: account just changing group name */
-		lastpass_update_account(sync, key, session, account, blob);
+		lastpass_share_move(sync, key, session, batch, count, moves[i].old_share);
 	}
-	blob_save(blob, key, &session->feature_flag);
+
+	/* nothing to save if everything already was in that folder */
+	if (changed)
+		blob_save(blob, key, &session->feature_flag);
 
 	session_free(session);
 	blob_free(blob);
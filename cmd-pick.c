@@ -0,0 +1,854 @@
+/*
+ * command to interactively pick a vault entry
+ *
+ * Copyright (C) 2014-2018 LastPass.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ *
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ *
+ * See LICENSE.OpenSSL for more details regarding this exception.
+ */
+#include "cmd.h"
+#include "util.h"
+#include "terminal.h"
+#include "agent.h"
+#include "kdf.h"
+#include "endpoints.h"
+#include "clipboard.h"
+#include "format.h"
+#include "usage.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+/*
+ * Entries are ranked once when the picker starts (most used first,
+ * then by name); every later list is a subset of that order, stored
+ * as indexes into it.
+ */
+struct pick_entry {
+	struct account *account;
+	char *label;
+	char *lower;
+	size_t len;
+	size_t name_offset;
+	unsigned long uses;
+	time_t last_used;
+	uint32_t position;
+};
+
+/*
+ * Trigrams of the lower-cased labels are hashed into buckets, each
+ * holding the ascending indexes of the entries containing one of its
+ * trigrams.  A bucket is a superset of the real matches, so candidates
+ * taken from it are always checked against the full query.
+ */
+#define PICK_BUCKET_BITS 16
+#define PICK_BUCKETS (1U << PICK_BUCKET_BITS)
+
+struct pick_index {
+	struct pick_entry *entries;
+	uint32_t count;
+	uint32_t *bucket_start;
+	uint32_t *postings;
+};
+
+/*
+ * The matches for each prefix of the query are kept, so typing only
+ * narrows the previous list and deleting a character is free.  Each
+ * list holds the entries whose name starts with the query first, then
+ * the other matches; both runs are in ranked order.
+ */
+#define PICK_QUERY_MAX 256
+
+struct pick_matches {
+	uint32_t *items;
+	uint32_t count;
+	uint32_t prefix_count;
+};
+
+struct picker {
+	struct pick_index *index;
+	char query[PICK_QUERY_MAX + 1];
+	char lower[PICK_QUERY_MAX + 1];
+	size_t query_len;
+	struct pick_matches levels[PICK_QUERY_MAX + 1];
+	size_t cursor;
+	size_t scroll;
+	int rows, cols;
+};
+
+enum {
+	KEY_NONE = -1,
+	KEY_RESIZE = -2,
+	KEY_ESCAPE = -3,
+	KEY_UP = -4,
+	KEY_DOWN = -5,
+	KEY_PAGE_UP = -6,
+	KEY_PAGE_DOWN = -7,
+};
+
+#define KEY_CTRL(c) ((c) & 0x1f)
+
+static int tty_fd = -1;
+static struct termios saved_termios;
+static volatile sig_atomic_t resized;
+
+static uint32_t trigram_bucket(const char *s)
+{
+	uint32_t trigram = (unsigned char)s[0] << 16 |
+			   (unsigned char)s[1] << 8 |
+			   (unsigned char)s[2];
+
+	return (trigram * 2654435761U) >> (32 - PICK_BUCKET_BITS);
+}
+
+static int compare_entry_label(const void *a, const void *b)
+{
+	const struct pick_entry *entry_a = a;
+	const struct pick_entry *entry_b = b;
+
+	return strcmp(entry_a->label, entry_b->label);
+}
+
+static int compare_entry_rank(const void *a, const void *b)
+{
+	const struct pick_entry *entry_a = a;
+	const struct pick_entry *entry_b = b;
+
+	if (entry_a->uses != entry_b->uses)
+		return entry_a->uses < entry_b->uses ? 1 : -1;
+	if (entry_a->last_used != entry_b->last_used)
+		return entry_a->last_used < entry_b->last_used ? 1 : -1;
+	return entry_a->position < entry_b->position ? -1 : 1;
+}
+
+static struct pick_index *pick_index_build(struct blob *blob, const struct usage *usage)
+{
+	struct pick_index *index = new0(struct pick_index, 1);
+	_cleanup_free_ uint32_t *last = NULL;
+	_cleanup_free_ uint32_t *fill = NULL;
+	const struct usage_entry *used;
+	struct account *account;
+	struct pick_entry *entry;
+	uint32_t i, bucket, total = 0;
+	size_t j;
+
+	list_for_each_entry(account, &blob->account_head, list) {
+		if (!account_is_group(account))
+			index->count++;
+	}
+
+	index->entries = xcalloc(index->count ? index->count : 1, sizeof(*index->entries));
+	i = 0;
+	list_for_each_entry(account, &blob->account_head, list) {
+		if (account_is_group(account))
+			continue;
+		entry = &index->entries[i++];
+		entry->account = account;
+		entry->label = get_display_fullname(account);
+		entry->lower = xstrlower(entry->label);
+		entry->len = strlen(entry->label);
+		if (entry->len >= strlen(account->name))
+			entry->name_offset = entry->len - strlen(account->name);
+	}
+	qsort(index->entries, index->count, sizeof(*index->entries), compare_entry_label);
+
+	for (i = 0; i < index->count; i++) {
+		entry = &index->entries[i];
+		entry->position = i;
+		used = usage_find(usage, entry->account->id);
+		if (used) {
+			entry->uses = used->count;
+			entry->last_used = used->last_used;
+		}
+	}
+	qsort(index->entries, index->count, sizeof(*index->entries), compare_entry_rank);
+
+	/*
+	 * Count the distinct entries per bucket, then fill the buckets;
+	 * last[] remembers the previous entry added to each bucket so an
+	 * entry is added once even if several of its trigrams share it.
+	 */
+	index->bucket_start = xcalloc(PICK_BUCKETS + 1, sizeof(uint32_t));
+	last = xcalloc(PICK_BUCKETS, sizeof(uint32_t));
+	for (i = 0; i < index->count; i++) {
+		entry = &index->entries[i];
+		for (j = 0; j + 3 <= entry->len; j++) {
+			bucket = trigram_bucket(&entry->lower[j]);
+			if (last[bucket] == i + 1)
+				continue;
+			last[bucket] = i + 1;
+			index->bucket_start[bucket + 1]++;
+			total++;
+		}
+	}
+	for (bucket = 0; bucket < PICK_BUCKETS; bucket++)
+		index->bucket_start[bucket + 1] += index->bucket_start[bucket];
+
+	index->postings = xcalloc(total ? total : 1, sizeof(uint32_t));
+	fill = xcalloc(PICK_BUCKETS, sizeof(uint32_t));
+	memcpy(fill, index->bucket_start, PICK_BUCKETS * sizeof(uint32_t));
+	memset(last, 0, PICK_BUCKETS * sizeof(uint32_t));
+	for (i = 0; i < index->count; i++) {
+		entry = &index->entries[i];
+		for (j = 0; j + 3 <= entry->len; j++) {
+			bucket = trigram_bucket(&entry->lower[j]);
+			if (last[bucket] == i + 1)
+				continue;
+			last[bucket] = i + 1;
+			index->postings[fill[bucket]++] = i;
+		}
+	}
+
+	return index;
+}
+
+static void pick_index_free(struct pick_index *index)
+{
+	uint32_t i;
+
+	if (!index)
+		return;
+	for (i = 0; i < index->count; i++) {
+		free(index->entries[i].label);
+		free(index->entries[i].lower);
+	}
+	free(index->entries);
+	free(index->bucket_start);
+	free(index->postings);
+	free(index);
+}
+
+static void picker_init(struct picker *picker, struct pick_index *index)
+{
+	struct pick_matches *all = &picker->levels[0];
+	uint32_t i;
+
+	memset(picker, 0, sizeof(*picker));
+	picker->index = index;
+	all->items = xcalloc(index->count ? index->count : 1, sizeof(uint32_t));
+	for (i = 0; i < index->count; i++)
+		all->items[i] = i;
+	all->count = all->prefix_count = index->count;
+}
+
+static void picker_free(struct picker *picker)
+{
+	size_t i;
+
+	for (i = 0; i <= picker->query_len; i++)
+		free(picker->levels[i].items);
+}
+
+static inline struct pick_matches *picker_matches(struct picker *picker)
+{
+	return &picker->levels[picker->query_len];
+}
+
+/*
+ * Narrow the matches of the query minus its last character down to
+ * those of the whole query.  Any match of the longer query contains
+ * its last trigram, so when that trigram's bucket is smaller than the
+ * previous matches it is the cheaper candidate list.
+ */
+static void picker_narrow(struct picker *picker)
+{
+	const char *lower = picker->lower;
+	struct pick_index *index = picker->index;
+	struct pick_matches *prev = &picker->levels[picker->query_len - 1];
+	struct pick_matches *next = &picker->levels[picker->query_len];
+	_cleanup_free_ uint32_t *others = NULL;
+	const uint32_t *bucket = NULL;
+	struct pick_entry *entry;
+	size_t len = picker->query_len;
+	uint32_t candidates = prev->count, other_count = 0;
+	uint32_t a = 0, b = prev->prefix_count, k = 0, i;
+
+	if (len >= 3) {
+		uint32_t n = trigram_bucket(&lower[len - 3]);
+		uint32_t size = index->bucket_start[n + 1] - index->bucket_start[n];
+
+		if (size < candidates) {
+			bucket = &index->postings[index->bucket_start[n]];
+			candidates = size;
+		}
+	}
+
+	next->items = xcalloc(candidates ? candidates : 1, sizeof(uint32_t));
+	others = xcalloc(candidates ? candidates : 1, sizeof(uint32_t));
+	next->count = next->prefix_count = 0;
+
+	for (;;) {
+		if (bucket) {
+			if (k == candidates)
+				break;
+			i = bucket[k++];
+		} else {
+			/* merge the two ranked runs of the previous list */
+			if (a < prev->prefix_count &&
+			    (b == prev->count || prev->items[a] < prev->items[b]))
+				i = prev->items[a++];
+			else if (b < prev->count)
+				i = prev->items[b++];
+			else
+				break;
+		}
+
+		entry = &index->entries[i];
+		if (!memmem(entry->lower, entry->len, lower, len))
+			continue;
+		if (entry->len - entry->name_offset >= len &&
+		    !memcmp(&entry->lower[entry->name_offset], lower, len))
+			next->items[next->prefix_count++] = i;
+		else
+			others[other_count++] = i;
+	}
+	memcpy(&next->items[next->prefix_count], others, other_count * sizeof(uint32_t));
+	next->count = next->prefix_count + other_count;
+}
+
+static void picker_push(struct picker *picker, char c)
+{
+	if (picker->query_len == PICK_QUERY_MAX)
+		return;
+
+	picker->lower[picker->query_len] = tolower((unsigned char)c);
+	picker->query[picker->query_len++] = c;
+	picker->query[picker->query_len] = '\0';
+	picker_narrow(picker);
+	picker->cursor = picker->scroll = 0;
+}
+
+/* remove the last character, which may be several bytes of UTF-8 */
+static void picker_pop(struct picker *picker)
+{
+	char c;
+
+	while (picker->query_len) {
+		c = picker->query[picker->query_len - 1];
+		free(picker->levels[picker->query_len].items);
+		picker->levels[picker->query_len].items = NULL;
+		picker->query[--picker->query_len] = '\0';
+		if ((c & 0xc0) != 0x80)
+			break;
+	}
+	picker->cursor = picker->scroll = 0;
+}
+
+static void picker_move(struct picker *picker, long delta)
+{
+	long count = picker_matches(picker)->count;
+	long cursor = (long)picker->cursor + delta;
+
+	if (cursor >= count)
+		cursor = count - 1;
+	if (cursor < 0)
+		cursor = 0;
+	picker->cursor = cursor;
+}
+
+static int list_rows(struct picker *picker)
+{
+	return picker->rows > 1 ? picker->rows - 1 : 1;
+}
+
+static void picker_update_size(struct picker *picker)
+{
+	struct winsize size;
+
+	picker->rows = 24;
+	picker->cols = 80;
+	if (!ioctl(tty_fd, TIOCGWINSZ, &size) && size.ws_row && size.ws_col) {
+		picker->rows = size.ws_row;
+		picker->cols = size.ws_col;
+	}
+}
+
+/*
+ * Append at most max_cols characters of str, counting UTF-8 sequences
+ * as one column, and return the number of columns used.
+ */
+static int append_columns(struct buffer *buf, const char *str, size_t len, int max_cols)
+{
+	size_t end;
+	int cols = 0;
+
+	if (max_cols <= 0)
+		return 0;
+	for (end = 0; end < len; end++) {
+		if (((unsigned char)str[end] & 0xc0) == 0x80)
+			continue;
+		if (cols == max_cols)
+			break;
+		cols++;
+	}
+	buffer_append(buf, (char *)str, end);
+	return cols;
+}
+
+static void write_all(int fd, const char *bytes, size_t len)
+{
+	ssize_t ret;
+
+	while (len) {
+		ret = write(fd, bytes, len);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			die_errno("write");
+		}
+		bytes += ret;
+		len -= ret;
+	}
+}
+
+/*
+ * Redraw the prompt and the visible rows of the list in a single
+ * write; nothing outside the window is formatted.
+ */
+static void picker_render(struct picker *picker)
+{
+	struct pick_matches *matches = picker_matches(picker);
+	struct pick_entry *entry;
+	struct buffer buf;
+	_cleanup_free_ char *status = NULL;
+	_cleanup_free_ char *position = NULL;
+	int rows = list_rows(picker), cols, row, query_cols;
+	size_t i;
+
+	if (picker->cursor < picker->scroll)
+		picker->scroll = picker->cursor;
+	if (picker->cursor >= picker->scroll + rows)
+		picker->scroll = picker->cursor - rows + 1;
+
+	buffer_init(&buf);
+	buffer_append_str(&buf, TERMINAL_HOME_CURSOR TERMINAL_CLEAR_LINE TERMINAL_BOLD "> " TERMINAL_RESET);
+	query_cols = append_columns(&buf, picker->query, picker->query_len, picker->cols - 3);
+	xasprintf(&status, "  %u/%u", matches->count, picker->index->count);
+	if (query_cols + 2 + (int)strlen(status) < picker->cols) {
+		buffer_append_str(&buf, TERMINAL_FG_YELLOW);
+		buffer_append_str(&buf, status);
+		buffer_append_str(&buf, TERMINAL_RESET);
+	}
+
+	for (row = 0; row < rows; row++) {
+		buffer_append_str(&buf, "\r\n" TERMINAL_CLEAR_LINE);
+		i = picker->scroll + row;
+		if (i >= matches->count)
+			continue;
+
+		entry = &picker->index->entries[matches->items[i]];
+		if (i == picker->cursor)
+			buffer_append_str(&buf, TERMINAL_REVERSE TERMINAL_BOLD "> " TERMINAL_NO_BOLD);
+		else
+			buffer_append_str(&buf, "  ");
+		cols = append_columns(&buf, entry->label, entry->name_offset, picker->cols - 2);
+		buffer_append_str(&buf, TERMINAL_BOLD);
+		append_columns(&buf, &entry->label[entry->name_offset],
+			       entry->len - entry->name_offset, picker->cols - 2 - cols);
+		buffer_append_str(&buf, TERMINAL_RESET);
+	}
+
+	xasprintf(&position, "\x1b[1;%dH", 3 + query_cols);
+	buffer_append_str(&buf, position);
+
+	write_all(tty_fd, buf.bytes, buf.len);
+	free(buf.bytes);
+}
+
+static void picker_restore_terminal(void)
+{
+	if (tty_fd < 0)
+		return;
+
+	write_all(tty_fd, TERMINAL_LEAVE_ALT_SCREEN, strlen(TERMINAL_LEAVE_ALT_SCREEN));
+	tcsetattr(tty_fd, TCSAFLUSH, &saved_termios);
+	close(tty_fd);
+	tty_fd = -1;
+}
+
+static void handle_resize(int signal)
+{
+	UNUSED(signal);
+	resized = 1;
+}
+
+static void picker_setup_terminal(struct picker *picker)
+{
+	struct termios raw;
+	struct sigaction action;
+
+	tty_fd = open("/dev/tty", O_RDWR | O_CLOEXEC);
+	if (tty_fd < 0)
+		die("No terminal available for the picker; use --filter instead.");
+	if (tcgetattr(tty_fd, &saved_termios) < 0)
+		die_errno("tcgetattr");
+
+	atexit(picker_restore_terminal);
+
+	raw = saved_termios;
+	raw.c_iflag &= ~(ICRNL | IXON);
+	raw.c_lflag &= ~(ECHO | ICANON | ISIG | IEXTEN);
+	raw.c_cc[VMIN] = 1;
+	raw.c_cc[VTIME] = 0;
+	if (tcsetattr(tty_fd, TCSAFLUSH, &raw) < 0)
+		die_errno("tcsetattr");
+
+	/* no SA_RESTART, so a resize interrupts the wait for a key */
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = handle_resize;
+	sigaction(SIGWINCH, &action, NULL);
+
+	write_all(tty_fd, TERMINAL_ENTER_ALT_SCREEN, strlen(TERMINAL_ENTER_ALT_SCREEN));
+	picker_update_size(picker);
+}
+
+static unsigned char input[256];
+static size_t input_pos, input_len;
+
+static int read_byte(int timeout_ms)
+{
+	struct pollfd pollfd = { .fd = tty_fd, .events = POLLIN };
+	ssize_t ret;
+
+	if (input_pos < input_len)
+		return input[input_pos++];
+
+	ret = poll(&pollfd, 1, timeout_ms);
+	if (ret < 0 && errno != EINTR)
+		die_errno("poll");
+	if (ret <= 0)
+		return KEY_NONE;
+
+	ret = read(tty_fd, input, sizeof(input));
+	if (ret < 0 && errno != EINTR)
+		die_errno("read");
+	if (ret < 0)
+		return KEY_NONE;
+	if (ret == 0)
+		return KEY_ESCAPE;
+
+	input_len = ret;
+	input_pos = 1;
+	return input[0];
+}
+
+/*
+ * Read one key, decoding the escape sequences for the arrow and page
+ * keys.  A lone escape is told apart from a sequence by waiting
+ * briefly for the rest of it.
+ */
+static int read_key(void)
+{
+	int c = read_byte(-1);
+
+	if (c != '\x1b')
+		return c;
+
+	c = read_byte(25);
+	if (c < 0 || c == '\x1b')
+		return KEY_ESCAPE;
+	if (c != '[' && c != 'O')
+		return KEY_NONE;
+
+	c = read_byte(25);
+	switch (c) {
+	case 'A':
+		return KEY_UP;
+	case 'B':
+		return KEY_DOWN;
+	case '5':
+		if (read_byte(25) == '~')
+			return KEY_PAGE_UP;
+		break;
+	case '6':
+		if (read_byte(25) == '~')
+			return KEY_PAGE_DOWN;
+		break;
+	}
+
+	/* skip the rest of a sequence we don't handle */
+	while (c >= 0 && !(c >= 0x40 && c <= 0x7e))
+		c = read_byte(25);
+	return KEY_NONE;
+}
+
+/*
+ * Run the picker until an entry is chosen or the user gives up.  All
+ * keys already read are handled before the next redraw, so pasted text
+ * costs a single frame.
+ */
+static struct pick_entry *picker_run(struct picker *picker)
+{
+	struct pick_matches *matches;
+	int key;
+
+	for (;;) {
+		if (resized) {
+			resized = 0;
+			picker_update_size(picker);
+		}
+		picker_render(picker);
+
+		do {
+			key = read_key();
+			matches = picker_matches(picker);
+
+			switch (key) {
+			case '\r':
+			case '\n':
+				if (matches->count)
+					return &picker->index->entries[matches->items[picker->cursor]];
+				break;
+			case KEY_ESCAPE:
+			case KEY_CTRL('c'):
+			case KEY_CTRL('g'):
+				return NULL;
+			case KEY_UP:
+			case KEY_CTRL('p'):
+				picker_move(picker, -1);
+				break;
+			case KEY_DOWN:
+			case KEY_CTRL('n'):
+				picker_move(picker, 1);
+				break;
+			case KEY_PAGE_UP:
+				picker_move(picker, -list_rows(picker));
+				break;
+			case KEY_PAGE_DOWN:
+				picker_move(picker, list_rows(picker));
+				break;
+			case 0x7f:
+			case KEY_CTRL('h'):
+				picker_pop(picker);
+				break;
+			case KEY_CTRL('u'):
+				while (picker->query_len)
+					picker_pop(picker);
+				break;
+			default:
+				if (key >= ' ')
+					picker_push(picker, key);
+				break;
+			}
+		} while (input_pos < input_len);
+	}
+}
+
+int cmd_pick(int argc, char **argv)
+{
+	unsigned char key[KDF_HASH_LEN];
+	struct session *session = NULL;
+	struct blob *blob = NULL;
+	static struct option long_options[] = {
+		{"sync", required_argument, NULL, 'S'},
+		{"username", no_argument, NULL, 'u'},
+		{"password", no_argument, NULL, 'p'},
+		{"url", no_argument, NULL, 'L'},
+		{"field", required_argument, NULL, 'f'},
+		{"id", no_argument, NULL, 'I'},
+		{"name", no_argument, NULL, 'N'},
+		{"notes", no_argument, NULL, 'O'},
+		{"clip", no_argument, NULL, 'c'},
+		{"query", required_argument, NULL, 'q'},
+		{"filter", required_argument, NULL, 'F'},
+		{"color", required_argument, NULL, 'C'},
+		{0, 0, 0, 0}
+	};
+	int option;
+	int option_index;
+	enum { USERNAME, PASSWORD, URL, FIELD, ID, NAME, NOTES } choice = PASSWORD;
+	_cleanup_free_ char *field = NULL;
+	_cleanup_free_ char *value = NULL;
+	const char *query = NULL;
+	bool filter = false;
+	bool clip = false;
+	enum blobsync sync = BLOB_SYNC_AUTO;
+	struct pick_index *index;
+	struct pick_matches *matches;
+	struct pick_entry *chosen;
+	struct picker picker;
+	struct account *found, *notes_expansion = NULL;
+	struct field *found_field;
+	struct usage *usage;
+	struct list_head chosen_list;
+	const char *p;
+	uint32_t i;
+	int ret = 0;
+
+	while ((option = getopt_long(argc, argv, "cup", long_options, &option_index)) != -1) {
+		switch (option) {
+			case 'S':
+				sync = parse_sync_string(optarg);
+				break;
+			case 'u':
+				choice = USERNAME;
+				break;
+			case 'p':
+				choice = PASSWORD;
+				break;
+			case 'L':
+				choice = URL;
+				break;
+			case 'f':
+				choice = FIELD;
+				free(field);
+				field = xstrdup(optarg);
+				break;
+			case 'I':
+				choice = ID;
+				break;
+			case 'N':
+				choice = NAME;
+				break;
+			case 'O':
+				choice = NOTES;
+				break;
+			case 'c':
+				clip = true;
+				break;
+			case 'q':
+				query = optarg;
+				filter = false;
+				break;
+			case 'F':
+				query = optarg;
+				filter = true;
+				break;
+			case 'C':
+				terminal_set_color_mode(
+					parse_color_mode_string(optarg));
+				break;
+			case '?':
+			default:
+				die_usage(cmd_pick_usage);
+		}
+	}
+
+	if (argc - optind != 0)
+		die_usage(cmd_pick_usage);
+
+	init_all(sync, key, &session, &blob);
+
+	usage = usage_load(key);
+	index = pick_index_build(blob, usage);
+	usage_free(usage);
+
+	picker_init(&picker, index);
+	for (p = query; p && *p; p++)
+		picker_push(&picker, *p);
+
+	if (filter) {
+		matches = picker_matches(&picker);
+		for (i = 0; i < matches->count; i++)
+			printf("%s\n", index->entries[matches->items[i]].label);
+		goto done;
+	}
+
+	picker_setup_terminal(&picker);
+	chosen = picker_run(&picker);
+	picker_restore_terminal();
+	if (!chosen) {
+		ret = 1;
+		goto done;
+	}
+	found = chosen->account;
+
+	if (found->pwprotect) {
+		unsigned char pwprotect_key[KDF_HASH_LEN];
+		if (!agent_load_key(pwprotect_key))
+			die("Could not authenticate for protected entry.");
+		if (memcmp(pwprotect_key, key, KDF_HASH_LEN))
+			die("Current key is not on-disk key.");
+	}
+
+	INIT_LIST_HEAD(&chosen_list);
+	list_add(&found->match_list, &chosen_list);
+	usage_record_matches(&chosen_list, blob, key);
+	lastpass_log_access(sync, session, key, found);
+
+	notes_expansion = notes_expand(found);
+	if (notes_expansion)
+		found = notes_expansion;
+
+	switch (choice) {
+	case USERNAME:
+		value = xstrdup(found->username);
+		break;
+	case PASSWORD:
+		value = xstrdup(found->password);
+		break;
+	case URL:
+		value = xstrdup(found->url);
+		break;
+	case ID:
+		value = xstrdup(found->id);
+		break;
+	case NAME:
+		value = xstrdup(found->name);
+		break;
+	case NOTES:
+		value = xstrdup(found->note);
+		break;
+	case FIELD:
+		list_for_each_entry(found_field, &found->field_head, list) {
+			if (!strcmp(found_field->name, field)) {
+				value = xstrdup(found_field->value);
+				break;
+			}
+		}
+		if (!value)
+			die("Could not find specified field '%s'.", field);
+		break;
+	}
+
+	if (clip)
+		clipboard_open();
+	printf("%s", value);
+	if (!clip)
+		putchar('\n');
+
+	account_free(notes_expansion);
+done:
+	picker_free(&picker);
+	pick_index_free(index);
+	session_free(session);
+	blob_free(blob);
+	return ret;
+}
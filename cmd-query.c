@@ -0,0 +1,839 @@
+/*
+ * command to select vault entries with a filter expression
+ *
+ * Copyright (C) 2014-2018 LastPass.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ *
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ *
+ * See LICENSE.OpenSSL for more details regarding this exception.
+ */
+#include "cmd.h"
+#include "util.h"
+#include "blob.h"
+#include "agent.h"
+#include "json-format.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <regex.h>
+#include <time.h>
+
+enum query_type {
+	QUERY_STRING,
+	QUERY_FLAG,
+	QUERY_TIME,
+};
+
+enum query_field {
+	FIELD_ID,
+	FIELD_NAME,
+	FIELD_FULLNAME,
+	FIELD_GROUP,
+	FIELD_SHARE,
+	FIELD_URL,
+	FIELD_HOST,
+	FIELD_USERNAME,
+	FIELD_FAV,
+	FIELD_PWPROTECT,
+	FIELD_ATTACH,
+	FIELD_MODIFIED,
+	FIELD_TOUCHED,
+	FIELD_PASSWORD,
+	FIELD_NOTES,
+	FIELD_CUSTOM,
+};
+
+/*
+ * Secret fields are only decrypted for the entries that need them,
+ * after the metadata predicates have been checked.
+ */
+static const struct query_field_info {
+	const char *name;
+	enum query_field field;
+	enum query_type type;
+	bool secret;
+} query_fields[] = {
+	{ "id", FIELD_ID, QUERY_STRING, false },
+	{ "name", FIELD_NAME, QUERY_STRING, false },
+	{ "fullname", FIELD_FULLNAME, QUERY_STRING, false },
+	{ "group", FIELD_GROUP, QUERY_STRING, false },
+	{ "share", FIELD_SHARE, QUERY_STRING, false },
+	{ "url", FIELD_URL, QUERY_STRING, false },
+	{ "host", FIELD_HOST, QUERY_STRING, false },
+	{ "username", FIELD_USERNAME, QUERY_STRING, false },
+	{ "fav", FIELD_FAV, QUERY_FLAG, false },
+	{ "pwprotect", FIELD_PWPROTECT, QUERY_FLAG, false },
+	{ "attach", FIELD_ATTACH, QUERY_FLAG, false },
+	{ "modified", FIELD_MODIFIED, QUERY_TIME, false },
+	{ "touched", FIELD_TOUCHED, QUERY_TIME, false },
+	{ "password", FIELD_PASSWORD, QUERY_STRING, true },
+	{ "notes", FIELD_NOTES, QUERY_STRING, true },
+};
+
+static const struct query_field_info custom_field_info = {
+	"field:", FIELD_CUSTOM, QUERY_STRING, true
+};
+
+struct query_ref {
+	const struct query_field_info *info;
+	char *custom_name;
+};
+
+enum query_op {
+	OP_EQ,
+	OP_NE,
+	OP_MATCH,
+	OP_NO_MATCH,
+	OP_LT,
+	OP_LE,
+	OP_GT,
+	OP_GE,
+};
+
+enum query_node_type {
+	NODE_AND,
+	NODE_OR,
+	NODE_NOT,
+	NODE_COMPARE,
+};
+
+struct query_node {
+	enum query_node_type type;
+	struct query_node *left, *right;
+
+	struct query_ref ref;
+	enum query_op op;
+	char *value;
+	bool flag;
+	time_t time;
+	regex_t regex;
+
+	/* rough evaluation cost, used to order the operands of and/or */
+	int cost;
+};
+
+enum token_type {
+	TOKEN_END,
+	TOKEN_LPAREN,
+	TOKEN_RPAREN,
+	TOKEN_AND,
+	TOKEN_OR,
+	TOKEN_NOT,
+	TOKEN_OP,
+	TOKEN_WORD,
+};
+
+struct query_parser {
+	const char *input;
+	const char *pos;
+
+	enum token_type token;
+	const char *token_start;
+	enum query_op op;
+	char *word;
+	bool quoted;
+};
+
+/* one entry being tested; secrets are decrypted on first use */
+struct query_row {
+	struct account *account;
+	struct account *expansion;
+	const unsigned char *key;
+	bool decrypted;
+	char *host;
+};
+
+static void _noreturn_ parse_error(struct query_parser *parser, const char *msg)
+{
+	die("Invalid query at position %zu: %s", (size_t)(parser->token_start - parser->input) + 1, msg);
+}
+
+static void next_token(struct query_parser *parser)
+{
+	const char *p = parser->pos;
+	char quote;
+
+	free(parser->word);
+	parser->word = NULL;
+	parser->quoted = false;
+
+	while (isspace((unsigned char)*p))
+		p++;
+	parser->token_start = p;
+
+	switch (*p) {
+	case '\0':
+		parser->token = TOKEN_END;
+		break;
+	case '(':
+		parser->token = TOKEN_LPAREN;
+		p++;
+		break;
+	case ')':
+		parser->token = TOKEN_RPAREN;
+		p++;
+		break;
+	case '&':
+		if (p[1] != '&')
+			parse_error(parser, "expected '&&'");
+		parser->token = TOKEN_AND;
+		p += 2;
+		break;
+	case '|':
+		if (p[1] != '|')
+			parse_error(parser, "expected '||'");
+		parser->token = TOKEN_OR;
+		p += 2;
+		break;
+	case '!':
+		parser->token = TOKEN_OP;
+		if (p[1] == '=') {
+			parser->op = OP_NE;
+			p += 2;
+		} else if (p[1] == '~') {
+			parser->op = OP_NO_MATCH;
+			p += 2;
+		} else {
+			parser->token = TOKEN_NOT;
+			p++;
+		}
+		break;
+	case '=':
+		parser->token = TOKEN_OP;
+		parser->op = OP_EQ;
+		p += p[1] == '=' ? 2 : 1;
+		break;
+	case '~':
+		parser->token = TOKEN_OP;
+		parser->op = OP_MATCH;
+		p++;
+		break;
+	case '<':
+	case '>':
+		parser->token = TOKEN_OP;
+		if (p[1] == '=')
+			parser->op = *p == '<' ? OP_LE : OP_GE;
+		else
+			parser->op = *p == '<' ? OP_LT : OP_GT;
+		p += p[1] == '=' ? 2 : 1;
+		break;
+	case '"':
+	case '\'':
+		quote = *p++;
+		parser->word = xcalloc(strlen(p) + 1, 1);
+		for (size_t len = 0; *p != quote; p++) {
+			if (!*p)
+				parse_error(parser, "unterminated string");
+			if (*p == '\\' && p[1])
+				p++;
+			parser->word[len++] = *p;
+		}
+		p++;
+		parser->token = TOKEN_WORD;
+		parser->quoted = true;
+		break;
+	default:
+		parser->token_start = p;
+		while (*p && !isspace((unsigned char)*p) && !strchr("()&|!=~<>\"'", *p))
+			p++;
+		parser->word = xstrndup(parser->token_start, p - parser->token_start);
+		parser->token = TOKEN_WORD;
+		if (!strcasecmp(parser->word, "and"))
+			parser->token = TOKEN_AND;
+		else if (!strcasecmp(parser->word, "or"))
+			parser->token = TOKEN_OR;
+		else if (!strcasecmp(parser->word, "not"))
+			parser->token = TOKEN_NOT;
+		break;
+	}
+	parser->pos = p;
+}
+
+static bool lookup_field(const char *name, struct query_ref *ref)
+{
+	size_t i;
+
+	ref->custom_name = NULL;
+	if (!strncmp(name, "field:", 6) && name[6]) {
+		ref->info = &custom_field_info;
+		ref->custom_name = xstrdup(name + 6);
+		return true;
+	}
+	for (i = 0; i < ARRAY_SIZE(query_fields); i++) {
+		if (!strcmp(name, query_fields[i].name)) {
+			ref->info = &query_fields[i];
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool parse_flag(const char *value, bool *flag)
+{
+	if (!strcmp(value, "true") || !strcmp(value, "yes") || !strcmp(value, "1"))
+		*flag = true;
+	else if (!strcmp(value, "false") || !strcmp(value, "no") || !strcmp(value, "0"))
+		*flag = false;
+	else
+		return false;
+	return true;
+}
+
+/* accepts seconds since the epoch or a UTC date, optionally with a time */
+static bool parse_time(const char *value, time_t *time)
+{
+	static const char *formats[] = {
+		"%Y-%m-%d %H:%M:%S", "%Y-%m-%dT%H:%M:%S",
+		"%Y-%m-%d %H:%M", "%Y-%m-%dT%H:%M", "%Y-%m-%d"
+	};
+	struct tm tm;
+	char *end;
+	size_t i;
+
+	if (!*value)
+		return false;
+
+	*time = strtoll(value, &end, 10);
+	if (!*end)
+		return true;
+
+	for (i = 0; i < ARRAY_SIZE(formats); i++) {
+		memset(&tm, 0, sizeof(tm));
+		end = strptime(value, formats[i], &tm);
+		if (end && (!*end || !strcmp(end, "Z"))) {
+			*time = timegm(&tm);
+			return true;
+		}
+	}
+	return false;
+}
+
+static struct query_node *new_compare(struct query_parser *parser, struct query_ref *ref,
+				      enum query_op op, const char *value)
+{
+	struct query_node *node = new0(struct query_node, 1);
+	int ret;
+
+	node->type = NODE_COMPARE;
+	node->ref = *ref;
+	node->op = op;
+	node->value = xstrdup(value);
+	node->cost = ref->info->secret ? 8 : 1;
+
+	switch (ref->info->type) {
+	case QUERY_FLAG:
+		if (op != OP_EQ && op != OP_NE)
+			parse_error(parser, "flags can only be compared with = or !=");
+		if (!parse_flag(value, &node->flag))
+			parse_error(parser, "expected true or false");
+		break;
+	case QUERY_TIME:
+		if (op == OP_MATCH || op == OP_NO_MATCH)
+			parse_error(parser, "times cannot be matched with ~");
+		if (!parse_time(value, &node->time))
+			parse_error(parser, "expected a date (YYYY-MM-DD [HH:MM[:SS]]) or a unix time");
+		break;
+	case QUERY_STRING:
+		if (op != OP_EQ && op != OP_NE && op != OP_MATCH && op != OP_NO_MATCH)
+			parse_error(parser, "text can only be compared with =, !=, ~ or !~");
+		if (op == OP_MATCH || op == OP_NO_MATCH) {
+			ret = regcomp(&node->regex, value, REG_EXTENDED | REG_ICASE | REG_NOSUB);
+			if (ret)
+				parse_error(parser, "invalid regular expression");
+			node->cost++;
+		}
+		break;
+	}
+	return node;
+}
+
+/*
+ * Combine two operands, putting the cheaper one first so that it
+ * short-circuits the other; evaluation has no side effects beyond
+ * decrypting, so the order doesn't change the result.
+ */
+static struct query_node *new_binary(enum query_node_type type,
+				     struct query_node *left,
+				     struct query_node *right)
+{
+	struct query_node *node = new0(struct query_node, 1);
+
+	node->type = type;
+	if (right->cost < left->cost) {
+		node->left = right;
+		node->right = left;
+	} else {
+		node->left = left;
+		node->right = right;
+	}
+	node->cost = left->cost + right->cost;
+	return node;
+}
+
+static struct query_node *parse_or(struct query_parser *parser);
+
+static struct query_node *parse_primary(struct query_parser *parser)
+{
+	struct query_node *node;
+	struct query_ref ref;
+	enum query_op op;
+
+	if (parser->token == TOKEN_LPAREN) {
+		next_token(parser);
+		node = parse_or(parser);
+		if (parser->token != TOKEN_RPAREN)
+			parse_error(parser, "expected ')'");
+		next_token(parser);
+		return node;
+	}
+
+	if (parser->token != TOKEN_WORD || parser->quoted)
+		parse_error(parser, "expected a field name");
+	if (!lookup_field(parser->word, &ref))
+		parse_error(parser, "unknown field");
+	next_token(parser);
+
+	if (parser->token != TOKEN_OP) {
+		/* a bare flag is true when set */
+		if (ref.info->type != QUERY_FLAG)
+			parse_error(parser, "expected a comparison");
+		return new_compare(parser, &ref, OP_EQ, "true");
+	}
+
+	op = parser->op;
+	next_token(parser);
+	if (parser->token != TOKEN_WORD)
+		parse_error(parser, "expected a value");
+	node = new_compare(parser, &ref, op, parser->word);
+	next_token(parser);
+	return node;
+}
+
+static struct query_node *parse_not(struct query_parser *parser)
+{
+	struct query_node *node;
+
+	if (parser->token != TOKEN_NOT)
+		return parse_primary(parser);
+
+	next_token(parser);
+	node = new0(struct query_node, 1);
+	node->type = NODE_NOT;
+	node->left = parse_not(parser);
+	node->cost = node->left->cost;
+	return node;
+}
+
+static struct query_node *parse_and(struct query_parser *parser)
+{
+	struct query_node *node = parse_not(parser);
+
+	while (parser->token == TOKEN_AND) {
+		next_token(parser);
+		node = new_binary(NODE_AND, node, parse_not(parser));
+	}
+	return node;
+}
+
+static struct query_node *parse_or(struct query_parser *parser)
+{
+	struct query_node *node = parse_and(parser);
+
+	while (parser->token == TOKEN_OR) {
+		next_token(parser);
+		node = new_binary(NODE_OR, node, parse_and(parser));
+	}
+	return node;
+}
+
+static struct query_node *query_parse(const char *input)
+{
+	struct query_parser parser = { .input = input, .pos = input };
+	struct query_node *node;
+
+	next_token(&parser);
+	if (parser.token == TOKEN_END)
+		return NULL;
+
+	node = parse_or(&parser);
+	if (parser.token != TOKEN_END)
+		parse_error(&parser, "unexpected text");
+	return node;
+}
+
+static void query_free(struct query_node *node)
+{
+	if (!node)
+		return;
+	query_free(node->left);
+	query_free(node->right);
+	if (node->type == NODE_COMPARE &&
+	    (node->op == OP_MATCH || node->op == OP_NO_MATCH))
+		regfree(&node->regex);
+	free(node->ref.custom_name);
+	free(node->value);
+	free(node);
+}
+
+/* the host part of a URL, lower-cased, without user info or port */
+static char *url_host(const char *url)
+{
+	const char *start = strstr(url, "://"), *end, *at;
+	char *host;
+
+	start = start ? start + 3 : url;
+	end = start + strcspn(start, "/?#");
+	at = memchr(start, '@', end - start);
+	if (at)
+		start = at + 1;
+	host = xstrndup(start, end - start);
+	if (host[0] != '[')
+		host[strcspn(host, ":")] = '\0';
+	strlower(host);
+	return host;
+}
+
+/* ask for the password once, the first time a protected entry is opened */
+static void reprompt(const unsigned char key[KDF_HASH_LEN])
+{
+	static bool authenticated;
+	unsigned char pwprotect_key[KDF_HASH_LEN];
+
+	if (authenticated)
+		return;
+	if (!agent_load_key(pwprotect_key))
+		die("Could not authenticate for protected entry.");
+	if (memcmp(pwprotect_key, key, KDF_HASH_LEN))
+		die("Current key is not on-disk key.");
+	authenticated = true;
+}
+
+static struct account *row_secrets(struct query_row *row)
+{
+	if (!row->decrypted) {
+		if (row->account->pwprotect)
+			reprompt(row->key);
+		account_decrypt_secrets(row->account, row->key);
+		row->expansion = notes_expand(row->account);
+		row->decrypted = true;
+	}
+	return row->expansion ? row->expansion : row->account;
+}
+
+static bool row_flag(struct query_row *row, enum query_field field)
+{
+	struct account *account = row->account;
+
+	switch (field) {
+	case FIELD_FAV:
+		return account->fav;
+	case FIELD_PWPROTECT:
+		return account->pwprotect;
+	case FIELD_ATTACH:
+		/* notes_expand() moves the attachments to the expansion */
+		return account->attachpresent || !list_empty(&account->attach_head) ||
+		       (row->expansion && !list_empty(&row->expansion->attach_head));
+	default:
+		return false;
+	}
+}
+
+/* the text of a field, or NULL if the entry doesn't have it */
+static const char *row_string(struct query_row *row, const struct query_ref *ref)
+{
+	struct account *account = row->account;
+	struct field *field;
+
+	switch (ref->info->field) {
+	case FIELD_ID:
+		return account->id;
+	case FIELD_NAME:
+		return account->name;
+	case FIELD_FULLNAME:
+		return account->fullname;
+	case FIELD_GROUP:
+		return account->group;
+	case FIELD_SHARE:
+		return account->share ? account->share->name : "";
+	case FIELD_URL:
+		return account->url;
+	case FIELD_HOST:
+		if (!row->host)
+			row->host = url_host(account->url);
+		return row->host;
+	case FIELD_USERNAME:
+		/* a secure note keeps its username in the note text */
+		if (account_is_secure_note(account))
+			return row_secrets(row)->username;
+		return account->username;
+	case FIELD_MODIFIED:
+		return account->last_modified_gmt;
+	case FIELD_TOUCHED:
+		return account->last_touch;
+	case FIELD_FAV:
+	case FIELD_PWPROTECT:
+	case FIELD_ATTACH:
+		return row_flag(row, ref->info->field) ? "true" : "false";
+	case FIELD_PASSWORD:
+		return row_secrets(row)->password;
+	case FIELD_NOTES:
+		return row_secrets(row)->note;
+	case FIELD_CUSTOM:
+		list_for_each_entry(field, &row_secrets(row)->field_head, list) {
+			if (!strcmp(field->name, ref->custom_name))
+				return field->value;
+		}
+		return NULL;
+	}
+	return NULL;
+}
+
+static bool query_eval(struct query_node *node, struct query_row *row)
+{
+	const char *value;
+	time_t time;
+	bool result = false;
+
+	if (!node)
+		return true;
+
+	switch (node->type) {
+	case NODE_AND:
+		return query_eval(node->left, row) && query_eval(node->right, row);
+	case NODE_OR:
+		return query_eval(node->left, row) || query_eval(node->right, row);
+	case NODE_NOT:
+		return !query_eval(node->left, row);
+	case NODE_COMPARE:
+		break;
+	}
+
+	switch (node->ref.info->type) {
+	case QUERY_FLAG:
+		return (row_flag(row, node->ref.info->field) == node->flag) == (node->op == OP_EQ);
+	case QUERY_TIME:
+		value = row_string(row, &node->ref);
+		time = value ? strtoll(value, NULL, 10) : 0;
+		switch (node->op) {
+		case OP_EQ: return time == node->time;
+		case OP_NE: return time != node->time;
+		case OP_LT: return time < node->time;
+		case OP_LE: return time <= node->time;
+		case OP_GT: return time > node->time;
+		case OP_GE: return time >= node->time;
+		default: return false;
+		}
+	case QUERY_STRING:
+		value = row_string(row, &node->ref);
+		if (!value)
+			value = "";
+		switch (node->op) {
+		case OP_EQ:
+		case OP_NE:
+			result = !strcmp(value, node->value);
+			break;
+		case OP_MATCH:
+		case OP_NO_MATCH:
+			result = !regexec(&node->regex, value, 0, NULL, 0);
+			break;
+		default:
+			break;
+		}
+		return node->op == OP_EQ || node->op == OP_MATCH ? result : !result;
+	}
+	return false;
+}
+
+static void parse_select(const char *list, struct query_ref **refs, size_t *count)
+{
+	_cleanup_free_ char *copy = xstrdup(list);
+	char *name, *rest = copy;
+
+	*count = 0;
+	*refs = xcalloc(strlen(list) + 1, sizeof(**refs));
+	while ((name = strsep(&rest, ",")) != NULL) {
+		name = trim(name);
+		if (!*name)
+			continue;
+		if (!lookup_field(name, &(*refs)[*count]))
+			die("Unknown field '%s' in --select.", name);
+		(*count)++;
+	}
+	if (!*count)
+		die("No fields given to --select.");
+}
+
+static void print_tsv_value(const char *value)
+{
+	for (; *value; value++) {
+		switch (*value) {
+		case '\t': fputs("\\t", stdout); break;
+		case '\n': fputs("\\n", stdout); break;
+		case '\r': fputs("\\r", stdout); break;
+		case '\\': fputs("\\\\", stdout); break;
+		default: putchar(*value); break;
+		}
+	}
+}
+
+static void print_row(struct query_row *row, struct query_ref *refs, size_t count, bool json)
+{
+	const char *value;
+	size_t i;
+
+	if (json)
+		putchar('{');
+	for (i = 0; i < count; i++) {
+		value = row_string(row, &refs[i]);
+		if (json) {
+			if (i)
+				putchar(',');
+			if (refs[i].custom_name) {
+				_cleanup_free_ char *key = NULL;
+
+				xasprintf(&key, "field:%s", refs[i].custom_name);
+				json_print_quoted_string(key);
+			} else {
+				json_print_quoted_string(refs[i].info->name);
+			}
+			putchar(':');
+			if (!value)
+				fputs("null", stdout);
+			else if (refs[i].info->type == QUERY_FLAG)
+				fputs(value, stdout);
+			else
+				json_print_quoted_string(value);
+		} else {
+			if (i)
+				putchar('\t');
+			if (value)
+				print_tsv_value(value);
+		}
+	}
+	if (json)
+		putchar('}');
+	putchar('\n');
+}
+
+static int compare_row(const void *a, const void *b)
+{
+	const struct query_row *row_a = a;
+	const struct query_row *row_b = b;
+
+	return strcmp(row_a->account->fullname, row_b->account->fullname);
+}
+
+int cmd_query(int argc, char **argv)
+{
+	unsigned char key[KDF_HASH_LEN];
+	struct session *session = NULL;
+	struct blob *blob = NULL;
+	static struct option long_options[] = {
+		{"sync", required_argument, NULL, 'S'},
+		{"select", required_argument, NULL, 's'},
+		{"json", no_argument, NULL, 'j'},
+		{"color", required_argument, NULL, 'C'},
+		{0, 0, 0, 0}
+	};
+	int option;
+	int option_index;
+	enum blobsync sync = BLOB_SYNC_AUTO;
+	const char *select = "id,fullname";
+	bool json = false;
+	_cleanup_free_ struct query_ref *refs = NULL;
+	_cleanup_free_ struct query_row *rows = NULL;
+	struct query_node *query;
+	struct query_row row;
+	struct account *account;
+	size_t ref_count, row_count = 0, i;
+
+	while ((option = getopt_long(argc, argv, "j", long_options, &option_index)) != -1) {
+		switch (option) {
+			case 'S':
+				sync = parse_sync_string(optarg);
+				break;
+			case 's':
+				select = optarg;
+				break;
+			case 'j':
+				json = true;
+				break;
+			case 'C':
+				terminal_set_color_mode(
+					parse_color_mode_string(optarg));
+				break;
+			case '?':
+			default:
+				die_usage(cmd_query_usage);
+		}
+	}
+
+	if (argc - optind > 1)
+		die_usage(cmd_query_usage);
+
+	/* check the query before asking for the vault */
+	query = query_parse(argc - optind ? argv[optind] : "");
+	parse_select(select, &refs, &ref_count);
+
+	init_all_lazy(sync, key, &session, &blob);
+
+	list_for_each_entry(account, &blob->account_head, list)
+		row_count++;
+	rows = xcalloc(row_count ? row_count : 1, sizeof(*rows));
+
+	row_count = 0;
+	list_for_each_entry(account, &blob->account_head, list) {
+		if (account_is_group(account))
+			continue;
+		row = (struct query_row) { .account = account, .key = key };
+		if (query_eval(query, &row)) {
+			rows[row_count++] = row;
+		} else {
+			account_free(row.expansion);
+			free(row.host);
+		}
+	}
+	qsort(rows, row_count, sizeof(*rows), compare_row);
+
+	for (i = 0; i < row_count; i++) {
+		print_row(&rows[i], refs, ref_count, json);
+		account_free(rows[i].expansion);
+		free(rows[i].host);
+	}
+
+	for (i = 0; i < ref_count; i++)
+		free(refs[i].custom_name);
+	query_free(query);
+	session_free(session);
+	blob_free(blob);
+	return 0;
+}
@@ -52,15 +52,20 @@ int cmd_rm(int argc, char **argv)
 	static struct option long_options[] = {
 		{"sync", required_argument, NULL, 'S'},
 		{"color", required_argument, NULL, 'C'},
+		{"basic-regexp", no_argument, NULL, 'G'},
+		{"fixed-strings", no_argument, NULL, 'F'},
+		{"folder", required_argument, NULL, 'f'},
 		{0, 0, 0, 0}
 	};
 	int option;
 	int option_index;
-	char *name;
+	char *folder = NULL;
 	enum blobsync sync = BLOB_SYNC_AUTO;
-	struct account *found;
+	enum search_type search = SEARCH_EXACT_MATCH;
+	struct list_head targets;
+	struct account *found, *tmp;
 
-	while ((option = getopt_long(argc, argv, "", long_options, &option_index)) != -1) {
+	while ((option = getopt_long(argc, argv, "GF", long_options, &option_index)) != -1) {
 		switch (option) {
 			case 'S':
 				sync = parse_sync_string(optarg);
@@ -69,28 +74,42 @@ int cmd_rm(int argc, char **argv)
 				terminal_set_color_mode(
 					parse_color_mode_string(optarg));
 				break;
+			case 'G':
+				search = SEARCH_BASIC_REGEX;
+				break;
+			case 'F':
+				search = SEARCH_FIXED_SUBSTRING;
+				break;
+			case 'f':
+				folder = optarg;
+				break;
 			case '?':
 			default:
 				die_usage(cmd_rm_usage);
 		}
 	}
 
-	if (argc - optind != 1)
+	if (argc - optind < (folder ? 0 : 1))
 		die_usage(cmd_rm_usage);
-	name = argv[optind];
 
 	init_all(sync, key, &session, &blob);
-	found = find_unique_account(blob, name);
-	if (!found)
-		die("Could not find specified account '%s'.", name);
-	if (found->share && found->share->readonly)
-		die("%s is a readonly shared entry from %s. It cannot be deleted.", found->fullname, found->share->name);
 
-	list_del(&found->list);
+	INIT_LIST_HEAD(&targets);
+	find_target_accounts(blob, search, folder, &argv[optind],
+			     argc - optind, &targets);
 
-	lastpass_remove_account(sync, key, session, found, blob);
+	/* refuse the whole batch before removing anything */
+	list_for_each_entry(found, &targets, match_list) {
+		if (found->share && found->share->readonly)
+			die("%s is a readonly shared entry from %s. It cannot be deleted.", found->fullname, found->share->name);
+	}
+
+	list_for_each_entry_safe(found, tmp, &targets, match_list) {
+		list_del(&found->list);
+		lastpass_remove_account(sync, key, session, found, blob);
+		account_free(found);
+	}
 	blob_save(blob, key, &session->feature_flag);
-	account_free(found);
 
 	session_free(session);
 	blob_free(blob);
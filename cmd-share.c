@@ -39,6 +39,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <errno.h>
+#include <pthread.h>
 
 struct share_args {
 	struct session *session;
@@ -74,7 +75,7 @@ struct share_command {
 #define share_usermod_usage "usermod [--read-only=[true|false] --hidden=[true|false] --admin=[true|false] SHARE USERNAME"
 #define share_userdel_usage "userdel SHARE USERNAME"
 #define share_create_usage "create SHARE"
-#define share_limit_usage "limit [--deny|--allow] [--add|--rm|--clear] SHARE USERNAME [sites]"
+#define share_limit_usage "limit [--deny|--allow] [--add|--rm|--clear] SHARE USERNAME[,USERNAME...] [sites]"
 #define share_rm_usage "rm SHARE"
 
 static char *checkmark(int x) {
@@ -228,13 +229,83 @@ static int share_userdel(struct share_command *cmd, int argc, char **argv,
 	return 0;
 }
 
+/*
+ * The aids of a limit, in an open-addressed hash set, so that checking
+ * the sites of a share against it does not walk the list for each one.
+ * Removed aids leave a tombstone, so the set is sized up front for the
+ * aids that may be added.
+ */
+struct aid_set {
+	struct share_limit_aid **slots;
+	size_t mask;
+};
+
+static struct share_limit_aid aid_removed;
+
+static size_t aid_hash(const char *aid)
+{
+	size_t hash = 2166136261u;
+
+	for (; *aid; aid++)
+		hash = (hash ^ (unsigned char) *aid) * 16777619u;
+	return hash;
+}
+
+static struct share_limit_aid **aid_set_slot(struct aid_set *set, const char *aid)
+{
+	struct share_limit_aid **tombstone = NULL;
+	size_t i;
+
+	for (i = aid_hash(aid) & set->mask; ; i = (i + 1) & set->mask) {
+		if (!set->slots[i])
+			return tombstone ? tombstone : &set->slots[i];
+		if (set->slots[i] == &aid_removed) {
+			if (!tombstone)
+				tombstone = &set->slots[i];
+		} else if (!strcmp(set->slots[i]->aid, aid)) {
+			return &set->slots[i];
+		}
+	}
+}
+
+static struct share_limit_aid *aid_set_find(struct aid_set *set, const char *aid)
+{
+	struct share_limit_aid *found = *aid_set_slot(set, aid);
+
+	return found == &aid_removed ? NULL : found;
+}
+
+static void aid_set_init(struct aid_set *set, struct share_limit *limit, size_t extra)
+{
+	struct share_limit_aid *aid;
+	size_t size = 16;
+
+	list_for_each_entry(aid, &limit->aid_list, list)
+		extra++;
+	while (size < extra * 2)
+		size *= 2;
+	set->slots = xcalloc(size, sizeof(*set->slots));
+	set->mask = size - 1;
+
+	list_for_each_entry(aid, &limit->aid_list, list)
+		*aid_set_slot(set, aid->aid) = aid;
+}
+
+static void aid_set_free(struct aid_set *set)
+{
+	free(set->slots);
+	set->slots = NULL;
+}
+
 static void print_share_limits(struct blob *blob, struct share *share,
 			       struct share_limit *limit)
 {
 	struct account *account;
-	struct share_limit_aid *aid;
+	struct aid_set set;
 	char sitename[80];
 
+	aid_set_init(&set, limit, 0);
+
 	/* display current settings for this user */
 	terminal_printf(TERMINAL_FG_YELLOW TERMINAL_BOLD
 			"%-60s %7s %5s" TERMINAL_RESET "\n",
@@ -244,12 +315,7 @@ static void print_share_limits(struct blob *blob, struct share *share,
 		if (account->share != share)
 			continue;
 
-		bool in_list = false;
-		list_for_each_entry(aid, &limit->aid_list, list) {
-			if (!strcmp(aid->aid, account->id)) {
-				in_list = true;
-			}
-		}
+		bool in_list = aid_set_find(&set, account->id) != NULL;
 
 		bool avail = (in_list && limit->whitelist) ||
 			(!in_list && !limit->whitelist);
@@ -263,18 +329,152 @@ static void print_share_limits(struct blob *blob, struct share *share,
 				sitename, checkmark(!avail), checkmark(avail));
 
 	}
+	aid_set_free(&set);
+}
+
+/* Add the matching sites to a limit, or remove them from it. */
+static void change_share_limit(struct share_args *args, struct share_limit *limit,
+			       struct list_head *matches, size_t n_matches)
+{
+	struct account *account;
+	struct share_limit_aid *aid, *tmp, **slot;
+	struct aid_set set;
+
+	if (args->clear) {
+		list_for_each_entry_safe(aid, tmp, &limit->aid_list, list) {
+			list_del(&aid->list);
+			free(aid->aid);
+		}
+	}
+
+	aid_set_init(&set, limit, n_matches);
+	list_for_each_entry(account, matches, match_list) {
+		slot = aid_set_slot(&set, account->id);
+		aid = *slot == &aid_removed ? NULL : *slot;
+
+		if (!aid && (args->add || args->clear)) {
+			struct share_limit_aid *newaid =
+				new0(struct share_limit_aid, 1);
+			newaid->aid = account->id;
+			list_add_tail(&newaid->list, &limit->aid_list);
+			*slot = newaid;
+		}
+		else if (aid && args->remove) {
+			list_del(&aid->list);
+			*slot = &aid_removed;
+		}
+	}
+	aid_set_free(&set);
+
+	limit->whitelist = args->whitelist;
+}
+
+#define SHARE_LIMIT_JOBS 4
+
+struct limit_update {
+	struct share_user *user;
+	struct share_limit limit;
+};
+
+struct limit_updates {
+	struct share_args *args;
+	struct limit_update *updates;
+	size_t count;
+	size_t next;
+	pthread_mutex_t lock;
+};
+
+static void *set_limits_worker(void *arg)
+{
+	struct limit_updates *state = arg;
+	struct limit_update *update;
+
+	for (;;) {
+		pthread_mutex_lock(&state->lock);
+		update = state->next < state->count ?
+			&state->updates[state->next++] : NULL;
+		pthread_mutex_unlock(&state->lock);
+
+		if (!update)
+			return NULL;
+		lastpass_share_set_limits(state->args->session, state->args->share,
+					  update->user, &update->limit);
+	}
 }
 
+/* Send the new limits, with up to SHARE_LIMIT_JOBS requests in flight. */
+static void set_share_limits(struct share_args *args, struct limit_update *updates,
+			     size_t count)
+{
+	struct limit_updates state = {
+		.args = args,
+		.updates = updates,
+		.count = count,
+	};
+	pthread_t threads[SHARE_LIMIT_JOBS - 1];
+	size_t n_threads, i;
+
+	pthread_mutex_init(&state.lock, NULL);
+	n_threads = min(ARRAY_SIZE(threads), count - 1);
+	for (i = 0; i < n_threads; i++) {
+		if (pthread_create(&threads[i], NULL, set_limits_worker, &state))
+			break;
+	}
+	set_limits_worker(&state);
+	n_threads = i;
+	for (i = 0; i < n_threads; i++)
+		pthread_join(threads[i], NULL);
+	pthread_mutex_destroy(&state.lock);
+}
+
+/*
+ * Find the users named in a comma-separated list among those of the
+ * share, with a single getinfo request.
+ */
+static size_t find_share_users(struct share_args *args, char *names,
+			       struct limit_update **ret)
+{
+	LIST_HEAD(users);
+	struct share_user *user, *found;
+	struct limit_update *updates;
+	char *name;
+	size_t count = 1, n = 0;
+
+	for (name = names; *name; name++)
+		count += *name == ',';
+	updates = new0(struct limit_update, count);
+
+	if (lastpass_share_getinfo(args->session, args->share->id, &users))
+		die("Unable to access user list for share %s\n", args->share->name);
+
+	while ((name = strsep(&names, ","))) {
+		if (!*name)
+			continue;
+		found = NULL;
+		list_for_each_entry(user, &users, list) {
+			if (!strcmp(user->username, name)) {
+				found = user;
+				break;
+			}
+		}
+		if (!found)
+			die("Unable to find user %s in the user list\n", name);
+		updates[n++].user = found;
+	}
+
+	*ret = updates;
+	return n;
+}
 
 static int share_limit(struct share_command *cmd, int argc, char **argv,
 		       struct share_args *args)
 {
-	struct share_user *found;
-	struct share_limit limit;
+	_cleanup_free_ struct limit_update *updates = NULL;
+	struct share_limit *limit;
 	struct account *account;
-	struct share_limit_aid *aid, *tmp;
 	struct blob *blob = args->blob;
-	bool changed_list_type;
+	size_t n_users, n_changed = 0, n_matches = 0, i;
+	bool specified_limit_type = args->specified_limit_type;
 	int optind;
 
 	struct list_head potential_set;
@@ -283,30 +483,46 @@ static int share_limit(struct share_command *cmd, int argc, char **argv,
 	if (argc < 1)
 		die_share_usage(cmd);
 
-	found = get_user_from_share(args->session, args->share, argv[0]);
-	lastpass_share_get_limits(args->session, args->share, found, &limit);
-
-	if (!args->specified_limit_type)
-		args->whitelist = limit.whitelist;
-
-	/*
-	 * prompt if we switch list type and there are entries already, in
-	 * order to avoid accidentally changing a blacklist to a whitelist
-	 */
-	changed_list_type = args->whitelist != limit.whitelist &&
-			    !list_empty(&limit.aid_list);
+	n_users = find_share_users(args, argv[0], &updates);
+	if (!n_users)
+		die_share_usage(cmd);
+	for (i = 0; i < n_users; i++) {
+		limit = &updates[i].limit;
+		lastpass_share_get_limits(args->session, args->share,
+					  updates[i].user, limit);
+		if (!specified_limit_type)
+			args->whitelist = limit->whitelist;
+
+		/*
+		 * prompt if we switch list type and there are entries already, in
+		 * order to avoid accidentally changing a blacklist to a whitelist
+		 */
+		if (args->whitelist != limit->whitelist &&
+		    !list_empty(&limit->aid_list))
+			n_changed++;
+	}
 
-	if (argc == 1 && !changed_list_type) {
+	if (argc == 1 && !n_changed) {
 		/* nothing to do, just print current limits */
-		print_share_limits(blob, args->share, &limit);
+		for (i = 0; i < n_users; i++) {
+			if (n_users > 1)
+				terminal_printf(TERMINAL_FG_GREEN "%s" TERMINAL_RESET " (%s)\n",
+						updates[i].user->username,
+						updates[i].limit.whitelist ? "default deny" : "default allow");
+			print_share_limits(blob, args->share, &updates[i].limit);
+		}
 		return 0;
 	}
 
-	if (changed_list_type) {
-		bool isok = ask_yes_no(false,
+	if (n_changed) {
+		bool isok = n_users == 1 ?
+			ask_yes_no(false,
 			"Supplied limit type (%s) doesn't match existing list (%s).\nContinue and switch?",
 			args->whitelist ? "default deny" : "default allow",
-			limit.whitelist ? "default deny" : "default allow");
+			updates[0].limit.whitelist ? "default deny" : "default allow") :
+			ask_yes_no(false,
+			"Supplied limit type (%s) doesn't match the existing list of %zu users.\nContinue and switch?",
+			args->whitelist ? "default deny" : "default allow", n_changed);
 
 		if (!isok)
 			die("Aborted.");
@@ -326,42 +542,32 @@ static int share_limit(struct share_command *cmd, int argc, char **argv,
 		char *name = argv[optind];
 		find_matching_accounts(&potential_set, name, &matches);
 	}
+	list_for_each_entry(account, &matches, match_list)
+		n_matches++;
 
-	if (args->clear) {
-		list_for_each_entry_safe(aid, tmp, &limit.aid_list, list) {
-			list_del(&aid->list);
-			free(aid->aid);
-		}
+	for (i = 0; i < n_users; i++) {
+		if (!specified_limit_type)
+			args->whitelist = updates[i].limit.whitelist;
+		change_share_limit(args, &updates[i].limit, &matches, n_matches);
 	}
 
-	list_for_each_entry(account, &matches, match_list) {
-
-		/* add account to share_limit */
-		bool in_list = false;
-		list_for_each_entry(aid, &limit.aid_list, list) {
-			if (!strcmp(aid->aid, account->id)) {
-				in_list = true;
-				break;
-			}
-		}
+	set_share_limits(args, updates, n_users);
 
-		if ((!in_list && args->add) || args->clear) {
-			struct share_limit_aid *newaid =
-				new0(struct share_limit_aid, 1);
-			newaid->aid = account->id;
-			list_add_tail(&newaid->list, &limit.aid_list);
-		}
-		else if (in_list && args->remove) {
-			list_del(&aid->list);
-		}
+	if (n_users == 1) {
+		print_share_limits(blob, args->share, &updates[0].limit);
+		return 0;
+	}
+	for (i = 0; i < n_users; i++) {
+		size_t n_aids = 0;
+		struct share_limit_aid *aid;
+
+		limit = &updates[i].limit;
+		list_for_each_entry(aid, &limit->aid_list, list)
+			n_aids++;
+		terminal_printf(TERMINAL_FG_GREEN "%-40s" TERMINAL_RESET " %s, %zu sites listed\n",
+				updates[i].user->username,
+				limit->whitelist ? "default deny" : "default allow", n_aids);
 	}
-
-	limit.whitelist = args->whitelist;
-
-	lastpass_share_set_limits(args->session, args->share, found, &limit);
-
-	print_share_limits(blob, args->share, &limit);
-
 	return 0;
 }
 
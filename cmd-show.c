@@ -44,10 +44,12 @@
 #include "clipboard.h"
 #include "format.h"
 #include "json-format.h"
+#include "usage.h"
 #include <getopt.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <ctype.h>
 
 /*
@@ -260,6 +262,7 @@ int cmd_show(int argc, char **argv)
 		{"notes", no_argument, NULL, 'O'},
 		{"attach", required_argument, NULL, 'a'},
 		{"clip", no_argument, NULL, 'c'},
+		{"clear-after", required_argument, NULL, 'T'},
 		{"color", required_argument, NULL, 'C'},
 		{"basic-regexp", no_argument, NULL, 'G'},
 		{"fixed-strings", no_argument, NULL, 'F'},
@@ -282,6 +285,8 @@ int cmd_show(int argc, char **argv)
 	struct app *app;
 	enum blobsync sync = BLOB_SYNC_AUTO;
 	bool clip = false;
+	unsigned long clear_after = 0;
+	char *end;
 	bool json = false;
 	bool expand_multi = false;
 	bool quiet = false;
@@ -340,6 +345,11 @@ int cmd_show(int argc, char **argv)
 			case 'c':
 				clip = true;
 				break;
+			case 'T':
+				clear_after = strtoul(optarg, &end, 10);
+				if (!*optarg || *end || !clear_after || clear_after > UINT32_MAX)
+					die_usage(cmd_show_usage);
+				break;
 			case 'C':
 				terminal_set_color_mode(
 					parse_color_mode_string(optarg));
@@ -362,7 +372,7 @@ int cmd_show(int argc, char **argv)
 		}
 	}
 
-	if (argc - optind < 1)
+	if (argc - optind < 1 || (clear_after && !clip))
 		die_usage(cmd_show_usage);
 
 	if (argc - optind > 1) {
@@ -416,7 +426,11 @@ int cmd_show(int argc, char **argv)
 	found = list_first_entry(&matches, struct account, match_list);
 	last_found = list_last_entry(&matches, struct account, match_list);
 	if (found != last_found && !expand_multi) {
-		/* Multiple matches; dump the ids and exit */
+		/* Multiple matches; dump the ids, most used first, and exit */
+		struct usage *usage = usage_load(key);
+
+		usage_sort_matches(&matches, usage);
+		usage_free(usage);
 		terminal_printf(TERMINAL_FG_YELLOW TERMINAL_BOLD "Multiple matches found.\n");
 		list_for_each_entry(found, &matches, match_list)
 			print_header(title_format, found);
@@ -435,8 +449,12 @@ int cmd_show(int argc, char **argv)
 		}
 	}
 
-	if (clip)
+	usage_record_matches(&matches, blob, key);
+
+	if (clip) {
+		clipboard_set_clear_after(clear_after);
 		clipboard_open();
+	}
 
 	if (json) {
 		json_format_account_list(&matches);
@@ -40,6 +40,7 @@
 #include "terminal.h"
 #include "kdf.h"
 #include "upload-queue.h"
+#include "session.h"
 #include <getopt.h>
 #include <stdio.h>
 #include <string.h>
@@ -73,6 +74,13 @@ int cmd_status(int argc, char **argv)
 		}
 	}
 
+	if (session_login_pending()) {
+		if(!quiet) {
+			terminal_printf(TERMINAL_FG_YELLOW TERMINAL_BOLD "Waiting" TERMINAL_RESET " for approval of a background login.\n");
+		}
+		return 1;
+	}
+
 	if (!agent_ask(key)) {
 		if(!quiet) {
 			terminal_printf(TERMINAL_FG_RED TERMINAL_BOLD "Not logged in" TERMINAL_RESET ".\n");
@@ -37,12 +37,17 @@
 #include "agent.h"
 #include "blob.h"
 #include "session.h"
+#include "config.h"
 #include "util.h"
 #include "process.h"
 #include <strings.h>
 #include <string.h>
 #include <regex.h>
 
+static char password_chars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890`~!@#$%^&*()-_=+[{]}\\|;:'\",<.>/?";
+#define ALL_CHARS_LEN (sizeof(password_chars) - 1)
+#define NICE_CHARS_LEN 62
+
 enum blobsync parse_sync_string(const char *syncstr)
 {
 	if (!syncstr || !strcasecmp(syncstr, "auto"))
@@ -89,22 +94,47 @@ enum note_type parse_note_type_string(const char *extra)
 	return result;
 }
 
-void init_all(enum blobsync sync, unsigned char key[KDF_HASH_LEN], struct session **session, struct blob **blob)
+static void init(enum blobsync sync, unsigned char key[KDF_HASH_LEN],
+		 struct session **session, struct blob **blob, bool lazy_secrets)
 {
+	session_login_wait();
+
+	/*
+	 * The blob is read while the key is fetched, and verified and
+	 * decrypted while the session is loaded.
+	 */
+	if (blob)
+		config_prefetch("blob");
+
 	if (!agent_get_decryption_key(key))
 		die("Could not find decryption key. Perhaps you need to login with `%s login`.", ARGV[0]);
+	config_prefetch_key(key);
 
 	*session = session_load(key);
 	if (!*session)
 		die("Could not find session. Perhaps you need to login with `%s login`.", ARGV[0]);
 
 	if (blob) {
-		*blob = blob_load(sync, *session, key);
+		*blob = blob_load(sync, *session, key, lazy_secrets);
 		if (!*blob)
 			die("Unable to fetch blob. Either your session is invalid and you need to login with `%s login`, you need to synchronize, your blob is empty, or there is something wrong with your internet connection.", ARGV[0]);
 	}
 }
 
+void init_all(enum blobsync sync, unsigned char key[KDF_HASH_LEN], struct session **session, struct blob **blob)
+{
+	init(sync, key, session, blob, false);
+}
+
+/*
+ * Like init_all(), but the blob's secrets are only decrypted when
+ * account_decrypt_secrets() asks for them; for read-only commands.
+ */
+void init_all_lazy(enum blobsync sync, unsigned char key[KDF_HASH_LEN], struct session **session, struct blob **blob)
+{
+	init(sync, key, session, blob, true);
+}
+
 /*
  * cmp_regex - do regex comparison with a basic regex
  */
@@ -233,3 +263,87 @@ struct account *find_unique_account(struct blob *blob, const char *name)
 
 	return account;
 }
+
+/*
+ * Search accounts for those filed in a folder or any of its subfolders,
+ * including the folder's own group entries.
+ */
+void find_folder_accounts(struct list_head *accounts, const char *folder,
+			  struct list_head *ret_list)
+{
+	struct account *account, *tmp;
+	size_t len = strlen(folder);
+
+	list_for_each_entry_safe(account, tmp, accounts, match_list) {
+		if (strncmp(account->fullname, folder, len) ||
+		    (account->fullname[len] != '/' &&
+		     account->fullname[len] != '\\'))
+			continue;
+		list_del(&account->match_list);
+		list_add_tail(&account->match_list, ret_list);
+	}
+}
+
+/*
+ * Gather the accounts a bulk command operates on into ret_list: every
+ * account in @folder, if given, plus those matching each of @names.
+ * Exact names must each identify a single account; patterns may match
+ * any number.  An account is only returned once.  Dies if nothing
+ * matches.
+ */
+void find_target_accounts(struct blob *blob, enum search_type search,
+			  const char *folder, char **names, int count,
+			  struct list_head *ret_list)
+{
+	struct list_head potential_set, matches;
+	struct account *account, *tmp;
+	int fields = ACCOUNT_NAME | ACCOUNT_ID | ACCOUNT_FULLNAME;
+	int i;
+
+	INIT_LIST_HEAD(&potential_set);
+
+	list_for_each_entry(account, &blob->account_head, list)
+		list_add_tail(&account->match_list, &potential_set);
+
+	if (folder)
+		find_folder_accounts(&potential_set, folder, ret_list);
+
+	for (i = 0; i < count; i++) {
+		INIT_LIST_HEAD(&matches);
+		switch (search) {
+		case SEARCH_EXACT_MATCH:
+			find_matching_accounts(&potential_set, names[i], &matches);
+			if (list_empty(&matches))
+				die("Could not find specified account '%s'.", names[i]);
+			if (matches.next != matches.prev)
+				die("Multiple matches found for '%s'. You must specify an ID instead of a name.", names[i]);
+			break;
+		case SEARCH_BASIC_REGEX:
+			find_matching_regex(&potential_set, names[i], fields, &matches);
+			break;
+		case SEARCH_FIXED_SUBSTRING:
+			find_matching_substr(&potential_set, names[i], fields, &matches);
+			break;
+		}
+		list_for_each_entry_safe(account, tmp, &matches, match_list) {
+			list_del(&account->match_list);
+			list_add_tail(&account->match_list, ret_list);
+		}
+	}
+
+	if (list_empty(ret_list))
+		die("Could not find any matching accounts.");
+}
+
+/*
+ * Return a new random password of length characters, only letters and
+ * digits if no_symbols is set.
+ */
+char *generate_password(unsigned long length, bool no_symbols)
+{
+	char *password = xcalloc(length + 1, 1);
+
+	for (size_t i = 0; i < length; ++i)
+		password[i] = password_chars[range_rand(0, no_symbols ? NICE_CHARS_LEN : ALL_CHARS_LEN)];
+	return password;
+}
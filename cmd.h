@@ -37,6 +37,7 @@ enum edit_choice
 };
 
 void init_all(enum blobsync sync, unsigned char key[KDF_HASH_LEN], struct session **session, struct blob **blob);
+void init_all_lazy(enum blobsync sync, unsigned char key[KDF_HASH_LEN], struct session **session, struct blob **blob);
 enum blobsync parse_sync_string(const char *str);
 struct account *find_unique_account(struct blob *blob, const char *name);
 void find_matching_accounts(struct list_head *accounts, const char *name,
@@ -45,7 +46,13 @@ void find_matching_regex(struct list_head *accounts, const char *pattern,
 			 int fields, struct list_head *ret_list);
 void find_matching_substr(struct list_head *accounts, const char *pattern,
 			  int fields, struct list_head *ret_list);
+void find_folder_accounts(struct list_head *accounts, const char *folder,
+			  struct list_head *ret_list);
+void find_target_accounts(struct blob *blob, enum search_type search,
+			  const char *folder, char **names, int count,
+			  struct list_head *ret_list);
 enum color_mode parse_color_mode_string(const char *colormode);
+char *generate_password(unsigned long length, bool no_symbols);
 bool parse_bool_arg_string(const char *extra);
 enum note_type parse_note_type_string(const char *extra);
 
@@ -69,10 +76,17 @@ int edit_new_account(struct session *session,
 		     enum note_type note_type,
 		     unsigned char key[KDF_HASH_LEN]);
 
+int add_new_accounts(struct session *session,
+		     struct blob *blob,
+		     enum blobsync sync,
+		     FILE *input,
+		     enum note_type note_type,
+		     unsigned char key[KDF_HASH_LEN]);
+
 #define color_usage "[--color=auto|never|always]"
 
 int cmd_login(int argc, char **argv);
-#define cmd_login_usage "login [--trust] [--sso] [--plaintext-key [--force, -f]] " color_usage " USERNAME"
+#define cmd_login_usage "login [--trust] [--sso] [--background] [--plaintext-key [--force, -f]] " color_usage " USERNAME"
 
 int cmd_logout(int argc, char **argv);
 #define cmd_logout_usage "logout [--force, -f] " color_usage
@@ -81,13 +95,19 @@ int cmd_passwd(int argc, char **argv);
 #define cmd_passwd_usage "passwd"
 
 int cmd_show(int argc, char **argv);
-#define cmd_show_usage "show [--sync=auto|now|no] [--clip, -c] [--quiet, -q] [--expand-multi, -x] [--json, -j] [--all|--username|--password|--url|--notes|--field=FIELD|--id|--name|--attach=ATTACHID] [--basic-regexp, -G|--fixed-strings, -F] " color_usage " {UNIQUENAME|UNIQUEID}"
+#define cmd_show_usage "show [--sync=auto|now|no] [--clip, -c [--clear-after=SECONDS]] [--quiet, -q] [--expand-multi, -x] [--json, -j] [--all|--username|--password|--url|--notes|--field=FIELD|--id|--name|--attach=ATTACHID] [--basic-regexp, -G|--fixed-strings, -F] " color_usage " {UNIQUENAME|UNIQUEID}"
+
+int cmd_pick(int argc, char **argv);
+#define cmd_pick_usage "pick [--sync=auto|now|no] [--clip, -c] [--username|--password|--url|--notes|--field=FIELD|--id|--name] [--query=QUERY|--filter=QUERY] " color_usage
+
+int cmd_query(int argc, char **argv);
+#define cmd_query_usage "query [--sync=auto|now|no] [--select=FIELDLIST] [--json, -j] " color_usage " [EXPRESSION]"
 
 int cmd_ls(int argc, char **argv);
-#define cmd_ls_usage "ls [--sync=auto|now|no] [--long, -l] [-m] [-u] " color_usage " [GROUP]"
+#define cmd_ls_usage "ls [--sync=auto|now|no] [--long, -l] [-m] [-u] [--by-usage] " color_usage " [GROUP]"
 
 int cmd_add(int argc, char **argv);
-#define cmd_add_usage "add [--sync=auto|now|no] [--non-interactive] " color_usage " {--username|--password|--url|--notes|--field=FIELD|--note-type=NOTETYPE} NAME"
+#define cmd_add_usage "add [--sync=auto|now|no] [--non-interactive] " color_usage " {--username|--password|--url|--notes|--field=FIELD|--note-type=NOTETYPE} {NAME|--batch}"
 
 int cmd_edit(int argc, char **argv);
 #define cmd_edit_usage "edit [--sync=auto|now|no] [--non-interactive] " color_usage " {--name|--username|--password|--url|--notes|--field=FIELD} {NAME|UNIQUEID}"
@@ -96,10 +116,16 @@ int cmd_generate(int argc, char **argv);
 #define cmd_generate_usage "generate [--sync=auto|now|no] [--clip, -c] [--username=USERNAME] [--url=URL] [--no-symbols] {NAME|UNIQUEID} LENGTH"
 
 int cmd_duplicate(int argc, char **argv);
-#define cmd_duplicate_usage "duplicate [--sync=auto|now|no] " color_usage " {UNIQUENAME|UNIQUEID}"
+#define cmd_duplicate_usage "duplicate [--sync=auto|now|no] [--count=COUNT|--template=FILE] [--generate=LENGTH [--no-symbols]] " color_usage " {UNIQUENAME|UNIQUEID}"
 
 int cmd_rm(int argc, char **argv);
-#define cmd_rm_usage "rm [--sync=auto|now|no] " color_usage " {UNIQUENAME|UNIQUEID}"
+#define cmd_rm_usage "rm [--sync=auto|now|no] " color_usage " [--basic-regexp, -G|--fixed-strings, -F] [--folder=FOLDER] {NAME|UNIQUEID}..."
+
+int cmd_attach(int argc, char **argv);
+#define cmd_attach_usage "attach add [--sync=auto|now|no] " color_usage " [--mime-type=TYPE] {NAME|UNIQUEID} FILE"
+
+int cmd_materialize(int argc, char **argv);
+#define cmd_materialize_usage "materialize [--sync=auto|now|no] " color_usage " [--once|--interval=SECONDS] --dir=DIR --map=FILE"
 
 int cmd_status(int argc, char **argv);
 #define cmd_status_usage "status [--quiet, -q] " color_usage
@@ -115,7 +141,7 @@ int cmd_share(int argc, char **argv);
 #endif
 
 int cmd_mv(int argc, char **argv);
-#define cmd_mv_usage "mv " color_usage " {UNIQUENAME|UNIQUEID} GROUP"
+#define cmd_mv_usage "mv [--sync=auto|now|no] " color_usage " {[--basic-regexp, -G|--fixed-strings, -F] [--folder=FOLDER] {NAME|UNIQUEID}... GROUP|--rename-folder OLDFOLDER NEWFOLDER}"
 
 int cmd_import(int argc, char **argv);
 #define cmd_import_usage "import [--keep-dupes] [CSV_FILENAME]"
@@ -35,7 +35,9 @@
  */
 #include "config.h"
 #include "util.h"
+#include "list.h"
 #include <stdlib.h>
+#include <pthread.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <errno.h>
@@ -72,6 +74,7 @@ struct pathname_type_tuple pathname_type_lookup[] = {
 	{ "lpass.log", CONFIG_DATA },
 	{ "agent.sock", CONFIG_RUNTIME },
 	{ "uploader.pid", CONFIG_RUNTIME },
+	{ "clipboard.sock", CONFIG_RUNTIME },
 };
 
 char *config_type_to_xdg[] = {
@@ -205,9 +208,36 @@ enum config_type config_path_type(const char *name)
 	return CONFIG_DATA;
 }
 
+/*
+ * The profile selected by $LPASS_PROFILE, or "" for the default one.
+ */
+const char *config_profile(void)
+{
+	const char *profile = getenv("LPASS_PROFILE");
+
+	if (!profile)
+		return "";
+	if (strchr(profile, '/') || !strcmp(profile, ".") || !strcmp(profile, ".."))
+		die("Invalid profile name: %s", profile);
+	return profile;
+}
+
+/*
+ * Each profile keeps its own data and runtime files in profiles/NAME,
+ * with the configuration and the agent, which serves every profile,
+ * shared.
+ */
 char *config_path(const char *name)
 {
-	return config_path_for_type(config_path_type(name), name);
+	enum config_type type = config_path_type(name);
+	const char *profile = config_profile();
+	_cleanup_free_ char *profile_name = NULL;
+
+	if (!*profile || type == CONFIG_CONFIG || !strcmp(name, "agent.sock"))
+		return config_path_for_type(type, name);
+
+	xasprintf(&profile_name, "profiles/%s/%s", profile, name);
+	return config_path_for_type(type, profile_name);
 }
 
 
@@ -246,9 +276,140 @@ time_t config_mtime(const char *name)
 	return sbuf.st_mtime;
 }
 
+/*
+ * A file can be read ahead on a thread of its own, and verified and
+ * decrypted there as soon as config_prefetch_key() supplies the key,
+ * while the caller fetches the key or reads other files.  The next
+ * read of the file claims the result, waiting for the thread if it is
+ * not done; writing or removing the file drops it.
+ */
+struct config_prefetch {
+	char *name;
+	pthread_t thread;
+	bool claimed;
+	bool have_key;
+	unsigned char key[KDF_HASH_LEN];
+	unsigned char *buffer;
+	size_t len;
+	unsigned char *plaintext;
+	size_t plaintext_len;
+	struct list_head list;
+};
+
+static pthread_mutex_t prefetch_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t prefetch_cond = PTHREAD_COND_INITIALIZER;
+static pthread_once_t prefetch_once = PTHREAD_ONCE_INIT;
+static LIST_HEAD(prefetches);
+
+static size_t read_buffer(const char *name, unsigned char **out);
+static size_t decrypt_buffer(const unsigned char *buffer, size_t in_len, unsigned const char key[KDF_HASH_LEN], unsigned char **out);
+
+/* the workers do not survive a fork, and the lock may have been held */
+static void prefetch_atfork_child(void)
+{
+	pthread_mutex_init(&prefetch_lock, NULL);
+	pthread_cond_init(&prefetch_cond, NULL);
+	INIT_LIST_HEAD(&prefetches);
+}
+
+static void prefetch_init(void)
+{
+	pthread_atfork(NULL, NULL, prefetch_atfork_child);
+}
+
+static void *prefetch_worker(void *arg)
+{
+	struct config_prefetch *prefetch = arg;
+
+	prefetch->len = read_buffer(prefetch->name, &prefetch->buffer);
+
+	pthread_mutex_lock(&prefetch_lock);
+	while (!prefetch->have_key && !prefetch->claimed)
+		pthread_cond_wait(&prefetch_cond, &prefetch_lock);
+	pthread_mutex_unlock(&prefetch_lock);
+
+	if (prefetch->have_key && prefetch->buffer)
+		prefetch->plaintext_len = decrypt_buffer(prefetch->buffer, prefetch->len, prefetch->key, &prefetch->plaintext);
+	return NULL;
+}
+
+void config_prefetch(const char *name)
+{
+	struct config_prefetch *prefetch = new0(struct config_prefetch, 1);
+
+	pthread_once(&prefetch_once, prefetch_init);
+	prefetch->name = xstrdup(name);
+
+	pthread_mutex_lock(&prefetch_lock);
+	if (pthread_create(&prefetch->thread, NULL, prefetch_worker, prefetch)) {
+		/* the file is simply read when it is needed */
+		pthread_mutex_unlock(&prefetch_lock);
+		free(prefetch->name);
+		free(prefetch);
+		return;
+	}
+	list_add(&prefetch->list, &prefetches);
+	pthread_mutex_unlock(&prefetch_lock);
+}
+
+void config_prefetch_key(unsigned const char key[KDF_HASH_LEN])
+{
+	struct config_prefetch *prefetch;
+
+	pthread_mutex_lock(&prefetch_lock);
+	list_for_each_entry(prefetch, &prefetches, list) {
+		memcpy(prefetch->key, key, KDF_HASH_LEN);
+		prefetch->have_key = true;
+	}
+	pthread_cond_broadcast(&prefetch_cond);
+	pthread_mutex_unlock(&prefetch_lock);
+}
+
+static struct config_prefetch *prefetch_claim(const char *name)
+{
+	struct config_prefetch *prefetch, *found = NULL;
+
+	pthread_mutex_lock(&prefetch_lock);
+	list_for_each_entry(prefetch, &prefetches, list) {
+		if (!strcmp(prefetch->name, name)) {
+			found = prefetch;
+			list_del(&found->list);
+			found->claimed = true;
+			pthread_cond_broadcast(&prefetch_cond);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&prefetch_lock);
+
+	if (found)
+		pthread_join(found->thread, NULL);
+	return found;
+}
+
+static void prefetch_free(struct config_prefetch *prefetch)
+{
+	secure_clear(prefetch->key, KDF_HASH_LEN);
+	if (prefetch->plaintext)
+		secure_clear(prefetch->plaintext, prefetch->plaintext_len);
+	free(prefetch->plaintext);
+	free(prefetch->buffer);
+	free(prefetch->name);
+	free(prefetch);
+}
+
+static void prefetch_drop(const char *name)
+{
+	struct config_prefetch *prefetch = prefetch_claim(name);
+
+	if (prefetch)
+		prefetch_free(prefetch);
+}
+
 bool config_unlink(const char *name)
 {
 	_cleanup_free_ char *path = config_path(name);
+
+	prefetch_drop(name);
 	return unlink(path) == 0;
 }
 
@@ -264,6 +425,7 @@ void config_write_buffer(const char *name, const char *buffer, size_t len)
 	int tempfd;
 	FILE *tempfile = NULL;
 
+	prefetch_drop(name);
 	xasprintf(&tempname, "%s.XXXXXX", finalpath);
 	tempfd = mkstemp(tempname);
 	if (tempfd < 0)
@@ -300,6 +462,21 @@ char *config_read_string(const char *name)
 }
 
 size_t config_read_buffer(const char *name, unsigned char **out)
+{
+	struct config_prefetch *prefetch = prefetch_claim(name);
+	size_t len;
+
+	if (!prefetch)
+		return read_buffer(name, out);
+
+	*out = prefetch->buffer;
+	len = prefetch->len;
+	prefetch->buffer = NULL;
+	prefetch_free(prefetch);
+	return len;
+}
+
+static size_t read_buffer(const char *name, unsigned char **out)
 {
 	_cleanup_fclose_ FILE *file = NULL;
 	unsigned char *buffer;
@@ -445,9 +622,23 @@ char *config_read_encrypted_string(const char *name, unsigned const char key[KDF
 size_t config_read_encrypted_buffer(const char *name, unsigned char **buffer, unsigned const char key[KDF_HASH_LEN])
 {
 	_cleanup_free_ unsigned char *encrypted_buffer = NULL;
+	struct config_prefetch *prefetch = prefetch_claim(name);
 	size_t len;
 
-	len = config_read_buffer(name, &encrypted_buffer);
+	if (prefetch) {
+		if (prefetch->plaintext && !CRYPTO_memcmp(prefetch->key, key, KDF_HASH_LEN)) {
+			*buffer = prefetch->plaintext;
+			len = prefetch->plaintext_len;
+			prefetch->plaintext = NULL;
+			prefetch_free(prefetch);
+			return len;
+		}
+		encrypted_buffer = prefetch->buffer;
+		len = prefetch->len;
+		prefetch->buffer = NULL;
+		prefetch_free(prefetch);
+	} else
+		len = read_buffer(name, &encrypted_buffer);
 	if (!encrypted_buffer) {
 		*buffer = NULL;
 		return 0;
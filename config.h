@@ -12,6 +12,7 @@ enum config_type {
 	CONFIG_RUNTIME,
 };
 
+const char *config_profile(void);
 char *config_path(const char *name);
 FILE *config_fopen(const char *name, const char *mode);
 bool config_exists(const char *name);
@@ -29,5 +30,8 @@ void config_write_encrypted_buffer(const char *name, const char *buffer, size_t
 char *config_read_encrypted_string(const char *name, unsigned const char key[KDF_HASH_LEN]);
 size_t config_read_encrypted_buffer(const char *name, unsigned char **buffer, unsigned const char key[KDF_HASH_LEN]);
 
+void config_prefetch(const char *name);
+void config_prefetch_key(unsigned const char key[KDF_HASH_LEN]);
+
 
 #endif
@@ -4,7 +4,7 @@
 # ~/.config/fish/completions/lpass.fish
 
 function __lpass_entries
-    lpass ls --sync auto --color never \
+    lpass ls --sync auto --by-usage --color never \
         | string replace -r '^(\(none\)/)?(.*)' '$2' \
         | string replace -r '^ \[id: (\d+)\]$' '$1' \
         | string replace -r '^(.*) \[id: \d+\]$' '$1'
@@ -27,6 +27,8 @@ complete -f -c lpass -l version -n '__lpass_needs_command' -d 'Print version'
 # Commands
 complete -f -c lpass -n '__lpass_needs_command' -a add \
     -d 'Add entry'
+complete -f -c lpass -n '__lpass_needs_command' -a attach \
+    -d 'Add an attachment to an entry'
 complete -f -c lpass -n '__lpass_needs_command' -a duplicate \
     -d 'Duplicate password'
 complete -f -c lpass -n '__lpass_needs_command' -a edit \
@@ -43,8 +45,14 @@ complete -f -c lpass -n '__lpass_needs_command' -a logout \
     -d 'Logout from LastPass'
 complete -f -c lpass -n '__lpass_needs_command' -a ls \
     -d 'List entries'
+complete -f -c lpass -n '__lpass_needs_command' -a materialize \
+    -d 'Keep entry fields written out to files'
 complete -f -c lpass -n '__lpass_needs_command' -a mv \
     -d 'Move entry to group'
+complete -f -c lpass -n '__lpass_needs_command' -a pick \
+    -d 'Interactively pick an entry'
+complete -f -c lpass -n '__lpass_needs_command' -a query \
+    -d 'Print fields of matching entries'
 complete -f -c lpass -n '__lpass_needs_command' -a passwd \
     -d 'Change your LastPass master password'
 complete -f -c lpass -n '__lpass_needs_command' -a rm \
@@ -59,10 +67,14 @@ complete -f -c lpass -n '__lpass_needs_command' -a sync \
     -d 'Synchronize local cache with server'
 
 # {UNIQUENAME|UNIQUEID}
-complete -f -c lpass \
+complete -f -k -c lpass \
     -n '__lpass_using_command show mv edit generate duplicate rm' \
     -a '(__lpass_entries)'
 
+# attach add {UNIQUENAME|UNIQUEID} FILE
+complete -c lpass -n '__lpass_using_command attach' \
+    -a 'add (__lpass_entries)'
+
 # --all
 complete -f -c lpass -n '__lpass_using_command show' \
     -l all \
@@ -78,30 +90,44 @@ complete -f -c lpass -n '__lpass_using_command sync' \
     -s b -l background \
     -d 'Synchronize in background'
 
+complete -f -c lpass -n '__lpass_using_command login' \
+    -l background \
+    -d 'Wait for out-of-band approval in background'
+
 # --basic-regexp -G
-complete -f -c lpass -n '__lpass_using_command show' \
+complete -f -c lpass -n '__lpass_using_command show mv rm' \
     -s G -l basic-regexp \
     -d 'Search with regular expression'
 
 # --clip -c
-complete -f -c lpass -n '__lpass_using_command show generate' \
+complete -f -c lpass -n '__lpass_using_command show pick generate' \
     -s c -l clip \
     -d 'Copy output to clipboard'
 
+# --clear-after=SECONDS
+complete -f -c lpass -n '__lpass_using_command show' \
+    -r -l clear-after \
+    -d 'Clear the clipboard after this many seconds'
+
 # --color=COLOR
 complete -f -c lpass \
-    -n '__lpass_using_command login logout show ls mv add edit duplicate rm sync export status' \
+    -n '__lpass_using_command login logout show pick query ls mv add edit duplicate rm attach materialize sync export status' \
     -r -l color \
     -a 'auto never always' \
     -d 'When to use colors'
 
+# --dir=DIR
+complete -c lpass -n '__lpass_using_command materialize' \
+    -r -l dir \
+    -d 'Directory to write the files into'
+
 # --expand-multi
 complete -f -c lpass -n '__lpass_using_command show' \
     -s x -l expand-multi \
     -d 'Expand multi'
 
 # --field=FIELD
-complete -f -c lpass -n '__lpass_using_command show add edit' \
+complete -f -c lpass -n '__lpass_using_command show pick add edit' \
     -r -l field \
     -d 'Custom field'
 
@@ -110,11 +136,21 @@ complete -f -c lpass -n '__lpass_using_command export' \
     -r -l fields \
     -d 'Field list'
 
+# --filter=QUERY
+complete -f -c lpass -n '__lpass_using_command pick' \
+    -r -l filter \
+    -d 'Print matching entries'
+
 # --fixed-strings -F
-complete -f -c lpass -n '__lpass_using_command show' \
+complete -f -c lpass -n '__lpass_using_command show mv rm' \
     -s F -l fixed-strings \
     -d 'Search substrings'
 
+# --folder=FOLDER
+complete -f -c lpass -n '__lpass_using_command mv rm' \
+    -r -l folder \
+    -d 'Operate on every entry in a folder'
+
 # --force -f
 complete -f -c lpass -n '__lpass_using_command login logout' \
     -s f -l force \
@@ -126,10 +162,15 @@ complete -f -c lpass -n '__lpass_using_command show ls' \
     -d 'Format string'
 
 # --id
-complete -f -c lpass -n '__lpass_using_command show' \
+complete -f -c lpass -n '__lpass_using_command show pick' \
     -l id \
     -d 'ID'
 
+# --interval=SECONDS
+complete -f -c lpass -n '__lpass_using_command materialize' \
+    -r -l interval \
+    -d 'Seconds between synchronizations'
+
 # --long -l
 complete -f -c lpass -n '__lpass_using_command ls' \
     -s l -l long \
@@ -140,8 +181,18 @@ complete -f -c lpass -n '__lpass_using_command ls' \
     -s m \
     -d 'Modified time'
 
+# --map=FILE
+complete -c lpass -n '__lpass_using_command materialize' \
+    -r -l map \
+    -d 'File mapping paths to entry fields'
+
+# --mime-type=TYPE
+complete -f -c lpass -n '__lpass_using_command attach' \
+    -r -l mime-type \
+    -d 'MIME type of the attachment'
+
 # --name
-complete -f -c lpass -n '__lpass_using_command edit show' \
+complete -f -c lpass -n '__lpass_using_command edit show pick' \
     -l name \
     -d 'Name'
 
@@ -150,8 +201,28 @@ complete -f -c lpass -n '__lpass_using_command add edit' \
     -l non-interactive \
     -d 'Use standard input instead of $EDITOR'
 
+# --batch
+complete -f -c lpass -n '__lpass_using_command add' \
+    -l batch \
+    -d 'Add entries read from standard input'
+
+# --count=COUNT
+complete -f -c lpass -n '__lpass_using_command duplicate' \
+    -r -l count \
+    -d 'Number of copies to make'
+
+# --template=FILE
+complete -c lpass -n '__lpass_using_command duplicate' \
+    -r -l template \
+    -d 'Make a copy for each row of a TSV file'
+
+# --generate=LENGTH
+complete -f -c lpass -n '__lpass_using_command duplicate' \
+    -r -l generate \
+    -d 'Generate a password for each copy'
+
 # --no-symbols
-complete -f -c lpass -n '__lpass_using_command generate' \
+complete -f -c lpass -n '__lpass_using_command generate duplicate' \
     -l no-symbols \
     -d 'No symbols'
 
@@ -161,12 +232,17 @@ complete -f -c lpass -n '__lpass_using_command add' \
     -d 'Note type'
 
 # --notes
-complete -f -c lpass -n '__lpass_using_command show add edit' \
+complete -f -c lpass -n '__lpass_using_command show pick add edit' \
     -l notes \
     -d 'Notes'
 
+# --once
+complete -f -c lpass -n '__lpass_using_command materialize' \
+    -l once \
+    -d 'Write the files once and exit'
+
 # --password
-complete -f -c lpass -n '__lpass_using_command show add edit' \
+complete -f -c lpass -n '__lpass_using_command show pick add edit' \
     -l password \
     -d 'Password'
 
@@ -175,14 +251,29 @@ complete -f -c lpass -n '__lpass_using_command login' \
     -l plaintext-key \
     -d 'Store key in plain text'
 
+# --query=QUERY
+complete -f -c lpass -n '__lpass_using_command pick' \
+    -r -l query \
+    -d 'Initial query'
+
 # --quiet -q
 complete -f -c lpass -n '__lpass_using_command status' \
     -s q -l quiet \
     -d 'No output'
 
+# --rename-folder
+complete -f -c lpass -n '__lpass_using_command mv' \
+    -l rename-folder \
+    -d 'Rename a folder and its subfolders'
+
+# --select=FIELDLIST
+complete -f -c lpass -n '__lpass_using_command query' \
+    -r -l select \
+    -d 'Fields to print'
+
 # --sync=SYNC
 complete -f -c lpass \
-    -n '__lpass_using_command show ls add edit generate duplicate rm export import' \
+    -n '__lpass_using_command show pick query ls mv add edit generate duplicate rm attach materialize export import' \
     -r -l sync \
     -a 'auto now no' \
     -d 'Synchronize local cache with server'
@@ -203,12 +294,12 @@ complete -f -c lpass -n '__lpass_using_command generate' \
     -d 'URL'
 
 # --url
-complete -f -c lpass -n '__lpass_using_command show add edit' \
+complete -f -c lpass -n '__lpass_using_command show pick add edit' \
     -l url \
     -d 'URL'
 
 # --username
-complete -f -c lpass -n '__lpass_using_command show add edit' \
+complete -f -c lpass -n '__lpass_using_command show pick add edit' \
     -l username \
     -d 'Username'
 
@@ -36,8 +36,10 @@
 
 #include "cmd.h"
 #include "endpoints.h"
+#include "upload-queue.h"
 #include "blob.h"
 #include "agent.h"
+#include "config.h"
 #include <stdio.h>
 #include <unistd.h>
 #include <string.h>
@@ -46,6 +48,7 @@
 #include "feature-flag.h"
 
 #define MAX_NOTE_LEN (unsigned long) 45000
+#define RECORD_SEPARATOR '\x1e'
 
 #if defined(__linux__) || defined(__CYGWIN__)
 static char *shared_memory_dir(void)
@@ -168,7 +171,11 @@ static void assign_account_value(struct account *account,
 	assign_if("Notes", note);
 
 	if (!strcmp(label, "Reprompt")) {
-		account->pwprotect = !strcmp(trim(value), "Yes");
+		bool pwprotect = !strcmp(trim(value), "Yes");
+
+		if (account->pwprotect != pwprotect)
+			account->dirty = true;
+		account->pwprotect = pwprotect;
 		return;
 	}
 
@@ -584,6 +591,7 @@ int edit_account(struct session *session,
 		if (!value || !strlen(value)) {
 			list_del(&editable_field->list);
 			field_free(editable_field);
+			editable->dirty = true;
 		} else
 			field_set_value(editable, editable_field, value, key);
 	}
@@ -594,6 +602,8 @@ int edit_account(struct session *session,
 		account_free(notes_expansion);
 		account_set_note(editable, xstrdup(notes_collapsed->note), key);
 		account_set_fullname(editable, xstrdup(notes_collapsed->fullname), key);
+		if (editable->pwprotect != notes_collapsed->pwprotect)
+			editable->dirty = true;
 		editable->pwprotect = notes_collapsed->pwprotect;
 		account_free(notes_collapsed);
 	}
@@ -603,8 +613,10 @@ int edit_account(struct session *session,
 		die("Use lpass mv to move items to/from shared folders");
 	}
 
-	lastpass_update_account(sync, key, session, editable, blob);
-	blob_save(blob, key, &session->feature_flag);
+	if (editable->dirty) {
+		lastpass_update_account(sync, key, session, editable, blob);
+		blob_save(blob, key, &session->feature_flag);
+	}
 
 	session_free(session);
 	blob_free(blob);
@@ -662,3 +674,249 @@ int edit_new_account(struct session *session,
 	return edit_account(session, blob, sync, account, choice, field,
 			    non_interactive, key);
 }
+
+/*
+ * Labels a record of the given note type may set: the ones every entry
+ * has, and the fields of the note type.  Any label is fine for a site,
+ * where the unknown ones become fields.
+ */
+static bool record_label_ok(enum note_type note_type, const char *label)
+{
+	static const char *common[] = { "Name", "NoteType", "Notes", "Reprompt", "Language" };
+	size_t i;
+
+	if (note_type == NOTE_TYPE_NONE)
+		return true;
+	for (i = 0; i < ARRAY_SIZE(common); i++) {
+		if (!strcmp(label, common[i]))
+			return true;
+	}
+	return note_has_field(note_type, label);
+}
+
+/* The note type a record names with a NoteType line, if any. */
+static bool record_note_type(const char *record, enum note_type *note_type)
+{
+	_cleanup_free_ char *value = NULL;
+	const char *line, *end;
+
+	for (line = record; line; line = end ? end + 1 : NULL) {
+		end = strchr(line, '\n');
+		if (!strncmp(line, "Notes:", 6))
+			break;
+		if (!strncmp(line, "NoteType:", 9)) {
+			value = end ? xstrndup(line + 9, end - line - 9) : xstrdup(line + 9);
+			*note_type = notes_get_type_by_name(trim(value));
+			return *note_type != NOTE_TYPE_NONE;
+		}
+	}
+	return true;
+}
+
+/*
+ * Make a new account from one record, in the format edit_account()
+ * reads, or report why it cannot be added and return NULL.
+ */
+static struct account *record_account(struct session *session, struct blob *blob,
+				      char *record, size_t recno, enum note_type note_type,
+				      unsigned char key[KDF_HASH_LEN])
+{
+	LIST_HEAD(entries);
+	struct parsed_name_value *entry, *tmp;
+	struct account *account, *expansion, *collapsed, *editable;
+	FILE *input;
+	bool ok = true;
+
+	if (!record_note_type(record, &note_type)) {
+		fprintf(stderr, "Record %zu: unknown NoteType\n", recno);
+		return NULL;
+	}
+
+	input = fmemopen(record, strlen(record), "r");
+	if (!input)
+		die_errno("fmemopen");
+	parse_account_file(input, note_type, &entries);
+	fclose(input);
+
+	list_for_each_entry(entry, &entries, list) {
+		if (!record_label_ok(note_type, entry->name)) {
+			fprintf(stderr, "Record %zu: %s is not a field of %s notes\n",
+				recno, entry->name, notes_get_name(note_type));
+			ok = false;
+		}
+	}
+	entry = list_first_entry_or_null(&entries, struct parsed_name_value, list);
+	if (!entry || entry->lineno != 1 || strcmp(entry->name, "Name") ||
+	    !*trim(entry->value)) {
+		fprintf(stderr, "Record %zu: does not start with a Name\n", recno);
+		ok = false;
+	}
+
+	account = NULL;
+	if (!ok)
+		goto out;
+
+	account = new_account();
+	account->id = xstrdup("0");
+	account->attachkey = xstrdup("");
+	account->attachkey_encrypted = xstrdup("");
+	account_set_password(account, xstrdup(""), key);
+	account_set_fullname(account, xstrdup(""), key);
+	account_set_username(account, xstrdup(""), key);
+	account_set_url(account, xstrdup(note_type != NOTE_TYPE_NONE ? "http://sn" : ""),
+			key, &session->feature_flag);
+	if (note_type != NOTE_TYPE_NONE) {
+		char *note_type_str = NULL;
+		xasprintf(&note_type_str, "NoteType:%s\n", notes_get_name(note_type));
+		account_set_note(account, note_type_str, key);
+	} else {
+		account_set_note(account, xstrdup(""), key);
+	}
+
+	expansion = notes_expand(account);
+	editable = expansion ? expansion : account;
+	list_for_each_entry(entry, &entries, list)
+		assign_account_value(editable, entry->name, entry->value,
+				     entry->lineno, key, &session->feature_flag);
+
+	if (expansion) {
+		collapsed = notes_collapse(expansion);
+		account_free(expansion);
+		account_set_note(account, xstrdup(collapsed->note), key);
+		account_set_fullname(account, xstrdup(collapsed->fullname), key);
+		account->pwprotect = collapsed->pwprotect;
+		account_free(collapsed);
+	}
+
+	account_assign_share(blob, account, key, &session->feature_flag);
+	if (account->share && account->share->readonly) {
+		fprintf(stderr, "Record %zu: %s is in a readonly shared folder\n",
+			recno, account->fullname);
+		account_free(account);
+		account = NULL;
+	}
+
+out:
+	list_for_each_entry_safe(entry, tmp, &entries, list) {
+		free(entry->name);
+		free(entry->value);
+		list_del(&entry->list);
+		free(entry);
+	}
+	return account;
+}
+
+/*
+ * Add an entry for each record read from input.  Records are in the
+ * format edit_account() reads, starting with the Name, and separated
+ * by an ASCII record separator.  Every record is checked before any is
+ * added; those outside shared folders, without form fields or reprompt,
+ * are uploaded in uploadaccounts batches, and the rest are queued once
+ * the batches are in.  If a batch fails, the batches already sent stay
+ * added and nothing is queued; each record is reported either way.
+ */
+int add_new_accounts(struct session *session,
+		     struct blob *blob,
+		     enum blobsync sync,
+		     FILE *input,
+		     enum note_type note_type,
+		     unsigned char key[KDF_HASH_LEN])
+{
+	_cleanup_free_ char *buf = NULL;
+	LIST_HEAD(accounts);
+	LIST_HEAD(queued);
+	LIST_HEAD(uploaded);
+	struct account *account, *tmp;
+	struct blob *latest = NULL;
+	char *record, *next;
+	size_t len, recno = 0, invalid = 0, count = 0, added = 0, failed = 0;
+	bool queue;
+	int ret;
+
+	if (read_file_buf(input, &buf, &len))
+		die_errno("fread");
+
+	for (record = buf; record < buf + len; record = next + 1) {
+		next = memchr(record, RECORD_SEPARATOR, buf + len - record);
+		if (!next)
+			next = buf + len;
+		*next = '\0';
+		while (*record == '\n' || *record == '\r')
+			record++;
+		if (!*trim(record))
+			continue;
+
+		account = record_account(session, blob, record, ++recno, note_type, key);
+		if (!account) {
+			invalid++;
+			continue;
+		}
+		list_add_tail(&account->list, &accounts);
+	}
+	if (invalid)
+		die("%zu of %zu records are invalid; nothing was added.", invalid, recno);
+
+	list_for_each_entry_safe(account, tmp, &accounts, list) {
+		count++;
+		if (sync == BLOB_SYNC_NO || account->share || account->pwprotect ||
+		    !list_empty(&account->field_head)) {
+			list_del(&account->list);
+			list_add_tail(&account->list, &queued);
+		} else {
+			account_encrypt(account, key, &session->feature_flag);
+		}
+	}
+
+	ret = lastpass_upload(session, &accounts, &uploaded);
+	list_for_each_entry_safe(account, tmp, &uploaded, list) {
+		printf("Added: %s\n", account->fullname);
+		list_del(&account->list);
+		account_free(account);
+		added++;
+	}
+
+	/*
+	 * The server gives uploaded entries their ids, so the vault is
+	 * fetched again, and the queued entries are put in that one.
+	 */
+	if (added) {
+		latest = lastpass_get_blob(session, key, false);
+		if (latest) {
+			blob_free(blob);
+			blob = latest;
+		} else {
+			config_unlink("blob");
+		}
+	}
+
+	if (ret) {
+		list_for_each_entry(account, &accounts, list) {
+			fprintf(stderr, "Not added: %s\n", account->fullname);
+			failed++;
+		}
+		list_for_each_entry(account, &queued, list) {
+			fprintf(stderr, "Not added: %s\n", account->fullname);
+			failed++;
+		}
+		die("Adding %zu of %zu records failed (%d)", failed, count, ret);
+	}
+
+	queue = !list_empty(&queued);
+	list_for_each_entry_safe(account, tmp, &queued, list) {
+		list_del(&account->list);
+		if (latest)
+			account_assign_share(blob, account, key, &session->feature_flag);
+		list_add(&account->list, &blob->account_head);
+		lastpass_update_account(BLOB_SYNC_NO, key, session, account, blob);
+		printf("Added: %s\n", account->fullname);
+	}
+	if (queue) {
+		blob_save(blob, key, &session->feature_flag);
+		if (sync != BLOB_SYNC_NO)
+			upload_queue_ensure_running(key, session);
+	}
+
+	session_free(session);
+	blob_free(blob);
+	return 0;
+}
@@ -203,7 +203,7 @@ static inline bool has_capabilities(const char *capabilities, const char *capabi
 	return false;
 }
 
-static bool oob_login(const char *login_server, const unsigned char key[KDF_HASH_LEN], char **args, char **message, char **reply, char **oob_name, struct session **session)
+static bool oob_login(const char *login_server, const unsigned char key[KDF_HASH_LEN], char **args, char **message, char **reply, char **oob_name, login_detach_fn detach, struct session **session)
 {
 	_cleanup_free_ char *oob_capabilities = NULL;
 	_cleanup_free_ char *cause = NULL;
@@ -221,7 +221,15 @@ static bool oob_login(const char *login_server, const unsigned char key[KDF_HASH
 		goto failure;
 	}
 
-	terminal_fprintf(stderr, TERMINAL_FG_YELLOW TERMINAL_BOLD "Waiting for approval of out-of-band %s login%s" TERMINAL_NO_BOLD "...", *oob_name, can_do_passcode ? ", or press Ctrl+C to enter a passcode" : "");
+	/*
+	 * Once detached there is nobody to enter a passcode, so a failed
+	 * wait ends the login rather than falling back to one.
+	 */
+	if (detach) {
+		detach(*oob_name);
+		can_do_passcode = false;
+	} else
+		terminal_fprintf(stderr, TERMINAL_FG_YELLOW TERMINAL_BOLD "Waiting for approval of out-of-band %s login%s" TERMINAL_NO_BOLD "...", *oob_name, can_do_passcode ? ", or press Ctrl+C to enter a passcode" : "");
 	append_post(args, "outofbandrequest", "1");
 	for (;;) {
 		free(*reply);
@@ -312,7 +320,7 @@ static bool otp_login(const char *login_server, const unsigned char key[KDF_HASH
 	}
 }
 
-struct session *lastpass_login(const char *username, const char *fragment, const char hash[KDF_HEX_LEN], const unsigned char key[KDF_HASH_LEN], int iterations, char **error_message, bool trust)
+struct session *lastpass_login(const char *username, const char *fragment, const char hash[KDF_HEX_LEN], const unsigned char key[KDF_HASH_LEN], int iterations, char **error_message, bool trust, login_detach_fn detach)
 {
 	char *args[33];
 	_cleanup_free_ char *user_lower = NULL;
@@ -353,7 +361,7 @@ struct session *lastpass_login(const char *username, const char *fragment, const
 	}
 
 	if (cause && !strcmp(cause, "outofbandrequired") &&
-	    oob_login(login_server, key, args, error_message, &reply, &otp_name, &session)) {
+	    oob_login(login_server, key, args, error_message, &reply, &otp_name, detach, &session)) {
 		if (trust)
 			http_post_lastpass("trust.php", session, NULL, "token", session->token, "uuid", trusted_id, "trustlabel", trusted_label, NULL);
 		return session;
@@ -303,61 +303,42 @@ int lastpass_share_delete(const struct session *session, struct share *share)
 	return 0;
 }
 
-/*
- * Move a site into or out of a shared folder.
- *
- * account should already be encrypted with the new share key.
- * orig_folder or account->share may be null, indicating the
- * transition to or from a regular site and a shared folder.
- */
-int lastpass_share_move(const struct session *session,
-			struct account *account,
-			struct share *orig_folder)
+static void share_move_rows(unsigned const char key[KDF_HASH_LEN],
+			    const struct session *session,
+			    struct account **accounts, size_t count,
+			    struct share *orig_folder)
 {
-	_cleanup_free_ char *url = NULL;
-	_cleanup_free_ char *reply = NULL;
+	_cleanup_free_ char *todelete = NULL;
+	char **owned;
+	size_t n_owned = 0, i;
+	struct share *share = accounts[0]->share;
 
 	struct http_param_set params = {
 		.argv = NULL,
 		.n_alloced = 0
 	};
 
-	if (!account->share && !orig_folder)
-		return 0;
+	/* per row: eight parameter names and the hex url */
+	owned = new0(char *, count * 9);
 
-	bytes_to_hex((unsigned char *) account->url, &url, strlen(account->url));
+	http_post_add_params(&params,
+			     "token", session->token,
+			     "cmd", "uploadaccounts",
+			     NULL);
 
-	if (session->feature_flag.url_encryption_enabled) {
-		http_post_add_params(&params,
-			"token", session->token,
-			"cmd", "uploadaccounts",
-			"aid0", account->id,
-			"name0", account->name_encrypted,
-			"grouping0", account->group_encrypted,
-			"url0", account->url_encrypted,
-			"username0", account->username_encrypted,
-			"password0", account->password_encrypted,
-			"pwprotect0", account->pwprotect ? "on" : "off",
-			"extra0", account->note_encrypted,
-			"todelete", account->id, NULL);
-	} else {
-		http_post_add_params(&params,
-			"token", session->token,
-			"cmd", "uploadaccounts",
-			"aid0", account->id,
-			"name0", account->name_encrypted,
-			"grouping0", account->group_encrypted,
-			"url0", url,
-			"username0", account->username_encrypted,
-			"password0", account->password_encrypted,
-			"pwprotect0", account->pwprotect ? "on" : "off",
-			"extra0", account->note_encrypted,
-			"todelete", account->id, NULL);
+	for (i = 0; i < count; i++) {
+		upload_add_account_row(&params, owned, &n_owned, session, i, accounts[i]);
+
+		if (todelete)
+			xstrappend(&todelete, ",");
+		xstrappend(&todelete, accounts[i]->id);
 	}
 
-	if (account->share) {
+	http_post_add_params(&params, "todelete", todelete, NULL);
+
+	if (share) {
 		http_post_add_params(&params,
-				     "sharedfolderid", account->share->id,
+				     "sharedfolderid", share->id,
 				     NULL);
 	}
 
@@ -367,16 +348,40 @@ int lastpass_share_move(const struct session *session,
 				     NULL);
 	}
 
-	reply = http_post_lastpass_param_set("lastpass/api.php",
-					     session, NULL,
-					     &params);
+	upload_queue_enqueue(BLOB_SYNC_NO, key, session, "lastpass/api.php", &params);
 
 	free(params.argv);
+	for (i = 0; i < n_owned; i++)
+		free(owned[i]);
+	free(owned);
+}
 
-	if (!reply)
-		return -EINVAL;
+/*
+ * Move sites into or out of a shared folder.
+ *
+ * All accounts must be moving from orig_folder to the same folder,
+ * and should already be encrypted with its key.  orig_folder or the
+ * accounts' share may be null, indicating the transition to or from a
+ * regular site and a shared folder.  The sites are queued as the rows
+ * of uploadaccounts requests, batched as for lastpass_upload(), which
+ * the upload queue sends several at a time.
+ */
+void lastpass_share_move(enum blobsync sync, unsigned const char key[KDF_HASH_LEN],
+			 const struct session *session,
+			 struct account **accounts, size_t count,
+			 struct share *orig_folder)
+{
+	size_t i, batch;
 
-	return xml_api_err(reply);
+	if (!count || (!accounts[0]->share && !orig_folder))
+		return;
+
+	for (i = 0; i < count; i += batch) {
+		batch = upload_batch_size(&accounts[i], count - i);
+		share_move_rows(key, session, &accounts[i], batch, orig_folder);
+	}
+	if (sync != BLOB_SYNC_NO)
+		upload_queue_ensure_running(key, session);
 }
 
 int lastpass_share_get_limits(const struct session *session,
@@ -416,13 +421,15 @@ int lastpass_share_set_limits(const struct session *session,
 		numaids++;
 	}
 
-	aid_buf = xcalloc(alloc_len, 1);
+	/* an empty list is sent as an empty string */
+	aid_buf = xcalloc(alloc_len + 1, 1);
 
 	list_for_each_entry(aid, &limit->aid_list, list) {
-		strlcat(aid_buf, aid->aid, alloc_len);
-		strlcat(aid_buf, ",", alloc_len);
+		strlcat(aid_buf, aid->aid, alloc_len + 1);
+		strlcat(aid_buf, ",", alloc_len + 1);
 	}
-	aid_buf[alloc_len-1] = '\0';
+	if (alloc_len)
+		aid_buf[alloc_len - 1] = '\0';
 
 	snprintf(numaids_str, sizeof(numaids_str), "%d", numaids);
 
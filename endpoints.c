@@ -40,9 +40,10 @@
 #include "config.h"
 #include "util.h"
 #include "upload-queue.h"
+#include "cipher.h"
 #include <string.h>
 #include <errno.h>
-#include <curl/curl.h>
+#include <pthread.h>
 
 unsigned int lastpass_iterations(const char *username)
 {
@@ -63,7 +64,7 @@ void lastpass_logout(const struct session *session)
 	free(http_post_lastpass("logout.php", session, NULL, "method", "cli", "noredirect", "1", "token", session->token, NULL));
 }
 
-struct blob *lastpass_get_blob(const struct session *session, const unsigned char key[KDF_HASH_LEN])
+struct blob *lastpass_get_blob(const struct session *session, const unsigned char key[KDF_HASH_LEN], bool lazy_secrets)
 {
 	size_t len;
 
@@ -71,7 +72,7 @@ struct blob *lastpass_get_blob(const struct session *session, const unsigned cha
 	if (!blob || !len)
 		return NULL;
 	config_write_encrypted_buffer("blob", blob, len, key);
-	return blob_parse((unsigned char *) blob, len, key, &session->private_key);
+	return blob_parse((unsigned char *) blob, len, key, &session->private_key, lazy_secrets);
 }
 
 void lastpass_remove_account(enum blobsync sync, unsigned const char key[KDF_HASH_LEN], const struct session *session, const struct account *account, struct blob *blob)
@@ -92,31 +93,24 @@ void lastpass_remove_account(enum blobsync sync, unsigned const char key[KDF_HAS
 
 static char *stringify_field(const struct field *field)
 {
-	char *str, *name, *type, *value, *intermediate;
-	CURL *curl;
+	char *str, *intermediate;
+	_cleanup_free_ char *name = NULL;
+	_cleanup_free_ char *type = NULL;
+	_cleanup_free_ char *value = NULL;
 
-	curl = curl_easy_init();
-	if (!curl)
-		return xstrdup("");
-
-	name = curl_easy_escape(curl, field->name, 0);
-	type = curl_easy_escape(curl, field->type, 0);
+	name = http_escape(field->name);
+	type = http_escape(field->type);
 	if (field->value_encrypted)
-		value = curl_easy_escape(curl, field->value_encrypted, 0);
+		value = http_escape(field->value_encrypted);
 	else if (!strcmp(field->type, "checkbox") || !strcmp(field->type, "radio")) {
 		xasprintf(&intermediate, "%s-%c", field->value, field->checked ? '1' : '0');
-		value = curl_easy_escape(curl, intermediate, 0);
+		value = http_escape(intermediate);
 		free(intermediate);
 	} else
-		value = curl_easy_escape(curl, field->value, 0);
+		value = http_escape(field->value);
 
 	xasprintf(&str, "0\t%s\t%s\t%s\n", name, value, type);
 
-	curl_free(name);
-	curl_free(type);
-	curl_free(value);
-	curl_easy_cleanup(curl);
-
 	return str;
 }
 
@@ -164,7 +158,7 @@ static void add_app_fields(const struct account *account,
 	}
 }
 
-void lastpass_update_account(enum blobsync sync, unsigned const char key[KDF_HASH_LEN], const struct session *session, const struct account *account, struct blob *blob)
+void lastpass_update_account(enum blobsync sync, unsigned const char key[KDF_HASH_LEN], const struct session *session, struct account *account, struct blob *blob)
 {
 	struct http_param_set params = {
 		.argv = NULL,
@@ -174,6 +168,8 @@ void lastpass_update_account(enum blobsync sync, unsigned const char key[KDF_HAS
 	_cleanup_free_ char *url = NULL;
 	_cleanup_free_ char *fields = NULL;
 
+	account_encrypt(account, key, &session->feature_flag);
+
 	bytes_to_hex((unsigned char *) account->url, &url, strlen(account->url));
 	fields = stringify_fields(&account->field_head);
 
@@ -253,6 +249,50 @@ unsigned long long lastpass_get_blob_version(struct session *session, unsigned c
 	return version;
 }
 
+/*
+ * As lastpass_get_blob_version(), but a network failure is returned as
+ * 0 rather than being fatal, for threads that cannot die().
+ */
+unsigned long long lastpass_get_blob_version_noexit(struct session *session, unsigned const char key[KDF_HASH_LEN])
+{
+	_cleanup_free_ char *reply = NULL;
+	char *argv[] = { "method", "cli", NULL };
+	unsigned long long version;
+	int curl_ret;
+	long http_code;
+
+	reply = http_post_lastpass_v_noexit(NULL, "login_check.php", session,
+					    NULL, argv, &curl_ret, &http_code);
+	if (!reply)
+		return 0;
+	version = xml_login_check(reply, session);
+	if (version)
+		session_save(session, key);
+	return version;
+}
+
+/*
+ * Ask the server whether @session is still valid, which also keeps it from
+ * expiring, and save the token and session id it hands back.  Unlike
+ * lastpass_get_blob_version(), a network failure is returned, not fatal.
+ */
+int lastpass_check_session(struct session *session, unsigned const char key[KDF_HASH_LEN])
+{
+	_cleanup_free_ char *reply = NULL;
+	char *argv[] = { "method", "cli", NULL };
+	int curl_ret;
+	long http_code;
+
+	reply = http_post_lastpass_v_noexit(NULL, "login_check.php", session,
+					    NULL, argv, &curl_ret, &http_code);
+	if (!reply)
+		return -EIO;
+	if (!xml_login_check(reply, session))
+		return -EPERM;
+	session_save(session, key);
+	return 0;
+}
+
 void lastpass_log_access(enum blobsync sync, const struct session *session, unsigned const char key[KDF_HASH_LEN], const struct account *account)
 {
 	struct http_param_set params = {
@@ -386,97 +426,337 @@ int lastpass_pwchange_complete(const struct session *session,
 /*
  * Upload a set of accounts, used for import.
  */
-int lastpass_upload(const struct session *session,
-		    struct list_head *accounts)
+static size_t upload_limit(const char *name, size_t def)
 {
-	_cleanup_free_ char *reply = NULL;
-	struct account *account;
-	int index;
-	unsigned int i;
+	char *env = getenv(name);
+	size_t limit;
+
+	if (!env)
+		return def;
+	limit = strtoul(env, NULL, 10);
+	if (!limit)
+		return def;
+	return limit;
+}
+
+static size_t account_upload_size(const struct account *account)
+{
+	size_t size = 0;
+
+#define add_len(str) do { if (str) size += strlen(str); } while (0)
+	add_len(account->name_encrypted);
+	add_len(account->group_encrypted);
+	add_len(account->username_encrypted);
+	add_len(account->password_encrypted);
+	add_len(account->note_encrypted);
+#undef add_len
+	/* the url is sent encrypted or hex encoded, either about twice its size */
+	return size + strlen(account->url) * 2;
+}
+
+void upload_add_row_param(struct http_param_set *params, char **owned, size_t *n_owned,
+		   const char *name, size_t row, char *value)
+{
+	xasprintf(&owned[*n_owned], "%s%zu", name, row);
+	http_post_add_params(params, owned[(*n_owned)++], value, NULL);
+}
+
+/*
+ * Add an encrypted account as row row of an uploadaccounts request,
+ * replacing the server's copy unless it is new.  Up to nine strings
+ * are added to owned.
+ */
+void upload_add_account_row(struct http_param_set *params, char **owned, size_t *n_owned,
+			    const struct session *session, size_t row,
+			    struct account *account)
+{
+	char *url;
+
+	if (session->feature_flag.url_encryption_enabled) {
+		url = account->url_encrypted;
+	} else {
+		bytes_to_hex((unsigned char *) account->url, &owned[*n_owned],
+			     strlen(account->url));
+		url = owned[(*n_owned)++];
+	}
+
+	if (strcmp(account->id, "0"))
+		upload_add_row_param(params, owned, n_owned, "aid", row, account->id);
+	upload_add_row_param(params, owned, n_owned, "name", row, account->name_encrypted);
+	upload_add_row_param(params, owned, n_owned, "grouping", row, account->group_encrypted);
+	upload_add_row_param(params, owned, n_owned, "url", row, url);
+	upload_add_row_param(params, owned, n_owned, "username", row, account->username_encrypted);
+	upload_add_row_param(params, owned, n_owned, "password", row, account->password_encrypted);
+	upload_add_row_param(params, owned, n_owned, "pwprotect", row, account->pwprotect ? "on" : "off");
+	upload_add_row_param(params, owned, n_owned, "extra", row, account->note_encrypted);
+}
+
+/*
+ * The number of accounts, from the start of accounts, to send as the
+ * rows of the next uploadaccounts request.  Requests are kept within
+ * LPASS_UPLOAD_BATCH_ROWS rows and about LPASS_UPLOAD_BATCH_BYTES of
+ * ciphertext, but always carry at least one row.
+ */
+size_t upload_batch_size(struct account **accounts, size_t count)
+{
+	size_t max_rows = upload_limit("LPASS_UPLOAD_BATCH_ROWS", 100);
+	size_t max_bytes = upload_limit("LPASS_UPLOAD_BATCH_BYTES", 512 * 1024);
+	size_t rows, bytes = 0;
+
+	for (rows = 0; rows < count && rows < max_rows; rows++) {
+		bytes += account_upload_size(accounts[rows]);
+		if (rows && bytes > max_bytes)
+			break;
+	}
+	return rows;
+}
+
+static void update_rows(unsigned const char key[KDF_HASH_LEN],
+			const struct session *session,
+			struct account **accounts, size_t count)
+{
+	char **owned;
+	size_t n_owned = 0, i;
 
 	struct http_param_set params = {
 		.argv = NULL,
 		.n_alloced = 0
 	};
 
-	if (list_empty(accounts))
-		return 0;
+	/* per row: eight parameter names and the hex url */
+	owned = new0(char *, count * 9);
 
 	http_post_add_params(&params,
 			     "token", session->token,
 			     "cmd", "uploadaccounts",
 			     NULL);
+	for (i = 0; i < count; i++)
+		upload_add_account_row(&params, owned, &n_owned, session, i, accounts[i]);
+	if (accounts[0]->share) {
+		http_post_add_params(&params,
+				     "sharedfolderid", accounts[0]->share->id,
+				     NULL);
+	}
 
-	index = 0;
-	list_for_each_entry(account, accounts, list) {
-		char *name_param, *grouping_param;
-		char *url_param, *username_param, *password_param;
-		char *fav_param, *extra_param;
-		char *url = NULL;
-		bytes_to_hex((unsigned char *) account->url, &url,
-			     strlen(account->url));
+	upload_queue_enqueue(BLOB_SYNC_NO, key, session, "lastpass/api.php", &params);
+
+	free(params.argv);
+	for (i = 0; i < n_owned; i++)
+		free(owned[i]);
+	free(owned);
+}
+
+/*
+ * Queue the changes to, or the creation of, many accounts at once.
+ * Runs of accounts in the same shared folder, or outside of any, go
+ * out as the rows of uploadaccounts requests, batched as for
+ * lastpass_upload(), which the upload queue sends several at a time;
+ * applications still go out one by one.  The custom fields of the
+ * accounts are left as they are on the server.
+ */
+void lastpass_update_accounts(enum blobsync sync, unsigned const char key[KDF_HASH_LEN],
+			      const struct session *session,
+			      struct account **accounts, size_t count,
+			      struct blob *blob)
+{
+	size_t i, j, k, batch;
+
+	for (i = 0; i < count; i = j) {
+		if (accounts[i]->is_app) {
+			lastpass_update_account(BLOB_SYNC_NO, key, session, accounts[i], blob);
+			j = i + 1;
+			continue;
+		}
+
+		for (j = i; j < count && !accounts[j]->is_app &&
+			    accounts[j]->share == accounts[i]->share; j++)
+			account_encrypt(accounts[j], key, &session->feature_flag);
+
+		for (k = i; k < j; k += batch) {
+			batch = upload_batch_size(&accounts[k], j - k);
+			update_rows(key, session, &accounts[k], batch);
+		}
+		blob->version += j - i;
+	}
+
+	if (sync != BLOB_SYNC_NO)
+		upload_queue_ensure_running(key, session);
+}
+
+struct upload_batch {
+	struct account **accounts;
+	size_t count;
+	char *reply;
+};
+
+struct upload_state {
+	const struct session *session;
+	struct upload_batch *batches;
+	size_t n_batches;
+	size_t next;
+	pthread_mutex_t lock;
+};
+
+static char *upload_batch_send(const struct session *session, struct upload_batch *batch)
+{
+	char *reply;
+	char **owned;
+	size_t n_owned = 0, i;
+	struct account *account;
+	char *url;
+	int curl_ret;
+	long http_code;
+
+	struct http_param_set params = {
+		.argv = NULL,
+		.n_alloced = 0
+	};
+
+	/* per row: seven parameter names and the hex url */
+	owned = new0(char *, batch->count * 8);
+
+	http_post_add_params(&params,
+			     "token", session->token,
+			     "cmd", "uploadaccounts",
+			     NULL);
 
-		xasprintf(&name_param, "name%d", index);
-		xasprintf(&grouping_param, "grouping%d", index);
-		xasprintf(&url_param, "url%d", index);
-		xasprintf(&username_param, "username%d", index);
-		xasprintf(&password_param, "password%d", index);
-		xasprintf(&fav_param, "fav%d", index);
-		xasprintf(&extra_param, "extra%d", index);
+	for (i = 0; i < batch->count; i++) {
+		account = batch->accounts[i];
 
 		if (session->feature_flag.url_encryption_enabled) {
-			http_post_add_params(&params,
-				name_param, account->name_encrypted,
-				grouping_param, account->group_encrypted,
-				url_param, account->url_encrypted,
-				username_param, account->username_encrypted,
-				password_param, account->password_encrypted,
-				fav_param, account->fav ? "1" : "0",
-				extra_param, account->note_encrypted,
-				NULL);
+			url = account->url_encrypted;
 		} else {
-			http_post_add_params(&params,
-				name_param, account->name_encrypted,
-				grouping_param, account->group_encrypted,
-				url_param, url,
-				username_param, account->username_encrypted,
-				password_param, account->password_encrypted,
-				fav_param, account->fav ? "1" : "0",
-				extra_param, account->note_encrypted,
-				NULL);
+			bytes_to_hex((unsigned char *) account->url, &owned[n_owned],
+				     strlen(account->url));
+			url = owned[n_owned++];
 		}
 
-		index++;
+		upload_add_row_param(&params, owned, &n_owned, "name", i, account->name_encrypted);
+		upload_add_row_param(&params, owned, &n_owned, "grouping", i, account->group_encrypted);
+		upload_add_row_param(&params, owned, &n_owned, "url", i, url);
+		upload_add_row_param(&params, owned, &n_owned, "username", i, account->username_encrypted);
+		upload_add_row_param(&params, owned, &n_owned, "password", i, account->password_encrypted);
+		upload_add_row_param(&params, owned, &n_owned, "fav", i, account->fav ? "1" : "0");
+		upload_add_row_param(&params, owned, &n_owned, "extra", i, account->note_encrypted);
 	}
 
-	reply = http_post_lastpass_param_set("lastpass/api.php",
-					     session, NULL,
-					     &params);
+	reply = http_post_lastpass_v_noexit(NULL, "lastpass/api.php",
+					    session, NULL, params.argv,
+					    &curl_ret, &http_code);
 
-	for (i=0; i < params.n_alloced && params.argv[i]; i++) {
-		if (starts_with(params.argv[i], "name") ||
-		    starts_with(params.argv[i], "grouping") ||
-		    starts_with(params.argv[i], "username") ||
-		    starts_with(params.argv[i], "password") ||
-		    starts_with(params.argv[i], "fav") ||
-		    starts_with(params.argv[i], "extra")) {
-			free(params.argv[i]);
-		}
-		else if (starts_with(params.argv[i], "url")) {
-			free(params.argv[i]);
-			if (i < params.n_alloced) {
-				free(params.argv[i+1]);
-				i++;
-			}
+	free(params.argv);
+	for (i = 0; i < n_owned; i++)
+		free(owned[i]);
+	free(owned);
+
+	return reply;
+}
+
+/*
+ * A batch that cannot be sent at all fails on its own, like one the
+ * server refused, rather than ending the process from whichever thread
+ * sent it; what the request had allocated is leaked then.
+ */
+static void *upload_worker(void *arg)
+{
+	struct upload_state *state = arg;
+	struct upload_batch *batch;
+	struct error_trap trap;
+
+	for (;;) {
+		pthread_mutex_lock(&state->lock);
+		batch = state->next < state->n_batches ?
+			&state->batches[state->next++] : NULL;
+		pthread_mutex_unlock(&state->lock);
+
+		if (!batch)
+			return NULL;
+
+		error_trap_push(&trap);
+		if (setjmp(trap.env)) {
+			warn("%s", trap.message);
+			continue;
 		}
+		batch->reply = upload_batch_send(state->session, batch);
+		error_trap_pop(&trap);
 	}
+}
 
-	free(params.argv);
+/*
+ * Upload new accounts, as the rows of as many uploadaccounts requests
+ * as upload_batch_size() calls for.  Up to LPASS_UPLOAD_JOBS requests
+ * are in flight at once.
+ *
+ * Uploaded accounts are removed from the list and moved to uploaded,
+ * or freed if that is NULL; those in a request the server refused are
+ * left in it, so that the caller can report or retry them.  Returns the
+ * error of the last refused request.
+ */
+int lastpass_upload(const struct session *session,
+		    struct list_head *accounts,
+		    struct list_head *uploaded)
+{
+	_cleanup_free_ struct account **array = NULL;
+	_cleanup_free_ struct upload_batch *batches = NULL;
+	_cleanup_free_ pthread_t *threads = NULL;
+	struct upload_state state;
+	struct account *account;
+	size_t count = 0, n_batches = 0, n_threads, i, j;
+	int ret = 0, err;
 
-	if (!reply)
-		return -EINVAL;
+	if (list_empty(accounts))
+		return 0;
+
+	list_for_each_entry(account, accounts, list)
+		count++;
+	array = new0(struct account *, count);
+	batches = new0(struct upload_batch, count);
 
-	return xml_api_err(reply);
+	i = 0;
+	list_for_each_entry(account, accounts, list)
+		array[i++] = account;
+
+	for (i = 0; i < count; i += batches[n_batches++].count) {
+		batches[n_batches].accounts = &array[i];
+		batches[n_batches].count = upload_batch_size(&array[i], count - i);
+	}
+
+	state.session = session;
+	state.batches = batches;
+	state.n_batches = n_batches;
+	state.next = 0;
+	pthread_mutex_init(&state.lock, NULL);
+
+	/* this thread sends batches as well */
+	n_threads = min(upload_limit("LPASS_UPLOAD_JOBS", 4), n_batches) - 1;
+	threads = new0(pthread_t, n_threads ? n_threads : 1);
+	for (i = 0; i < n_threads; i++) {
+		if (pthread_create(&threads[i], NULL, upload_worker, &state))
+			break;
+	}
+	/* whatever the workers did not get to is sent from here */
+	upload_worker(&state);
+	n_threads = i;
+	for (i = 0; i < n_threads; i++)
+		pthread_join(threads[i], NULL);
+	pthread_mutex_destroy(&state.lock);
+
+	for (i = 0; i < n_batches; i++) {
+		err = batches[i].reply ? xml_api_err(batches[i].reply) : -EINVAL;
+		free(batches[i].reply);
+		if (err) {
+			ret = err;
+			continue;
+		}
+		for (j = 0; j < batches[i].count; j++) {
+			list_del(&batches[i].accounts[j]->list);
+			if (uploaded)
+				list_add_tail(&batches[i].accounts[j]->list, uploaded);
+			else
+				account_free(batches[i].accounts[j]);
+		}
+	}
+	return ret;
 }
 
 /*
@@ -536,3 +816,164 @@ int lastpass_load_attachment(const struct session *session,
 	*result = reply;
 	return 0;
 }
+
+/* a multiple of 3, so that the base64 of each chunk joins up */
+#define ATTACH_CHUNK_SIZE (48 * 1024)
+#define ATTACH_PLAIN_SIZE (ATTACH_CHUNK_SIZE / 3 * 4)
+
+/*
+ * An attachment is stored as the base64 of the file, encrypted with the
+ * account's attach key and base64ed again.  The file is read, encoded and
+ * encrypted a chunk at a time as curl asks for more of the request body,
+ * so memory use does not depend on its size.
+ */
+struct attach_upload {
+	FILE *fp;
+	struct cipher_aes_stream cipher;
+	unsigned char in[ATTACH_CHUNK_SIZE];
+	char plain[ATTACH_PLAIN_SIZE + 1];
+	char out[CIPHER_AES_STREAM_OUT_LEN(ATTACH_PLAIN_SIZE) +
+		 CIPHER_AES_STREAM_OUT_LEN(0)];
+	size_t out_len, out_pos;
+	size_t sent;
+	bool eof;
+	bool error;
+};
+
+static void attach_upload_fill(struct attach_upload *upload)
+{
+	size_t len, plain_len;
+
+	len = fread(upload->in, 1, ATTACH_CHUNK_SIZE, upload->fp);
+	if (ferror(upload->fp)) {
+		upload->error = true;
+		return;
+	}
+	upload->sent += len;
+
+	plain_len = cipher_base64_block(upload->in, len, upload->plain);
+	upload->out_pos = 0;
+	upload->out_len = cipher_aes_stream_update(&upload->cipher,
+						   upload->plain, plain_len,
+						   upload->out);
+	if (len < ATTACH_CHUNK_SIZE) {
+		upload->out_len += cipher_aes_stream_final(&upload->cipher,
+					upload->out + upload->out_len);
+		upload->eof = true;
+	}
+}
+
+static size_t attach_upload_read(char *buf, size_t len, void *data)
+{
+	static const char hex[] = "0123456789ABCDEF";
+	struct attach_upload *upload = data;
+	size_t n = 0;
+	unsigned char c;
+
+	/* curl's upload buffer is never smaller than 16k */
+	while (n + 3 <= len) {
+		if (upload->out_pos == upload->out_len) {
+			if (upload->eof)
+				break;
+			attach_upload_fill(upload);
+			if (upload->error)
+				return HTTP_READ_ABORT;
+			continue;
+		}
+
+		c = upload->out[upload->out_pos++];
+		if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+		    (c >= '0' && c <= '9')) {
+			buf[n++] = c;
+		} else {
+			buf[n++] = '%';
+			buf[n++] = hex[c >> 4];
+			buf[n++] = hex[c & 0xf];
+		}
+	}
+	return n;
+}
+
+/*
+ * Upload the contents of @fp as a new attachment of @account, named
+ * @filename.  An account without an attach key gets a new one, which is
+ * sent along with the attachment.  The number of bytes read from @fp is
+ * returned in *sent.
+ */
+int lastpass_upload_attachment(const struct session *session,
+			       unsigned const char key[KDF_HASH_LEN],
+			       struct account *account,
+			       const char *filename,
+			       const char *mimetype,
+			       FILE *fp, size_t *sent)
+{
+	_cleanup_free_ unsigned char *attach_key = NULL;
+	_cleanup_free_ char *filename_encrypted = NULL;
+	_cleanup_free_ char *reply = NULL;
+	_cleanup_free_ char *header = NULL;
+	struct attach_upload *upload;
+	unsigned char new_key[KDF_HASH_LEN];
+	int curl_ret, ret;
+	long http_code;
+
+	struct http_param_set params = {
+		.argv = NULL,
+		.n_alloced = 0
+	};
+
+	if (!account->attachkey || strlen(account->attachkey) != KDF_HASH_LEN * 2) {
+		get_random_bytes(new_key, sizeof(new_key));
+		free(account->attachkey);
+		free(account->attachkey_encrypted);
+		account->attachkey = NULL;
+		bytes_to_hex(new_key, &account->attachkey, sizeof(new_key));
+		account->attachkey_encrypted =
+			encrypt_and_base64(account->attachkey,
+					   account->share ? account->share->key : key);
+		http_post_add_params(&params,
+				     "attachkey", account->attachkey_encrypted,
+				     NULL);
+	}
+	if (hex_to_bytes(account->attachkey, &attach_key))
+		return -EINVAL;
+
+	filename_encrypted = encrypt_and_base64(filename, attach_key);
+	http_post_add_params(&params,
+			     "token", session->token,
+			     "aid", account->id,
+			     "filename", filename_encrypted,
+			     "mimetype", mimetype,
+			     NULL);
+	if (account->share) {
+		http_post_add_params(&params,
+				     "sharedfolderid", account->share->id,
+				     NULL);
+	}
+
+	upload = new0(struct attach_upload, 1);
+	upload->fp = fp;
+	header = cipher_aes_stream_init(&upload->cipher, attach_key);
+	upload->out_len = strlcpy(upload->out, header, sizeof(upload->out));
+
+	reply = http_post_lastpass_stream("addattach.php", session, NULL,
+					  params.argv, "data",
+					  attach_upload_read, upload,
+					  &curl_ret, &http_code);
+	free(params.argv);
+
+	if (upload->error)
+		ret = -EIO;
+	else if (curl_ret == CURLE_ABORTED_BY_CALLBACK)
+		ret = -EINTR;
+	else if (!reply)
+		ret = -ENOENT;
+	else
+		ret = xml_api_err(reply);
+
+	if (!ret)
+		account->attachpresent = true;
+	*sent = upload->sent;
+	cipher_aes_stream_free(&upload->cipher);
+	free(upload);
+	return ret;
+}
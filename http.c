@@ -44,6 +44,7 @@
 #include <errno.h>
 #include <string.h>
 #include <signal.h>
+#include <pthread.h>
 #include <openssl/ssl.h>
 #include <curl/curl.h>
 
@@ -53,7 +54,32 @@ struct mem_chunk {
 };
 
 #ifndef TEST_BUILD
-static bool interrupted = false;
+static pthread_once_t http_init_once = PTHREAD_ONCE_INIT;
+static int http_init_ret;
+
+static void http_global_init(void)
+{
+	http_init_ret = curl_global_init(CURL_GLOBAL_DEFAULT);
+}
+
+/*
+ * curl, and with it the TLS library, is only set up once a request is
+ * made, so that commands served from the local cache skip its startup.
+ */
+static void http_lazy_init(void)
+{
+	pthread_once(&http_init_once, http_global_init);
+	if (http_init_ret)
+		die("Unable to initialize curl");
+}
+
+/*
+ * Requests may run on several threads at once; the handler is installed
+ * by the first of them and restored by the last.
+ */
+static pthread_mutex_t interrupt_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int interrupt_users;
+static volatile sig_atomic_t interrupted = false;
 static sig_t previous_handler = SIG_DFL;
 static void interruption_detected(int signal)
 {
@@ -62,13 +88,21 @@ static void interruption_detected(int signal)
 }
 static void set_interrupt_detect(void)
 {
-	interrupted = false;
-	previous_handler = signal(SIGINT, interruption_detected);
+	pthread_mutex_lock(&interrupt_lock);
+	if (!interrupt_users++) {
+		interrupted = false;
+		previous_handler = signal(SIGINT, interruption_detected);
+	}
+	pthread_mutex_unlock(&interrupt_lock);
 }
 static void unset_interrupt_detect(void)
 {
-	interrupted = false;
-	signal(SIGINT, previous_handler);
+	pthread_mutex_lock(&interrupt_lock);
+	if (!--interrupt_users) {
+		interrupted = false;
+		signal(SIGINT, previous_handler);
+	}
+	pthread_mutex_unlock(&interrupt_lock);
 }
 static int check_interruption(void *p, double dltotal, double dlnow, double ultotal, double ulnow)
 {
@@ -199,6 +233,33 @@ void vhttp_post_add_params(struct http_param_set *param_set, va_list args)
 	*argv_ptr = 0;
 }
 
+/*
+ * Percent-encode everything but unreserved characters, as
+ * curl_easy_escape() does, without needing curl to be initialised.
+ */
+char *http_escape(const char *str)
+{
+	static const char hex[] = "0123456789ABCDEF";
+	char *escaped, *out;
+
+	escaped = out = xmalloc(strlen(str) * 3 + 1);
+	for (; *str; str++) {
+		unsigned char c = *str;
+
+		if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+		    (c >= '0' && c <= '9') ||
+		    c == '-' || c == '.' || c == '_' || c == '~') {
+			*out++ = c;
+		} else {
+			*out++ = '%';
+			*out++ = hex[c >> 4];
+			*out++ = hex[c & 0xf];
+		}
+	}
+	*out = '\0';
+	return escaped;
+}
+
 int http_init()
 {
 	curl_global_cleanup();
@@ -229,7 +290,34 @@ char *http_post_lastpass(const char *page, const struct session *session, size_t
 }
 
 #ifndef TEST_BUILD
-char *http_post_lastpass_v_noexit(const char *server, const char *page, const struct session *session, size_t *final_len, char **argv, int *curl_ret, long *http_code)
+/*
+ * Request body for http_post_lastpass_stream(): the url-encoded
+ * parameters, then the output of the caller's reader.
+ */
+struct http_stream {
+	const char *name;
+	http_read_fn read_fn;
+	void *data;
+
+	char *prefix;
+	size_t prefix_len, prefix_pos;
+};
+
+static size_t read_stream(char *ptr, size_t size, size_t nmemb, void *data)
+{
+	struct http_stream *stream = data;
+	size_t len = size * nmemb;
+
+	if (stream->prefix_pos < stream->prefix_len) {
+		len = min(len, stream->prefix_len - stream->prefix_pos);
+		memcpy(ptr, stream->prefix + stream->prefix_pos, len);
+		stream->prefix_pos += len;
+		return len;
+	}
+	return stream->read_fn(ptr, len, stream->data);
+}
+
+static char *http_post(const char *server, const char *page, const struct session *session, size_t *final_len, char **argv, struct http_stream *stream, int *curl_ret, long *http_code)
 {
 	_cleanup_free_ char *url = NULL;
 	_cleanup_free_ char *postdata = NULL;
@@ -254,6 +342,7 @@ char *http_post_lastpass_v_noexit(const char *server, const char *page, const st
 
 	lpass_log(LOG_DEBUG, "Making request to %s\n", url);
 
+	http_lazy_init();
 	curl = curl_easy_init();
 	if (!curl)
 		die("Could not init curl");
@@ -274,6 +363,16 @@ char *http_post_lastpass_v_noexit(const char *server, const char *page, const st
 	if (len && postdata)
 		postdata[len - 1] = '\0';
 
+	if (stream) {
+		encoded_param = curl_easy_escape(curl, stream->name, 0);
+		if (!encoded_param)
+			die("Could not escape %s with curl", stream->name);
+		xasprintf(&stream->prefix, "%s%s%s=", postdata ? postdata : "",
+			  postdata ? "&" : "", encoded_param);
+		stream->prefix_len = strlen(stream->prefix);
+		curl_free(encoded_param);
+	}
+
 	memset(&result, 0, sizeof(result));
 	curl_easy_setopt(curl, CURLOPT_URL, url);
 	curl_easy_setopt(curl, CURLOPT_USERAGENT, LASTPASS_CLI_USERAGENT);
@@ -304,7 +403,12 @@ char *http_post_lastpass_v_noexit(const char *server, const char *page, const st
 	curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1);
 	curl_easy_setopt(curl, CURLOPT_PROGRESSFUNCTION, check_interruption);
 	curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0);
-	if (postdata)
+	if (stream) {
+		/* no length up front, so the body goes out chunked */
+		curl_easy_setopt(curl, CURLOPT_POST, 1);
+		curl_easy_setopt(curl, CURLOPT_READFUNCTION, read_stream);
+		curl_easy_setopt(curl, CURLOPT_READDATA, stream);
+	} else if (postdata)
 		curl_easy_setopt(curl, CURLOPT_POSTFIELDS, postdata);
 	if (session) {
 		xasprintf(&cookie, "PHPSESSID=%s", session->sessionid);
@@ -327,9 +431,35 @@ char *http_post_lastpass_v_noexit(const char *server, const char *page, const st
 		result.ptr = xstrdup("");
 	if (final_len)
 		*final_len = result.len;
+	if (stream)
+		free(stream->prefix);
 
 	return result.ptr;
 }
+
+char *http_post_lastpass_v_noexit(const char *server, const char *page, const struct session *session, size_t *final_len, char **argv, int *curl_ret, long *http_code)
+{
+	return http_post(server, page, session, final_len, argv, NULL,
+			 curl_ret, http_code);
+}
+
+/*
+ * POST @argv followed by a parameter @name whose value is too large to
+ * hold in memory.  @read_fn fills the buffer it is given with the next part
+ * of the url-encoded value, returning the number of bytes written, 0 at
+ * the end, or HTTP_READ_ABORT to cancel the request.
+ */
+char *http_post_lastpass_stream(const char *page, const struct session *session, size_t *final_len, char **argv, const char *name, http_read_fn read_fn, void *data, int *curl_ret, long *http_code)
+{
+	struct http_stream stream = {
+		.name = name,
+		.read_fn = read_fn,
+		.data = data,
+	};
+
+	return http_post(NULL, page, session, final_len, argv, &stream,
+			 curl_ret, http_code);
+}
 #endif
 
 char *http_post_lastpass_v(const char *server, const char *page, const struct session *session, size_t *final_len, char **argv)
@@ -16,8 +16,12 @@ struct http_param_set
 
 #define HTTP_ERROR_CODE	CURLE_HTTP_RETURNED_ERROR
 #define HTTP_ERROR_CONNECT	CURLE_SSL_CONNECT_ERROR
+#define HTTP_READ_ABORT	CURL_READFUNC_ABORT
+
+typedef size_t (*http_read_fn)(char *buf, size_t len, void *data);
 
 int http_init();
+char *http_escape(const char *str);
 void http_post_add_params(struct http_param_set *params, ...);
 char *http_post_lastpass(const char *page, const struct session *session, size_t *len, ...);
 char *http_post_lastpass_v(const char *server, const char *page, const struct session *session, size_t *len, char **argv);
@@ -25,4 +29,6 @@ char *http_post_lastpass_param_set(const char *page, const struct session *sessi
 				   struct http_param_set *params);
 char *http_post_lastpass_v_noexit(const char *server, const char *page, const struct session *session, size_t *final_len, char **argv, int *curl_ret, long *http_code);
 
+char *http_post_lastpass_stream(const char *page, const struct session *session, size_t *final_len, char **argv, const char *name, http_read_fn read_fn, void *data, int *curl_ret, long *http_code);
+
 #endif
@@ -42,7 +42,7 @@
 
 static void json_format(struct json_field *field, int level, bool is_last);
 
-static void print_json_quoted_string(const char *str)
+void json_print_quoted_string(const char *str)
 {
 	const char *ptr = NULL;
 
@@ -58,7 +58,7 @@ static void print_json_quoted_string(const char *str)
 		case '\\': putchar('\\'); putchar('\\'); break;
 		case  '"': putchar('\\'); putchar('"'); break;
 		default:
-			if ((*ptr) < ' ') {
+			if ((unsigned char) *ptr < ' ') {
 				printf("\\u%04x", *ptr);
 			} else {
 				putchar(*ptr);
@@ -80,10 +80,10 @@ void json_format_string(struct json_field *field, int level, bool is_last)
 {
 	indent(level);
 	if (field->name) {
-		print_json_quoted_string(field->name);
+		json_print_quoted_string(field->name);
 		printf(": ");
 	}
-	print_json_quoted_string(field->u.string_value);
+	json_print_quoted_string(field->u.string_value);
 	printf("%c\n", is_last ? ' ' : ',');
 }
 
@@ -101,7 +101,7 @@ void json_format_array(struct json_field *field, int level, bool is_last)
 	indent(level);
 
 	if (field->name) {
-		print_json_quoted_string(field->name);
+		json_print_quoted_string(field->name);
 		printf(": ");
 	}
 	printf ("[\n");
@@ -126,7 +126,7 @@ void json_format_object(struct json_field *field, int level, bool is_last)
 	indent(level);
 
 	if (field->name) {
-		print_json_quoted_string(field->name);
+		json_print_quoted_string(field->name);
 		printf(": ");
 	}
 	printf ("{\n");
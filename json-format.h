@@ -32,5 +32,6 @@ struct json_field
 };
 
 void json_format_account_list(struct list_head *accounts);
+void json_print_quoted_string(const char *str);
 
 #endif /* JSON_FORMAT_H */
@@ -0,0 +1,229 @@
+/*
+ * on-demand loading of libcurl and libxml2
+ *
+ * Copyright (C) 2014-2018 LastPass.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ *
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ *
+ * See LICENSE.OpenSSL for more details regarding this exception.
+ */
+/*
+ * With LAZY_LOAD, lpass is not linked against libcurl and libxml2:
+ * together with their dependencies they made up most of the dynamic
+ * loading done at every startup, yet only sync, login and a few other
+ * commands need them.  The functions below stand in for the ones lpass
+ * uses and dlopen() the real library the first time one is called.
+ */
+#define CURL_DISABLE_TYPECHECK
+#include "util.h"
+#include <stdarg.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <curl/curl.h>
+#include <libxml/parser.h>
+#include <libxml/tree.h>
+
+#define lazy_sym(lib, soname, name, dest) do { \
+	union { void *ptr; __typeof__(dest) fn; } sym; \
+	sym.ptr = dlsym(lib, name); \
+	if (!sym.ptr) \
+		die("Unable to find %s in %s", name, soname); \
+	dest = sym.fn; \
+} while (0)
+
+static void *lazy_open(const char *soname)
+{
+	void *lib = dlopen(soname, RTLD_NOW | RTLD_LOCAL);
+	if (!lib)
+		die("Unable to load %s: %s", soname, dlerror());
+	return lib;
+}
+
+static struct {
+	__typeof__(&curl_global_init) global_init;
+	__typeof__(&curl_global_cleanup) global_cleanup;
+	__typeof__(&curl_easy_init) easy_init;
+	__typeof__(&curl_easy_setopt) easy_setopt;
+	__typeof__(&curl_easy_perform) easy_perform;
+	__typeof__(&curl_easy_getinfo) easy_getinfo;
+	__typeof__(&curl_easy_cleanup) easy_cleanup;
+	__typeof__(&curl_easy_strerror) easy_strerror;
+	__typeof__(&curl_easy_escape) easy_escape;
+	__typeof__(&curl_free) free;
+} curl;
+static pthread_once_t curl_once = PTHREAD_ONCE_INIT;
+
+static void load_curl(void)
+{
+	void *lib = lazy_open(LIBCURL_SONAME);
+
+	lazy_sym(lib, LIBCURL_SONAME, "curl_global_init", curl.global_init);
+	lazy_sym(lib, LIBCURL_SONAME, "curl_global_cleanup", curl.global_cleanup);
+	lazy_sym(lib, LIBCURL_SONAME, "curl_easy_init", curl.easy_init);
+	lazy_sym(lib, LIBCURL_SONAME, "curl_easy_setopt", curl.easy_setopt);
+	lazy_sym(lib, LIBCURL_SONAME, "curl_easy_perform", curl.easy_perform);
+	lazy_sym(lib, LIBCURL_SONAME, "curl_easy_getinfo", curl.easy_getinfo);
+	lazy_sym(lib, LIBCURL_SONAME, "curl_easy_cleanup", curl.easy_cleanup);
+	lazy_sym(lib, LIBCURL_SONAME, "curl_easy_strerror", curl.easy_strerror);
+	lazy_sym(lib, LIBCURL_SONAME, "curl_easy_escape", curl.easy_escape);
+	lazy_sym(lib, LIBCURL_SONAME, "curl_free", curl.free);
+}
+
+#define CURL_FN(fn) (pthread_once(&curl_once, load_curl), curl.fn)
+
+CURLcode curl_global_init(long flags)
+{
+	return CURL_FN(global_init)(flags);
+}
+
+void curl_global_cleanup(void)
+{
+	CURL_FN(global_cleanup)();
+}
+
+CURL *curl_easy_init(void)
+{
+	return CURL_FN(easy_init)();
+}
+
+/*
+ * The option number encodes the type of its argument, which is all we
+ * need to pass it on.
+ */
+CURLcode curl_easy_setopt(CURL *handle, CURLoption option, ...)
+{
+	va_list args;
+	CURLcode ret;
+
+	va_start(args, option);
+	if (option < CURLOPTTYPE_OBJECTPOINT)
+		ret = CURL_FN(easy_setopt)(handle, option, va_arg(args, long));
+	else if (option < CURLOPTTYPE_FUNCTIONPOINT)
+		ret = CURL_FN(easy_setopt)(handle, option, va_arg(args, void *));
+	else if (option < CURLOPTTYPE_OFF_T)
+		ret = CURL_FN(easy_setopt)(handle, option, va_arg(args, void (*)(void)));
+	else if (option < CURLOPTTYPE_OFF_T + 10000)
+		ret = CURL_FN(easy_setopt)(handle, option, va_arg(args, curl_off_t));
+	else
+		ret = CURL_FN(easy_setopt)(handle, option, va_arg(args, void *));
+	va_end(args);
+
+	return ret;
+}
+
+CURLcode curl_easy_perform(CURL *handle)
+{
+	return CURL_FN(easy_perform)(handle);
+}
+
+CURLcode curl_easy_getinfo(CURL *handle, CURLINFO info, ...)
+{
+	va_list args;
+	CURLcode ret;
+
+	va_start(args, info);
+	ret = CURL_FN(easy_getinfo)(handle, info, va_arg(args, void *));
+	va_end(args);
+
+	return ret;
+}
+
+void curl_easy_cleanup(CURL *handle)
+{
+	CURL_FN(easy_cleanup)(handle);
+}
+
+const char *curl_easy_strerror(CURLcode code)
+{
+	return CURL_FN(easy_strerror)(code);
+}
+
+char *curl_easy_escape(CURL *handle, const char *string, int length)
+{
+	return CURL_FN(easy_escape)(handle, string, length);
+}
+
+void curl_free(void *ptr)
+{
+	CURL_FN(free)(ptr);
+}
+
+static struct {
+	__typeof__(&xmlReadMemory) read_memory;
+	__typeof__(&xmlDocGetRootElement) doc_get_root_element;
+	__typeof__(&xmlNodeListGetString) node_list_get_string;
+	__typeof__(&xmlFreeDoc) free_doc;
+	__typeof__(&xmlStrcmp) str_cmp;
+	__typeof__(&xmlStrncmp) strn_cmp;
+} xml;
+static pthread_once_t xml_once = PTHREAD_ONCE_INIT;
+
+static void load_xml(void)
+{
+	void *lib = lazy_open(LIBXML2_SONAME);
+
+	lazy_sym(lib, LIBXML2_SONAME, "xmlReadMemory", xml.read_memory);
+	lazy_sym(lib, LIBXML2_SONAME, "xmlDocGetRootElement", xml.doc_get_root_element);
+	lazy_sym(lib, LIBXML2_SONAME, "xmlNodeListGetString", xml.node_list_get_string);
+	lazy_sym(lib, LIBXML2_SONAME, "xmlFreeDoc", xml.free_doc);
+	lazy_sym(lib, LIBXML2_SONAME, "xmlStrcmp", xml.str_cmp);
+	lazy_sym(lib, LIBXML2_SONAME, "xmlStrncmp", xml.strn_cmp);
+}
+
+#define XML_FN(fn) (pthread_once(&xml_once, load_xml), xml.fn)
+
+xmlDocPtr xmlReadMemory(const char *buffer, int size, const char *URL, const char *encoding, int options)
+{
+	return XML_FN(read_memory)(buffer, size, URL, encoding, options);
+}
+
+xmlNodePtr xmlDocGetRootElement(const xmlDoc *doc)
+{
+	return XML_FN(doc_get_root_element)(doc);
+}
+
+xmlChar *xmlNodeListGetString(xmlDocPtr doc, const xmlNode *list, int inLine)
+{
+	return XML_FN(node_list_get_string)(doc, list, inLine);
+}
+
+void xmlFreeDoc(xmlDocPtr cur)
+{
+	XML_FN(free_doc)(cur);
+}
+
+int xmlStrcmp(const xmlChar *str1, const xmlChar *str2)
+{
+	return XML_FN(str_cmp)(str1, str2);
+}
+
+int xmlStrncmp(const xmlChar *str1, const xmlChar *str2, int len)
+{
+	return XML_FN(strn_cmp)(str1, str2, len);
+}
@@ -0,0 +1,545 @@
+/*
+ * library interface to the local vault
+ *
+ * Copyright (C) 2014-2024 LastPass.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ *
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ *
+ * See LICENSE.OpenSSL for more details regarding this exception.
+ */
+#include "liblpass.h"
+#include "agent.h"
+#include "blob.h"
+#include "config.h"
+#include "endpoints.h"
+#include "kdf.h"
+#include "session.h"
+#include "util.h"
+#include <errno.h>
+#include <pthread.h>
+#include <regex.h>
+#include <string.h>
+#include <sys/mman.h>
+
+struct lpass {
+	pthread_mutex_t lock;
+	unsigned char key[KDF_HASH_LEN];
+	struct session *session;
+	struct blob *blob;
+};
+
+/*
+ * Every entry point runs with the handle locked and an error trap set,
+ * so that a die() deep inside the core unwinds back here.  Memory held
+ * by the interrupted call is leaked in that case, and the in-memory
+ * vault is dropped since it may be half-modified; it is re-read from
+ * disk on the next call.
+ */
+#define lpass_enter(lp, trap, error) do { \
+	pthread_mutex_lock(&(lp)->lock); \
+	error_trap_push(&(trap)); \
+	if (setjmp((trap).env)) \
+		return lpass_trapped(lp, &(trap), error); \
+} while (0)
+
+static int lpass_leave(struct lpass *lp, struct error_trap *trap, int ret)
+{
+	error_trap_pop(trap);
+	pthread_mutex_unlock(&lp->lock);
+	return ret;
+}
+
+static int set_error(char **error, int ret, const char *fmt, ...) _printf_(3, 4);
+static int set_error(char **error, int ret, const char *fmt, ...)
+{
+	va_list params;
+
+	if (!error)
+		return ret;
+
+	va_start(params, fmt);
+	if (vasprintf(error, fmt, params) < 0)
+		*error = NULL;
+	va_end(params);
+	return ret;
+}
+
+static void unload(struct lpass *lp)
+{
+	blob_free(lp->blob);
+	session_free(lp->session);
+	lp->blob = NULL;
+	lp->session = NULL;
+}
+
+static int lpass_trapped(struct lpass *lp, struct error_trap *trap, char **error)
+{
+	unload(lp);
+	pthread_mutex_unlock(&lp->lock);
+	return set_error(error, -EIO, "%s", trap->message);
+}
+
+static int load(struct lpass *lp, char **error)
+{
+	unload(lp);
+
+	lp->session = session_load(lp->key);
+	if (!lp->session)
+		return set_error(error, -ENOENT, "Could not find session. Perhaps you need to login with `lpass login`.");
+
+	lp->blob = blob_load(BLOB_SYNC_NO, lp->session, lp->key, false);
+	if (!lp->blob)
+		return set_error(error, -ENOENT, "Unable to read the local vault. Perhaps you need to run `lpass sync`.");
+
+	return 0;
+}
+
+static int ensure_loaded(struct lpass *lp, char **error)
+{
+	if (lp->blob)
+		return 0;
+	return load(lp, error);
+}
+
+static int load_key(unsigned char key[KDF_HASH_LEN], const char *password, char **error)
+{
+	_cleanup_free_ char *iterationbuf = NULL;
+	_cleanup_free_ char *username = NULL;
+	_cleanup_free_ unsigned char *key_buffer = NULL;
+	int iterations;
+
+	if (!password) {
+		if (config_read_buffer("plaintext_key", &key_buffer) != KDF_HASH_LEN)
+			return set_error(error, -ENOENT, "No stored key; a password is required.");
+		memcpy(key, key_buffer, KDF_HASH_LEN);
+		secure_clear(key_buffer, KDF_HASH_LEN);
+	} else {
+		iterationbuf = config_read_string("iterations");
+		username = config_read_string("username");
+		if (!iterationbuf || !username)
+			return set_error(error, -ENOENT, "Not logged in.");
+		iterations = strtoul(iterationbuf, NULL, 10);
+		if (iterations <= 0)
+			return set_error(error, -EINVAL, "Invalid iteration count.");
+		kdf_decryption_key(username, password, iterations, key);
+	}
+
+	if (!agent_verify_key(key)) {
+		secure_clear(key, KDF_HASH_LEN);
+		return set_error(error, -EACCES, "Incorrect master password.");
+	}
+	return 0;
+}
+
+int lpass_open(struct lpass **lpp, const char *password, char **error)
+{
+	struct error_trap trap;
+	struct lpass *lp;
+	int ret;
+
+	*lpp = NULL;
+	lp = calloc(1, sizeof(*lp));
+	if (!lp)
+		return set_error(error, -ENOMEM, "Out of memory.");
+	pthread_mutex_init(&lp->lock, NULL);
+	mlock(lp->key, KDF_HASH_LEN);
+
+	pthread_mutex_lock(&lp->lock);
+	error_trap_push(&trap);
+	if (setjmp(trap.env)) {
+		ret = lpass_trapped(lp, &trap, error);
+		lpass_close(lp);
+		return ret;
+	}
+	ret = load_key(lp->key, password, error);
+	if (!ret)
+		ret = load(lp, error);
+	lpass_leave(lp, &trap, ret);
+
+	if (ret) {
+		lpass_close(lp);
+		return ret;
+	}
+	*lpp = lp;
+	return 0;
+}
+
+void lpass_close(struct lpass *lp)
+{
+	if (!lp)
+		return;
+
+	unload(lp);
+	secure_clear(lp->key, KDF_HASH_LEN);
+	pthread_mutex_destroy(&lp->lock);
+	free(lp);
+}
+
+int lpass_reload(struct lpass *lp, char **error)
+{
+	struct error_trap trap;
+
+	lpass_enter(lp, trap, error);
+	return lpass_leave(lp, &trap, load(lp, error));
+}
+
+static struct lpass_entry *entry_new(const struct account *account)
+{
+	struct lpass_entry *entry = new0(struct lpass_entry, 1);
+
+	entry->id = xstrdup(account->id);
+	entry->name = xstrdup(account->name);
+	entry->fullname = xstrdup(account->fullname);
+	entry->group = xstrdup(account->group);
+	entry->share = account->share ? xstrdup(account->share->name) : NULL;
+	entry->url = xstrdup(account->url);
+	entry->username = xstrdup(account->username);
+	entry->password = xstrdup(account->password);
+	entry->note = xstrdup(account->note);
+	entry->pwprotect = account->pwprotect;
+	return entry;
+}
+
+void lpass_entry_free(struct lpass_entry *entry)
+{
+	if (!entry)
+		return;
+
+	free(entry->id);
+	free(entry->name);
+	free(entry->fullname);
+	free(entry->group);
+	free(entry->share);
+	free(entry->url);
+	free(entry->username);
+	free(entry->password);
+	free(entry->note);
+	free(entry);
+}
+
+void lpass_entries_free(struct lpass_entry **entries, size_t count)
+{
+	size_t i;
+
+	if (!entries)
+		return;
+
+	for (i = 0; i < count; i++)
+		lpass_entry_free(entries[i]);
+	free(entries);
+}
+
+static struct account *find_by_id(struct lpass *lp, const char *id)
+{
+	struct account *account;
+
+	list_for_each_entry(account, &lp->blob->account_head, list) {
+		if (!strcmp(account->id, id))
+			return account;
+	}
+	return NULL;
+}
+
+static int find(struct lpass *lp, const char *pattern, enum lpass_match match,
+		struct lpass_entry ***entries, size_t *count, char **error)
+{
+	struct account *account;
+	struct lpass_entry **result = NULL;
+	size_t n = 0, alloced = 0;
+	regex_t regex;
+	int ret;
+
+	ret = ensure_loaded(lp, error);
+	if (ret)
+		return ret;
+
+	if (match == LPASS_MATCH_REGEX && regcomp(&regex, pattern, REG_ICASE))
+		return set_error(error, -EINVAL, "Invalid regex '%s'", pattern);
+
+	list_for_each_entry(account, &lp->blob->account_head, list) {
+		bool matched;
+
+		if (account_is_group(account))
+			continue;
+
+		switch (match) {
+		case LPASS_MATCH_EXACT:
+			matched = !strcmp(account->id, pattern) ||
+				  !strcmp(account->name, pattern) ||
+				  !strcmp(account->fullname, pattern);
+			break;
+		case LPASS_MATCH_SUBSTRING:
+			matched = strcasestr(account->id, pattern) ||
+				  strcasestr(account->fullname, pattern);
+			break;
+		case LPASS_MATCH_REGEX:
+			matched = !regexec(&regex, account->id, 0, NULL, 0) ||
+				  !regexec(&regex, account->fullname, 0, NULL, 0);
+			break;
+		default:
+			matched = false;
+		}
+		if (!matched)
+			continue;
+
+		if (n == alloced) {
+			alloced = alloced ? alloced * 2 : 16;
+			result = xreallocarray(result, alloced, sizeof(*result));
+		}
+		result[n++] = entry_new(account);
+	}
+
+	if (match == LPASS_MATCH_REGEX)
+		regfree(&regex);
+
+	*entries = result;
+	*count = n;
+	return 0;
+}
+
+int lpass_find(struct lpass *lp, const char *pattern, enum lpass_match match,
+	       struct lpass_entry ***entries, size_t *count, char **error)
+{
+	struct error_trap trap;
+
+	*entries = NULL;
+	*count = 0;
+
+	lpass_enter(lp, trap, error);
+	return lpass_leave(lp, &trap, find(lp, pattern, match, entries, count, error));
+}
+
+static int get(struct lpass *lp, const char *id, struct lpass_entry **entry, char **error)
+{
+	struct account *account;
+	int ret;
+
+	ret = ensure_loaded(lp, error);
+	if (ret)
+		return ret;
+
+	account = find_by_id(lp, id);
+	if (!account)
+		return set_error(error, -ENOENT, "Could not find entry %s.", id);
+
+	*entry = entry_new(account);
+	return 0;
+}
+
+int lpass_get(struct lpass *lp, const char *id, struct lpass_entry **entry, char **error)
+{
+	struct error_trap trap;
+
+	*entry = NULL;
+
+	lpass_enter(lp, trap, error);
+	return lpass_leave(lp, &trap, get(lp, id, entry, error));
+}
+
+static struct field *find_field(struct account *account, const char *name)
+{
+	struct field *field;
+
+	list_for_each_entry(field, &account->field_head, list) {
+		if (!strcmp(field->name, name))
+			return field;
+	}
+	return NULL;
+}
+
+static int get_field(struct lpass *lp, const char *id, const char *name,
+		     char **value, char **error)
+{
+	struct account *account, *expanded;
+	struct field *field;
+	const char *result = NULL;
+	int ret;
+
+	ret = ensure_loaded(lp, error);
+	if (ret)
+		return ret;
+
+	account = find_by_id(lp, id);
+	if (!account)
+		return set_error(error, -ENOENT, "Could not find entry %s.", id);
+
+	expanded = notes_expand(account);
+	if (expanded)
+		account = expanded;
+
+	if (!strcmp(name, "id"))
+		result = account->id;
+	else if (!strcmp(name, "name"))
+		result = account->name;
+	else if (!strcmp(name, "fullname"))
+		result = account->fullname;
+	else if (!strcmp(name, "group"))
+		result = account->group;
+	else if (!strcmp(name, "url"))
+		result = account->url;
+	else if (!strcmp(name, "username"))
+		result = account->username;
+	else if (!strcmp(name, "password"))
+		result = account->password;
+	else if (!strcmp(name, "notes"))
+		result = account->note;
+	else if ((field = find_field(account, name)))
+		result = field->value;
+
+	if (result)
+		*value = xstrdup(result);
+	else
+		ret = set_error(error, -ENOENT, "Could not find field %s.", name);
+
+	account_free(expanded);
+	return ret;
+}
+
+int lpass_get_field(struct lpass *lp, const char *id, const char *field,
+		    char **value, char **error)
+{
+	struct error_trap trap;
+
+	*value = NULL;
+
+	lpass_enter(lp, trap, error);
+	return lpass_leave(lp, &trap, get_field(lp, id, field, value, error));
+}
+
+/*
+ * Full name of account with either the group or the name replaced,
+ * keeping any shared folder prefix.
+ */
+static char *replace_fullname(struct account *account, const char *group, const char *name)
+{
+	char *fullname;
+
+	if (!group)
+		group = account->group;
+	if (!name)
+		name = account->name;
+
+	if (account->share)
+		xasprintf(&fullname, "%s/%s%s%s", account->share->name,
+			  group, *group ? "/" : "", name);
+	else
+		xasprintf(&fullname, "%s%s%s", group, *group ? "/" : "", name);
+	return fullname;
+}
+
+static int set_field(struct lpass *lp, const char *id, const char *name,
+		     const char *value, char **error)
+{
+	struct account *account, *editable, *collapsed;
+	struct share *old_share;
+	struct field *field;
+	unsigned char *key = lp->key;
+	struct feature_flag *feature_flag;
+	int ret;
+
+	ret = ensure_loaded(lp, error);
+	if (ret)
+		return ret;
+
+	account = find_by_id(lp, id);
+	if (!account)
+		return set_error(error, -ENOENT, "Could not find entry %s.", id);
+
+	feature_flag = &lp->session->feature_flag;
+	old_share = account->share;
+	editable = notes_expand(account);
+	if (!editable)
+		editable = account;
+
+	if (!strcmp(name, "name") || !strcmp(name, "fullname") || !strcmp(name, "group")) {
+		char *fullname;
+
+		if (!strcmp(name, "fullname"))
+			fullname = xstrdup(value);
+		else if (!strcmp(name, "group"))
+			fullname = replace_fullname(editable, value, NULL);
+		else
+			fullname = replace_fullname(editable, NULL, value);
+		account_set_fullname(editable, fullname, key);
+	} else if (!strcmp(name, "url"))
+		account_set_url(editable, xstrdup(value), key, feature_flag);
+	else if (!strcmp(name, "username"))
+		account_set_username(editable, xstrdup(value), key);
+	else if (!strcmp(name, "password"))
+		account_set_password(editable, xstrdup(value), key);
+	else if (!strcmp(name, "notes"))
+		account_set_note(editable, xstrdup(value), key);
+	else if (!strcmp(name, "id")) {
+		ret = set_error(error, -EINVAL, "The id of an entry cannot be changed.");
+	} else if (editable == account) {
+		ret = set_error(error, -EINVAL, "Only secure notes have fields.");
+	} else {
+		field = find_field(editable, name);
+		if (!field) {
+			field = new0(struct field, 1);
+			field->type = xstrdup("text");
+			field->name = xstrdup(name);
+			list_add_tail(&field->list, &editable->field_head);
+		}
+		field_set_value(editable, field, xstrdup(value), key);
+	}
+
+	if (editable != account) {
+		if (!ret) {
+			collapsed = notes_collapse(editable);
+			account_set_note(account, xstrdup(collapsed->note), key);
+			account_set_fullname(account, xstrdup(collapsed->fullname), key);
+			account_free(collapsed);
+		}
+		account_free(editable);
+	}
+	if (ret)
+		return ret;
+
+	account_assign_share(lp->blob, account, key, feature_flag);
+	if (account->share != old_share) {
+		unload(lp);
+		return set_error(error, -EINVAL, "Use lpass mv to move items to/from shared folders.");
+	}
+	if (!account->dirty)
+		return 0;
+
+	lastpass_update_account(BLOB_SYNC_NO, key, lp->session, account, lp->blob);
+	blob_save(lp->blob, key, feature_flag);
+	return 0;
+}
+
+int lpass_set_field(struct lpass *lp, const char *id, const char *field,
+		    const char *value, char **error)
+{
+	struct error_trap trap;
+
+	lpass_enter(lp, trap, error);
+	return lpass_leave(lp, &trap, set_field(lp, id, field, value, error));
+}
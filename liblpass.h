@@ -0,0 +1,90 @@
+#ifndef LIBLPASS_H
+#define LIBLPASS_H
+
+/*
+ * liblpass: in-process access to the local lpass vault.
+ *
+ * A handle works on the session and vault that `lpass login` and
+ * `lpass sync` left in the configuration directory (LPASS_HOME, or the
+ * usual XDG locations); the library itself never talks to the network.
+ * Changes are written to the local vault and queued for upload by the
+ * next `lpass sync`.
+ *
+ * Handles carry all of their state and serialise their own calls, so a
+ * handle may be shared between threads, and any number of handles may
+ * be used concurrently.  Functions return 0 on success or a negative
+ * errno value on failure; if error is not NULL it then receives a
+ * message, which the caller frees with free().  Strings and entries
+ * returned by the library are owned by the caller.
+ *
+ * Errors found deep inside the library, such as a corrupt vault file,
+ * unwind straight back to the entry point: the memory that call had
+ * allocated is leaked, and the handle's vault is re-read from disk on
+ * its next call.  Warnings are printed to stderr, in colour only if it
+ * is a terminal.  Beyond that the library keeps no process-wide state;
+ * the colour mode and clipboard settings of the command line are
+ * neither set nor used by it.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LPASS_API __attribute__((visibility("default")))
+
+struct lpass;
+
+struct lpass_entry {
+	char *id;
+	char *name;
+	char *fullname;
+	char *group;
+	char *share;		/* shared folder name, NULL if not shared */
+	char *url;
+	char *username;
+	char *password;
+	char *note;
+	bool pwprotect;
+};
+
+enum lpass_match {
+	LPASS_MATCH_EXACT,	/* name, full name or id */
+	LPASS_MATCH_SUBSTRING,	/* substring of the full name or id */
+	LPASS_MATCH_REGEX,	/* basic regular expression on the full name or id */
+};
+
+/*
+ * Open the local vault.  With a NULL password the key stored by
+ * `lpass login --plaintext-key` is used, otherwise the key is derived
+ * from the master password.
+ */
+LPASS_API int lpass_open(struct lpass **lp, const char *password, char **error);
+LPASS_API void lpass_close(struct lpass *lp);
+
+/* Re-read the session and vault, e.g. after `lpass sync` ran. */
+LPASS_API int lpass_reload(struct lpass *lp, char **error);
+
+LPASS_API int lpass_find(struct lpass *lp, const char *pattern, enum lpass_match match,
+			 struct lpass_entry ***entries, size_t *count, char **error);
+LPASS_API int lpass_get(struct lpass *lp, const char *id, struct lpass_entry **entry, char **error);
+
+/*
+ * Field names are id, name, fullname, group, url, username, password
+ * and notes, or the name of a secure note or custom field.
+ */
+LPASS_API int lpass_get_field(struct lpass *lp, const char *id, const char *field,
+			      char **value, char **error);
+LPASS_API int lpass_set_field(struct lpass *lp, const char *id, const char *field,
+			      const char *value, char **error);
+
+LPASS_API void lpass_entry_free(struct lpass_entry *entry);
+LPASS_API void lpass_entries_free(struct lpass_entry **entries, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
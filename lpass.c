@@ -37,7 +37,6 @@
 #include "cmd.h"
 #include "string.h"
 #include "util.h"
-#include "http.h"
 #include "config.h"
 #include "terminal.h"
 #include "version.h"
@@ -61,12 +60,16 @@ static struct {
 	CMD(passwd),
 	CMD(show),
 	CMD(ls),
+	CMD(pick),
+	CMD(query),
 	CMD(mv),
 	CMD(add),
 	CMD(edit),
 	CMD(generate),
 	CMD(duplicate),
 	CMD(rm),
+	CMD(attach),
+	CMD(materialize),
 	CMD(status),
 	CMD(sync),
 	CMD(export),
@@ -200,9 +203,6 @@ int main(int argc, char *argv[])
 	/* Do not remove this umask. Always keep at top. */
 	umask(0077);
 
-	if (http_init())
-		die("Unable to initialize curl");
-
 	load_saved_environment();
 
 	if (argc >= 2 && argv[1][0] != '-')
@@ -39,8 +39,14 @@
 #include "cipher.h"
 #include "agent.h"
 #include "upload-queue.h"
+#include "usage.h"
+#include "process.h"
 #include <sys/mman.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 struct session *session_new(void)
 {
@@ -101,8 +107,54 @@ struct session *session_load(unsigned const char key[KDF_HASH_LEN])
 	}
 }
 
+/*
+ * `login --background` leaves the wait for an out-of-band approval to a
+ * child process, which keeps its pid in login.pid until the session has
+ * been saved.
+ */
+static pid_t session_login_pid(void)
+{
+	_cleanup_free_ char *pidstr = NULL;
+	pid_t pid;
+
+	pidstr = config_read_string("login.pid");
+	if (!pidstr)
+		return 0;
+	pid = strtoul(pidstr, NULL, 10);
+	if (!pid || !process_is_same_executable(pid))
+		return 0;
+	return pid;
+}
+
+bool session_login_pending(void)
+{
+	return session_login_pid() != 0;
+}
+
+void session_login_wait(void)
+{
+	if (!session_login_pending())
+		return;
+
+	fprintf(stderr, "Waiting for approval of a background login...\n");
+	while (session_login_pending())
+		usleep(1000000 / 3);
+}
+
+static void session_login_kill(void)
+{
+	pid_t pid = session_login_pid();
+
+	if (pid)
+		kill(pid, SIGTERM);
+	config_unlink("login.pid");
+}
+
 void session_kill()
 {
+	/* the agent must be done with the session before it is removed */
+	agent_kill();
+
 	config_unlink("verify");
 	config_unlink("username");
 	config_unlink("session_sessionid");
@@ -114,6 +166,7 @@ void session_kill()
 	config_unlink("session_privatekey");
 	config_unlink("session_server");
 	config_unlink("plaintext_key");
-	agent_kill();
+	session_login_kill();
 	upload_queue_kill();
+	usage_kill();
 }
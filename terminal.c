@@ -43,37 +43,68 @@
 
 static enum color_mode color_mode = COLOR_MODE_AUTO;
 
+/* whether stdin, stdout and stderr are terminals: -1 until asked */
+static __thread int std_isatty[3] = { -1, -1, -1 };
+
+static bool use_color(FILE *file)
+{
+	int fd;
+
+	if (color_mode != COLOR_MODE_AUTO)
+		return color_mode == COLOR_MODE_ALWAYS;
+
+	fd = fileno(file);
+	if (fd < 0 || fd >= (int) ARRAY_SIZE(std_isatty))
+		return isatty(fd);
+	if (std_isatty[fd] < 0)
+		std_isatty[fd] = isatty(fd);
+	return std_isatty[fd];
+}
+
+/*
+ * Print, dropping any ANSI escape sequences from the formatted output.
+ *
+ * Output is formatted into a buffer on the stack, or allocated only
+ * for long lines, and filtered in place in one pass, so piped output
+ * costs a single write to the stdio buffer per call.
+ */
 static void filter_ansi(FILE *file, const char *fmt, va_list args)
 {
-	_cleanup_free_ char *str = NULL;
+	char stack_buf[1024];
+	_cleanup_free_ char *long_buf = NULL;
+	char *buf = stack_buf;
+	va_list copy;
 	size_t len, i, j;
+	int ret;
 
-	if (color_mode == COLOR_MODE_ALWAYS ||
-	    (color_mode == COLOR_MODE_AUTO && isatty(fileno(file)))) {
+	if (use_color(file)) {
 		vfprintf(file, fmt, args);
 		return;
 	}
 
-	len = xvasprintf(&str, fmt, args);
-
-	for (i = 0; len >= 2 && i < len - 2; ++i) {
-		if (str[i] == '\x1b' && str[i + 1] == '[') {
-			str[i] = str[i + 1] = '\0';
-			for (j = i + 2; j < len; ++j) {
-				if (isalpha(str[j]))
-					break;
-				str[j] = '\0';
-			}
-			str[j] = '\0';
-		}
+	va_copy(copy, args);
+	ret = vsnprintf(buf, sizeof(stack_buf), fmt, copy);
+	va_end(copy);
+	if (ret < 0)
+		die_errno("vsnprintf");
+	len = ret;
+	if (len >= sizeof(stack_buf)) {
+		buf = long_buf = xmalloc(len + 1);
+		vsnprintf(buf, len + 1, fmt, args);
 	}
-	for (i = 0; i < len; i = j) {
-		fputs(&str[i], file);
-		for (j = i + strlen(&str[i]); j < len; ++j) {
-			if (str[j] != '\0')
-				break;
+
+	for (i = j = 0; i < len; ++i) {
+		if (buf[i] == '\x1b' && i + 2 < len && buf[i + 1] == '[') {
+			/* skip to the final letter of the sequence */
+			for (i += 2; i < len && !isalpha((unsigned char) buf[i]); ++i)
+				;
+			continue;
 		}
+		/* as with fputs(), NUL bytes are not printed */
+		if (buf[i])
+			buf[j++] = buf[i];
 	}
+	fwrite(buf, 1, j, file);
 }
 
 void terminal_set_color_mode(enum color_mode mode)
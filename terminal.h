@@ -25,6 +25,8 @@
 
 #define TERMINAL_BOLD		"\x1b[1m"
 #define TERMINAL_NO_BOLD	"\x1b[22m"
+#define TERMINAL_REVERSE	"\x1b[7m"
+#define TERMINAL_NO_REVERSE	"\x1b[27m"
 #define TERMINAL_UNDERLINE	"\x1b[4m"
 #define TERMINAL_NO_UNDERLINE	"\x1b[24m"
 
@@ -42,6 +44,10 @@
 #define TERMINAL_CLEAR_LEFT	"\x1b[1K"
 #define TERMINAL_CLEAR_LINE	"\x1b[2K"
 #define TERMINAL_CLEAR_ALL	"\x1b[2J"
+#define TERMINAL_HOME_CURSOR	"\x1b[H"
+
+#define TERMINAL_ENTER_ALT_SCREEN "\x1b[?1049h"
+#define TERMINAL_LEAVE_ALT_SCREEN "\x1b[?1049l"
 
 enum color_mode {
 	COLOR_MODE_AUTO,
@@ -36,8 +36,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
 #include "../util.h"
 #include "../blob.h"
+#include "../cipher.h"
+#include "../http.h"
 
 #define TEST_USER "user@example.com"
 #define TEST_PASS "123456"
@@ -56,6 +62,166 @@ struct test_data
 
 struct test_data test_data;
 
+/*
+ * Pad the vault with generated entries so that the perf suite can
+ * exercise vaults of various sizes.  The number of entries is taken
+ * from LPASS_MOCK_ACCOUNTS; every tenth entry is a secure note.
+ */
+static void add_synthetic_accounts(unsigned char *key,
+				   const struct feature_flag *feature_flag)
+{
+	struct account *account;
+	char *count_str;
+	unsigned long count, i;
+
+	count_str = getenv("LPASS_MOCK_ACCOUNTS");
+	if (!count_str)
+		return;
+
+	count = strtoul(count_str, NULL, 10);
+	for (i = 0; i < count; i++) {
+		char *name, *group, *username, *password, *url, *note;
+
+		xasprintf(&name, "perf-account-%06lu", i);
+		xasprintf(&group, "perf-group-%02lu", i % 50);
+
+		account = new_account();
+		xasprintf(&account->id, "%lu", 100000 + i);
+		account_set_name(account, name, key);
+		account_set_group(account, group, key);
+
+		if (i % 10 == 9) {
+			xasprintf(&note, "NoteType: Server\n"
+				  "Hostname: host-%lu.example.com\n"
+				  "Username: perf-user-%lu\n"
+				  "Password: perf-password-%lu", i, i, i);
+			account_set_username(account, xstrdup(""), key);
+			account_set_password(account, xstrdup(""), key);
+			account_set_url(account, xstrdup("http://sn"), key, feature_flag);
+			account_set_note(account, note, key);
+		} else {
+			xasprintf(&username, "perf-user-%lu@example.com", i);
+			xasprintf(&password, "perf-password-%lu", i);
+			xasprintf(&url, "https://site-%lu.example.com/login", i);
+			account_set_username(account, username, key);
+			account_set_password(account, password, key);
+			account_set_url(account, url, key, feature_flag);
+			account_set_note(account, xstrdup(""), key);
+		}
+		list_add_tail(&account->list, &test_data.blob.account_head);
+	}
+}
+
+/*
+ * The RSA key of the test user, as PKCS#8 DER, which shared folder keys
+ * are encrypted with.
+ */
+static const char test_private_key_hex[] =
+	"30820276020100300d06092a864886f70d0101010500048202603082025c0201"
+	"0002818100ace6b1c3afa6065656a06380cafe3a00bd4b0541344bd9e8d35a59"
+	"f49ee801050e599d292bd0f3307a6d577a88b5055bfb9e50ac149b323da4b4e8"
+	"cb1c62f4be9ab93fcbd9bafa92f727bd11d113d20b8e3af3b1fa145ffa32c011"
+	"23f9903ecd032863f4ccbb619e893c23015512668be2b3aa12910902c8ba634f"
+	"706ff4afa50203010001028180443819b77e1c61afbb2a39585dbf851f3990da"
+	"17ea0c6b8423b028820e18b81e48952f1f497c7e1788968fc7771d056a4f931d"
+	"7d67fbfc0cba69eed804f13e63381a5a50ac0fb42de450b47a0f082b690c9845"
+	"c66c817ed96034713f202aa109d92218b4b1d435da6615928f08afd0b1773589"
+	"c776063b3c2eb22bc3aa545381024100d5b91d1a3f1b5ce8fd2f540b5785c21e"
+	"a0b697b6fadf2fd93ee875ea79e3f737d56ef122ab3ae25a4a0afe2439253caa"
+	"25312f5846ee6669b081702b5eadd7b5024100cf1a5df244bec786afe927f415"
+	"c738c3029c78fb312f555d5f7fc1d6fa3d7bf33fb429d41b09bcb89d5cf9cfc0"
+	"52362026fa0b6651558b56b91cdf782be88e3102407a72b085d51a2c4520a9f9"
+	"10f678201bc4205913f0efe64e2588b1e64127a7004a3c61d3671f3988595baa"
+	"f7bdf5e3a7e7df222d059698fe7cadec422ce094f102410093df95b8c8511812"
+	"1944771c96f83a9533261a53f0d885313860f63cd34c575665e3f401d8946945"
+	"c04684b04bf7e761a9b2dbb4e0da1db57c531b54a8b551e102401b1fb3af1778"
+	"2fc79ce9f377f35d8e10a0e5d3908dd3aa128e475aa1fca1a019209220fbbdfd"
+	"da4e06145a3601a15cffb1b0422978453e9fe12c32e625a21a4b";
+
+static void append_item(char **buf, size_t *len, const char *str)
+{
+	size_t n = strlen(str);
+	uint32_t be_len = htobe32(n);
+
+	*buf = xrealloc(*buf, *len + sizeof(be_len) + n);
+	memcpy(*buf + *len, &be_len, sizeof(be_len));
+	memcpy(*buf + *len + sizeof(be_len), str, n);
+	*len += sizeof(be_len) + n;
+}
+
+/*
+ * The SHAR chunk of a share: its key goes to the user encrypted with
+ * the user's public key, and its name with its own key.
+ */
+static void make_share_chunk(struct share *share)
+{
+	_cleanup_free_ unsigned char *der = NULL;
+	_cleanup_free_ char *key_hex = NULL;
+	_cleanup_free_ char *enc_hex = NULL;
+	_cleanup_free_ char *name = NULL;
+	struct public_key public_key = { 0 };
+	const unsigned char *p;
+	unsigned char enc[256];
+	size_t enc_len = sizeof(enc);
+	PKCS8_PRIV_KEY_INFO *p8inf;
+	EVP_PKEY *pkey;
+
+	hex_to_bytes(test_private_key_hex, &der);
+	p = der;
+	p8inf = d2i_PKCS8_PRIV_KEY_INFO(NULL, &p, strlen(test_private_key_hex) / 2);
+	pkey = EVP_PKCS82PKEY(p8inf);
+	public_key.len = i2d_PUBKEY(pkey, &public_key.key);
+
+	bytes_to_hex(share->key, &key_hex, KDF_HASH_LEN);
+	cipher_rsa_encrypt(key_hex, &public_key, enc, &enc_len);
+	bytes_to_hex(enc, &enc_hex, enc_len);
+	name = encrypt_and_base64(share->name, share->key);
+
+	append_item(&share->chunk, &share->chunk_len, share->id);
+	append_item(&share->chunk, &share->chunk_len, enc_hex);
+	append_item(&share->chunk, &share->chunk_len, name);
+	append_item(&share->chunk, &share->chunk_len, share->readonly ? "1" : "0");
+
+	OPENSSL_free(public_key.key);
+	EVP_PKEY_free(pkey);
+	PKCS8_PRIV_KEY_INFO_free(p8inf);
+}
+
+/*
+ * With LPASS_MOCK_SHARES set, the vault has a shared folder,
+ * Shared-team, with two sites in it.
+ */
+static void add_shared_accounts(const struct feature_flag *feature_flag)
+{
+	static const char *names[] = { "site1", "site2" };
+	struct account *account;
+	struct share *share;
+	size_t i;
+
+	if (!getenv("LPASS_MOCK_SHARES"))
+		return;
+
+	share = new0(struct share, 1);
+	share->id = xstrdup("5001");
+	share->name = xstrdup("Shared-team");
+	memset(share->key, 0x5a, KDF_HASH_LEN);
+	make_share_chunk(share);
+	list_add_tail(&share->list, &test_data.blob.share_head);
+
+	for (i = 0; i < ARRAY_SIZE(names); i++) {
+		account = new_account();
+		xasprintf(&account->id, "%04zu", 5 + i);
+		account->share = share;
+		account_set_name(account, xstrdup(names[i]), share->key);
+		account_set_group(account, xstrdup(""), share->key);
+		account_set_username(account, xstrdup("team@example.com"), share->key);
+		account_set_password(account, xstrdup("team-password"), share->key);
+		account_set_url(account, xstrdup("https://team.example.com/"), share->key, feature_flag);
+		account_set_note(account, xstrdup(""), share->key);
+		list_add_tail(&account->list, &test_data.blob.account_head);
+	}
+}
+
 static void init_test_data()
 {
 	static bool is_initialized;
@@ -87,7 +253,7 @@ static void init_test_data()
 	account_set_group(account, "test-group", key);
 	account_set_username(account, "xyz@example.com", key);
 	account_set_password(account, "test-account-password", key);
-	account_set_url(account, "https://test-url.example.com/", key, &feature_flag);
+	account_set_url(account, xstrdup("https://test-url.example.com/"), key, &feature_flag);
 	account_set_note(account, "", key);
 	list_add_tail(&account->list, &test_data.blob.account_head);
 
@@ -97,7 +263,7 @@ static void init_test_data()
 	account_set_group(account, "test-group", key);
 	account_set_username(account, xstrdup(""), key);
 	account_set_password(account, xstrdup(""), key);
-	account_set_url(account, "http://sn", key, &feature_flag);
+	account_set_url(account, xstrdup("http://sn"), key, &feature_flag);
 	account_set_note(account,
 		"NoteType: Server\n"
 		"Hostname: foo.example.com\n"
@@ -111,7 +277,7 @@ static void init_test_data()
 	account_set_group(account, "test-group", key);
 	account_set_username(account, "xyz@example.com", key);
 	account_set_password(account, "test-account-password", key);
-	account_set_url(account, "https://test-url.example.com/", key, &feature_flag);
+	account_set_url(account, xstrdup("https://test-url.example.com/"), key, &feature_flag);
 	account_set_note(account, "", key);
 	account->pwprotect = true;
 	list_add_tail(&account->list, &test_data.blob.account_head);
@@ -122,7 +288,7 @@ static void init_test_data()
 	account_set_group(account, "test-group", key);
 	account_set_username(account, xstrdup(""), key);
 	account_set_password(account, xstrdup(""), key);
-	account_set_url(account, "http://sn", key, &feature_flag);
+	account_set_url(account, xstrdup("http://sn"), key, &feature_flag);
 	account_set_note(account,
 		"NoteType: Server\n"
 		"Hostname: foo.example.com\n"
@@ -131,6 +297,12 @@ static void init_test_data()
 	account->pwprotect = true;
 	list_add_tail(&account->list, &test_data.blob.account_head);
 
+	add_synthetic_accounts(key, feature_flag);
+	add_shared_accounts(feature_flag);
+
+	list_for_each_entry(account, &test_data.blob.account_head, list)
+		account_encrypt(account, key, feature_flag);
+
 	is_initialized = true;
 }
 
@@ -174,17 +346,137 @@ static char *show_website(char **argv, size_t *len)
 	return xstrdup("");
 }
 
+static char *get_row_param(char **argv, const char *name, unsigned long row)
+{
+	_cleanup_free_ char *param = NULL;
+
+	xasprintf(&param, "%s%lu", name, row);
+	return get_param(argv, param);
+}
+
+static void replace_string(char **field, const char *value)
+{
+	free(*field);
+	*field = xstrdup(value ? value : "");
+}
+
+/*
+ * Keep an uploaded row, so that getaccts later in the same process
+ * returns it: the account named by its aid is replaced, and a row
+ * without one is added under a new id.
+ */
+static void store_row(char **argv, unsigned long row)
+{
+	static unsigned long next_id = 1000;
+	char *aid = get_row_param(argv, "aid", row);
+	char *url = get_row_param(argv, "url", row);
+	char *pwprotect = get_row_param(argv, "pwprotect", row);
+	struct account *account = NULL, *iter;
+	unsigned char *bytes = NULL;
+
+	if (aid) {
+		list_for_each_entry(iter, &test_data.blob.account_head, list) {
+			if (!strcmp(iter->id, aid)) {
+				account = iter;
+				break;
+			}
+		}
+	}
+	if (!account) {
+		account = new_account();
+		xasprintf(&account->id, "%lu", next_id++);
+		list_add_tail(&account->list, &test_data.blob.account_head);
+	}
+
+	replace_string(&account->name_encrypted, get_row_param(argv, "name", row));
+	replace_string(&account->group_encrypted, get_row_param(argv, "grouping", row));
+	replace_string(&account->username_encrypted, get_row_param(argv, "username", row));
+	replace_string(&account->password_encrypted, get_row_param(argv, "password", row));
+	replace_string(&account->note_encrypted, get_row_param(argv, "extra", row));
+	free(account->url);
+	if (url && !hex_to_bytes(url, &bytes)) {
+		account->url = (char *)bytes;
+	} else {
+		free(bytes);
+		account->url = xstrdup("");
+	}
+	account->pwprotect = pwprotect && !strcmp(pwprotect, "on");
+}
+
+/*
+ * uploadaccounts, as sent by import.  Requests with more rows than
+ * LPASS_MOCK_MAX_ROWS, if set, are refused; the rows of the others are
+ * kept.
+ */
+static char *api(char **argv, size_t *len)
+{
+	char *max_str = getenv("LPASS_MOCK_MAX_ROWS");
+	unsigned long rows = 0, row;
+	char *response;
+	int i;
+
+	for (i = 0; argv[i]; i += 2) {
+		if (starts_with(argv[i], "name"))
+			rows++;
+	}
+
+	if (max_str && rows > strtoul(max_str, NULL, 10)) {
+		response = xstrdup("<lastpass rc=\"FAIL\"><error/></lastpass>");
+	} else {
+		for (row = 0; row < rows; row++)
+			store_row(argv, row);
+		test_data.blob.version++;
+		response = xstrdup("<lastpass rc=\"OK\"><result/></lastpass>");
+	}
+	if (len)
+		*len = strlen(response);
+	return response;
+}
+
 static char *login(char **argv, size_t *len)
 {
 	char *username = get_param(argv, "username");
 	char *hash = get_param(argv, "hash");
 	char *response;
 
+	char *oob_file = getenv("LPASS_MOCK_OOB_FILE");
+	char *oob_request = get_param(argv, "outofbandrequest");
+
 	if (strcmp(username, test_data.username) ||
 	    strcmp(hash, test_data.login_hash)) {
 		response = xstrdup("<response>"
 			"<error message=\"invalid password\"/>"
 			"</response>");
+	} else if (oob_file &&
+		   (!oob_request || strcmp(oob_request, "1") || access(oob_file, F_OK))) {
+		/*
+		 * Out-of-band login: approved once LPASS_MOCK_OOB_FILE
+		 * exists, and until then each retry is held for a moment,
+		 * as the server holds its long poll.
+		 */
+		if (oob_request)
+			usleep(100000);
+		response = xstrdup("<response>"
+			"<error cause=\"outofbandrequired\" "
+			"outofbandname=\"Mock Authenticator\" "
+			"capabilities=\"outofband\" "
+			"retryid=\"1\"/>"
+			"</response>");
+	} else if (getenv("LPASS_MOCK_SHARES")) {
+		struct private_key private_key = { 0 };
+		_cleanup_free_ char *key_enc = NULL;
+
+		private_key.len = strlen(test_private_key_hex) / 2;
+		hex_to_bytes(test_private_key_hex, &private_key.key);
+		key_enc = cipher_encrypt_private_key(&private_key, test_data.key);
+		free(private_key.key);
+		xasprintf(&response, "<response>"
+			"<ok "
+			"uid=\"" TEST_UID "\" "
+			"sessionid=\"1234\" "
+			"token=\"abcd\" "
+			"privatekeyenc=\"%s\"/>"
+			"</response>", key_enc);
 	} else {
 		response = xstrdup("<response>"
 			"<ok "
@@ -213,6 +505,66 @@ static char *login_check(char **argv, size_t *len)
 	return response;
 }
 
+/*
+ * share.php, for the users of Shared-team and their limits.  Limits
+ * that are set are appended to LPASS_MOCK_SHARE_LIMITS, one line of
+ * "uid hidebydefault aids" each, and the last line for a user is what
+ * is read back.
+ */
+static char *share(char **argv, size_t *len)
+{
+	char *limits_path = getenv("LPASS_MOCK_SHARE_LIMITS");
+	char *uid = get_param(argv, "uid");
+	_cleanup_fclose_ FILE *fp = NULL;
+	_cleanup_free_ char *hide = NULL;
+	_cleanup_free_ char *aids = NULL;
+	char line[1024], *aid, *next, *response = NULL, *tmp;
+	int i = 0;
+
+	if (get_param(argv, "getinfo")) {
+		response = xstrdup("<xmlresponse><users>"
+			"<item><realname>Alice</realname><uid>101</uid><group>0</group>"
+			"<username>alice</username><accepted>1</accepted></item>"
+			"<item><realname>Bob</realname><uid>102</uid><group>0</group>"
+			"<username>bob</username><accepted>1</accepted></item>"
+			"</users></xmlresponse>");
+	} else if (get_param(argv, "limit") && get_param(argv, "edit")) {
+		fp = fopen(limits_path, "a");
+		if (fp)
+			fprintf(fp, "%s %s %s\n", uid, get_param(argv, "hidebydefault"),
+				get_param(argv, "aids"));
+		response = xstrdup("<xmlresponse><success>1</success></xmlresponse>");
+	} else if (get_param(argv, "limit")) {
+		fp = limits_path ? fopen(limits_path, "r") : NULL;
+		while (fp && fgets(line, sizeof(line), fp)) {
+			line[strcspn(line, "\n")] = '\0';
+			next = line;
+			if (strcmp(strsep(&next, " "), uid) || !next)
+				continue;
+			free(hide);
+			free(aids);
+			hide = xstrdup(strsep(&next, " "));
+			aids = xstrdup(next ? next : "");
+		}
+		xasprintf(&response, "<xmlresponse><hidebydefault>%s</hidebydefault><aids>",
+			  hide ? hide : "0");
+		for (next = aids; next && (aid = strsep(&next, ",")); ) {
+			if (!*aid)
+				continue;
+			tmp = response;
+			xasprintf(&response, "%s<aid%d>%s</aid%d>", tmp, i, aid, i);
+			free(tmp);
+			i++;
+		}
+		tmp = response;
+		xasprintf(&response, "%s</aids></xmlresponse>", tmp);
+		free(tmp);
+	}
+	if (response && len)
+		*len = strlen(response);
+	return response;
+}
+
 struct page_entry {
 	char *name;
 	char *(*fn)(char **, size_t *);
@@ -220,10 +572,12 @@ struct page_entry {
 
 #define PAGE(x) { .name = #x ".php", .fn = x }
 struct page_entry page_table[] = {
+	{ .name = "lastpass/api.php", .fn = api },
 	PAGE(getaccts),
 	PAGE(iterations),
 	PAGE(login),
 	PAGE(login_check),
+	PAGE(share),
 	PAGE(show_website),
 };
 
@@ -238,10 +592,19 @@ char *http_post_lastpass_v_noexit(const char *server, const char *page,
                                   size_t *final_len, char **argv,
                                   int *curl_ret, long *http_code)
 {
+	static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
 	unsigned int i;
+	char *response = NULL;
+	char *latency = getenv("LPASS_MOCK_LATENCY_MS");
 	UNUSED(server);
 	UNUSED(session);
 
+	/* a round trip to the server, for the perf suite */
+	if (latency)
+		usleep(strtoul(latency, NULL, 10) * 1000);
+
+	/* uploads run on several threads; serve one request at a time */
+	pthread_mutex_lock(&lock);
 	init_test_data();
 
 	*curl_ret = 0;
@@ -249,12 +612,211 @@ char *http_post_lastpass_v_noexit(const char *server, const char *page,
 
 	for (i = 0; i < ARRAY_SIZE(page_table); i++) {
 		if (!strcmp(page, page_table[i].name)) {
-			return page_table[i].fn(argv, final_len);
+			response = page_table[i].fn(argv, final_len);
+			break;
 		}
 	}
-	fprintf(stderr, "unhandled page: %s\n", page);
-	char *response = xstrdup("<response><error message=\"unimplemented\"/></response>");
+	if (!response) {
+		fprintf(stderr, "unhandled page: %s\n", page);
+		response = xstrdup("<response><error message=\"unimplemented\"/></response>");
+		if (final_len)
+			*final_len = strlen(response);
+	}
+	pthread_mutex_unlock(&lock);
+	return response;
+}
+
+/*
+ * Attachment uploads, which arrive as a stream: the body is url-decoded,
+ * unbase64ed and decrypted a character at a time so that files of any
+ * size can be sent.  If LPASS_MOCK_ATTACH_FILE is set the decrypted
+ * attachment is written there.
+ */
+struct b64_decoder {
+	unsigned char quad[4];
+	int n;
+};
+
+struct mock_attach {
+	EVP_CIPHER_CTX *ctx;
+	unsigned char *key;
+	int stage;
+	char iv[32];
+	size_t iv_len;
+	struct b64_decoder ctext, ptext;
+	int pct;
+	char pct_hex[3];
+	FILE *out;
+	bool bad;
+};
+
+static int b64_feed(struct b64_decoder *dec, char c, unsigned char *out)
+{
+	int len;
+
+	dec->quad[dec->n++] = c;
+	if (dec->n < 4)
+		return 0;
+	dec->n = 0;
+	len = EVP_DecodeBlock(out, dec->quad, 4);
+	if (len < 0)
+		return -1;
+	if (dec->quad[3] == '=')
+		len--;
+	if (dec->quad[2] == '=')
+		len--;
+	return len;
+}
+
+static void mock_attach_ptext(struct mock_attach *attach,
+			      unsigned char *ptext, int len)
+{
+	unsigned char bytes[3];
+	int i, n;
+
+	for (i = 0; i < len; i++) {
+		n = b64_feed(&attach->ptext, ptext[i], bytes);
+		if (n < 0)
+			attach->bad = true;
+		else if (n && attach->out)
+			fwrite(bytes, 1, n, attach->out);
+	}
+}
+
+static void mock_attach_char(struct mock_attach *attach, char c)
+{
+	_cleanup_free_ unsigned char *iv = NULL;
+	unsigned char ctext[3], ptext[3 + 16];
+	int n, len;
+
+	switch (attach->stage) {
+	case 0:
+		attach->bad |= c != '!';
+		attach->stage++;
+		break;
+	case 1:
+		if (c != '|') {
+			if (attach->iv_len < sizeof(attach->iv) - 1)
+				attach->iv[attach->iv_len++] = c;
+			break;
+		}
+		if (unbase64(attach->iv, &iv) != 16 ||
+		    !EVP_DecryptInit_ex(attach->ctx, EVP_aes_256_cbc(), NULL,
+					attach->key, iv))
+			attach->bad = true;
+		attach->stage++;
+		break;
+	default:
+		n = b64_feed(&attach->ctext, c, ctext);
+		attach->bad |= n < 0;
+		if (n <= 0)
+			break;
+		if (!EVP_DecryptUpdate(attach->ctx, ptext, &len, ctext, n))
+			attach->bad = true;
+		else
+			mock_attach_ptext(attach, ptext, len);
+	}
+}
+
+static void mock_attach_body(struct mock_attach *attach, char *buf, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		if (buf[i] == '%') {
+			attach->pct = 1;
+		} else if (attach->pct) {
+			attach->pct_hex[attach->pct++ - 1] = buf[i];
+			if (attach->pct == 3) {
+				attach->pct = 0;
+				mock_attach_char(attach,
+					strtoul(attach->pct_hex, NULL, 16));
+			}
+		} else {
+			mock_attach_char(attach, buf[i]);
+		}
+	}
+}
+
+/*
+ * The mock vault starts without attach keys, so the first upload must
+ * send one.  When LPASS_MOCK_ATTACH_KEY names a file, the key is kept
+ * there: later uploads must reuse it, and sending another is refused
+ * since it would orphan the attachments already stored under the first.
+ */
+static char *addattach(char **argv, http_read_fn read_fn, void *data)
+{
+	_cleanup_free_ char *key_hex = NULL;
+	_cleanup_free_ unsigned char *key = NULL;
+	_cleanup_fclose_ FILE *key_fp = NULL;
+	struct mock_attach attach = { .stage = 0 };
+	char *attachkey = get_param(argv, "attachkey");
+	char *out = getenv("LPASS_MOCK_ATTACH_FILE");
+	char *key_path = getenv("LPASS_MOCK_ATTACH_KEY");
+	char stored[1024] = { 0 };
+	unsigned char ptext[16];
+	char buf[16384];
+	size_t len;
+	int n;
+
+	if (key_path && (key_fp = fopen(key_path, "r"))) {
+		if (!fgets(stored, sizeof(stored), key_fp) || attachkey)
+			return xstrdup("<lastpass rc=\"FAIL\"><error/></lastpass>");
+		attachkey = stored;
+	}
+	if (attachkey)
+		key_hex = cipher_aes_decrypt_base64(attachkey, test_data.key);
+	if (!key_hex || hex_to_bytes(key_hex, &key))
+		return xstrdup("<lastpass rc=\"FAIL\"><error/></lastpass>");
+
+	attach.key = key;
+	attach.ctx = EVP_CIPHER_CTX_new();
+	attach.out = out ? fopen(out, "wb") : NULL;
+	while ((len = read_fn(buf, sizeof(buf), data)) > 0 &&
+	       len != HTTP_READ_ABORT)
+		mock_attach_body(&attach, buf, len);
+
+	if (!EVP_DecryptFinal_ex(attach.ctx, ptext, &n))
+		attach.bad = true;
+	else
+		mock_attach_ptext(&attach, ptext, n);
+	EVP_CIPHER_CTX_free(attach.ctx);
+	if (attach.out)
+		fclose(attach.out);
+
+	if (len == HTTP_READ_ABORT || attach.bad || attach.stage != 2 ||
+	    attach.ctext.n || attach.ptext.n)
+		return xstrdup("<lastpass rc=\"FAIL\"><error/></lastpass>");
+	if (key_path && !key_fp && (key_fp = fopen(key_path, "w")))
+		fputs(attachkey, key_fp);
+	return xstrdup("<lastpass rc=\"OK\"><result/></lastpass>");
+}
+
+/* Streaming counterpart of http_post_lastpass_v_noexit(). */
+char *http_post_lastpass_stream(const char *page, const struct session *session,
+				size_t *final_len, char **argv,
+				const char *name, http_read_fn read_fn, void *data,
+				int *curl_ret, long *http_code)
+{
+	static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+	char *response;
+	UNUSED(session);
+	UNUSED(name);
+
+	pthread_mutex_lock(&lock);
+	init_test_data();
+
+	*curl_ret = 0;
+	*http_code = 200;
+
+	if (!strcmp(page, "addattach.php")) {
+		response = addattach(argv, read_fn, data);
+	} else {
+		fprintf(stderr, "unhandled page: %s\n", page);
+		response = xstrdup("<response><error message=\"unimplemented\"/></response>");
+	}
 	if (final_len)
 		*final_len = strlen(response);
+	pthread_mutex_unlock(&lock);
 	return response;
 }
@@ -8,7 +8,7 @@ function setup()
 	export TEST_USER="user@example.com"
 	export TEST_PASS="123456"
 	export TEST_WRONG_PASS="000000"
-	export TEST_LPASS="../build/lpass-test"
+	export TEST_LPASS="${TEST_LPASS:-../build/lpass-test}"
 	export LPASS_HOME="./.lpass"
 }
 
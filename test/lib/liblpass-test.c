@@ -0,0 +1,289 @@
+/*
+ * checks of the liblpass interface against the test vault
+ *
+ * Copyright (C) 2014-2024 LastPass.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ *
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ *
+ * See LICENSE.OpenSSL for more details regarding this exception.
+ */
+#include "../../liblpass.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Usage: liblpass-test
+ *
+ * Run with LPASS_HOME holding a session saved by `lpass login
+ * --plaintext-key` and the mock server's vault, as test_liblpass sets
+ * up.  Each failed check is printed, and the exit status is non-zero
+ * if there were any.
+ */
+
+#define THREAD_ROUNDS 200
+
+#define check(failures, cond) do { \
+	if (!(cond)) { \
+		fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+		(failures)++; \
+	} \
+} while (0)
+
+/* whether field of entry id reads back as expected */
+static bool field_is(struct lpass *lp, const char *id, const char *field,
+		     const char *expected)
+{
+	char *value = NULL, *error = NULL;
+	bool ret;
+
+	ret = !lpass_get_field(lp, id, field, &value, &error) &&
+	      !strcmp(value, expected);
+	if (!ret)
+		fprintf(stderr, "%s of %s: \"%s\" (%s), expected \"%s\"\n", field, id,
+			value ? value : "", error ? error : "no error", expected);
+	free(value);
+	free(error);
+	return ret;
+}
+
+static size_t count_matches(struct lpass *lp, const char *pattern, enum lpass_match match)
+{
+	struct lpass_entry **entries;
+	size_t count;
+
+	if (lpass_find(lp, pattern, match, &entries, &count, NULL))
+		return (size_t) -1;
+	lpass_entries_free(entries, count);
+	return count;
+}
+
+static int test_find(struct lpass *lp)
+{
+	struct lpass_entry **entries;
+	size_t count;
+	int failures = 0;
+
+	check(failures, !lpass_find(lp, "test-account", LPASS_MATCH_EXACT,
+				    &entries, &count, NULL));
+	check(failures, count == 1);
+	if (count == 1) {
+		check(failures, !strcmp(entries[0]->id, "0001"));
+		check(failures, !strcmp(entries[0]->fullname, "test-group/test-account"));
+		check(failures, !strcmp(entries[0]->password, "test-account-password"));
+		check(failures, !entries[0]->share);
+	}
+	lpass_entries_free(entries, count);
+
+	check(failures, count_matches(lp, "REPROMPT", LPASS_MATCH_SUBSTRING) == 2);
+	check(failures, count_matches(lp, "note$", LPASS_MATCH_REGEX) == 2);
+	check(failures, count_matches(lp, "no-such-entry", LPASS_MATCH_EXACT) == 0);
+	return failures;
+}
+
+static int test_fields(struct lpass *lp)
+{
+	struct lpass *other;
+	char *value = NULL, *error = NULL;
+	int failures = 0;
+
+	check(failures, field_is(lp, "0001", "username", "xyz@example.com"));
+	check(failures, field_is(lp, "0001", "url", "https://test-url.example.com/"));
+	/*
+	 * secure notes read through their expansion, which keeps the space
+	 * after each colon of the note, as lpass show prints
+	 */
+	check(failures, field_is(lp, "0002", "Hostname", " foo.example.com"));
+	check(failures, field_is(lp, "0002", "username", " test-note-user"));
+
+	check(failures, lpass_get_field(lp, "0001", "no-such-field", &value, &error) == -ENOENT);
+	check(failures, !value && error);
+	free(error);
+	error = NULL;
+	check(failures, lpass_get_field(lp, "9999", "name", &value, NULL) == -ENOENT);
+
+	check(failures, !lpass_set_field(lp, "0001", "username", "lib-user", NULL));
+	check(failures, field_is(lp, "0001", "username", "lib-user"));
+	check(failures, !lpass_set_field(lp, "0002", "Hostname", "bar.example.com", NULL));
+	check(failures, field_is(lp, "0002", "Hostname", "bar.example.com"));
+	check(failures, lpass_set_field(lp, "0001", "id", "0005", NULL) == -EINVAL);
+	check(failures, lpass_set_field(lp, "0001", "Hostname", "x", NULL) == -EINVAL);
+
+	/* the changes are saved to the local vault */
+	check(failures, !lpass_open(&other, NULL, NULL));
+	if (other) {
+		check(failures, field_is(other, "0001", "username", "lib-user"));
+		check(failures, field_is(other, "0002", "Hostname", "bar.example.com"));
+		lpass_close(other);
+	}
+	return failures;
+}
+
+static char *read_file(const char *path, size_t *len)
+{
+	FILE *fp = fopen(path, "rb");
+	char *buf = NULL;
+	long size;
+
+	if (!fp)
+		return NULL;
+	if (!fseek(fp, 0, SEEK_END) && (size = ftell(fp)) >= 0 &&
+	    !fseek(fp, 0, SEEK_SET)) {
+		buf = malloc(size ? size : 1);
+		*len = buf ? fread(buf, 1, size, fp) : 0;
+	}
+	fclose(fp);
+	return buf;
+}
+
+static bool write_file(const char *path, const char *buf, size_t len)
+{
+	FILE *fp = fopen(path, "wb");
+	bool ret;
+
+	if (!fp)
+		return false;
+	ret = fwrite(buf, 1, len, fp) == len;
+	return !fclose(fp) && ret;
+}
+
+/* a corrupt vault makes calls fail with a code, not end the process */
+static int test_errors(struct lpass *lp, const char *home)
+{
+	static const char garbage[] = "this is not a vault";
+	struct lpass *other;
+	char *path, *saved, *value = NULL, *error = NULL;
+	size_t len = 0;
+	int failures = 0;
+
+	check(failures, lpass_open(&other, "wrong password", &error) == -EACCES);
+	check(failures, !other && error);
+	free(error);
+	error = NULL;
+
+	if (asprintf(&path, "%s/blob", home) < 0)
+		return failures + 1;
+	saved = read_file(path, &len);
+	check(failures, saved != NULL);
+	if (!saved) {
+		free(path);
+		return failures;
+	}
+
+	check(failures, write_file(path, garbage, sizeof(garbage) - 1));
+	check(failures, lpass_reload(lp, &error) < 0);
+	check(failures, error != NULL);
+	free(error);
+	error = NULL;
+	check(failures, lpass_get_field(lp, "0001", "name", &value, &error) < 0);
+	check(failures, !value && error);
+	free(error);
+	check(failures, lpass_open(&other, NULL, NULL) < 0 && !other);
+
+	/* and the handle recovers once the vault is readable again */
+	check(failures, write_file(path, saved, len));
+	check(failures, !lpass_reload(lp, NULL));
+	check(failures, field_is(lp, "0001", "name", "test-account"));
+
+	free(saved);
+	free(path);
+	return failures;
+}
+
+static void *thread_reads(void *arg)
+{
+	struct lpass *lp = arg;
+	intptr_t failures = 0;
+	int i;
+
+	for (i = 0; i < THREAD_ROUNDS; i++) {
+		check(failures, count_matches(lp, "test-group/", LPASS_MATCH_SUBSTRING) == 4);
+		check(failures, field_is(lp, "0001", "password", "test-account-password"));
+		check(failures, field_is(lp, "0002", "password", " test-note-password"));
+	}
+	return (void *) failures;
+}
+
+/* each handle used from a thread of its own, at the same time */
+static int test_threads(void)
+{
+	struct lpass *lp[2] = { NULL, NULL };
+	pthread_t thread[2];
+	void *thread_failures;
+	int failures = 0, i;
+
+	for (i = 0; i < 2; i++)
+		check(failures, !lpass_open(&lp[i], NULL, NULL));
+	if (failures)
+		goto out;
+
+	for (i = 0; i < 2; i++)
+		check(failures, !pthread_create(&thread[i], NULL, thread_reads, lp[i]));
+	if (failures)
+		goto out;
+	for (i = 0; i < 2; i++) {
+		pthread_join(thread[i], &thread_failures);
+		failures += (intptr_t) thread_failures;
+	}
+out:
+	for (i = 0; i < 2; i++)
+		lpass_close(lp[i]);
+	return failures;
+}
+
+int main(void)
+{
+	const char *home = getenv("LPASS_HOME");
+	struct lpass *lp;
+	char *error = NULL;
+	int failures = 0;
+
+	if (!home) {
+		fprintf(stderr, "LPASS_HOME must be set.\n");
+		return EXIT_FAILURE;
+	}
+	if (lpass_open(&lp, NULL, &error)) {
+		fprintf(stderr, "lpass_open: %s\n", error ? error : "failed");
+		free(error);
+		return EXIT_FAILURE;
+	}
+
+	failures += test_find(lp);
+	failures += test_threads();
+	failures += test_fields(lp);
+	failures += test_errors(lp, home);
+	lpass_close(lp);
+
+	if (failures)
+		fprintf(stderr, "%d checks failed\n", failures);
+	return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,232 @@
+/*
+ * resource usage measurement for the perf suite
+ *
+ * Copyright (C) 2014-2024 LastPass.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ *
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ *
+ * See LICENSE.OpenSSL for more details regarding this exception.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#if defined(__linux__)
+#include <sys/ptrace.h>
+#define HAVE_SYSCALL_COUNT 1
+#endif
+
+/*
+ * Usage: lpass-perf-measure [--syscalls] [--] COMMAND [ARGS...]
+ *
+ * Runs COMMAND with its standard output and error discarded (standard
+ * input is inherited) and prints a single line:
+ *
+ *     wall_us user_us sys_us maxrss_kb syscalls first_out_us
+ *
+ * first_out_us is the time until COMMAND first writes to its standard
+ * output, or -1 if it never does.  The syscall count is only collected
+ * with --syscalls, since tracing distorts the timings; otherwise it is
+ * reported as -1.  With --syscalls the output goes straight to
+ * /dev/null and first_out_us is -1.  The exit status is that of COMMAND.
+ */
+
+static long long timeval_us(const struct timeval *tv)
+{
+	return (long long) tv->tv_sec * 1000000 + tv->tv_usec;
+}
+
+static long long now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void exec_child(char **argv, bool trace, int out)
+{
+	int null = open("/dev/null", O_WRONLY);
+
+	if (null >= 0) {
+		dup2(out >= 0 ? out : null, STDOUT_FILENO);
+		dup2(null, STDERR_FILENO);
+		close(null);
+	}
+	if (out >= 0)
+		close(out);
+#ifdef HAVE_SYSCALL_COUNT
+	if (trace) {
+		if (ptrace(PTRACE_TRACEME, 0, NULL, NULL) < 0)
+			_exit(126);
+		raise(SIGSTOP);
+	}
+#else
+	(void) trace;
+#endif
+	execvp(argv[0], argv);
+	_exit(127);
+}
+
+#ifdef HAVE_SYSCALL_COUNT
+/*
+ * Step the traced child from syscall stop to syscall stop until it
+ * exits.  Each syscall produces an entry and an exit stop.
+ */
+static long long count_syscalls(pid_t child, int *status, struct rusage *usage)
+{
+	long long stops = 0;
+	int sig = 0;
+
+	if (wait4(child, status, 0, usage) < 0 || !WIFSTOPPED(*status))
+		return -1;
+	ptrace(PTRACE_SETOPTIONS, child, NULL, (void *) PTRACE_O_TRACESYSGOOD);
+
+	for (;;) {
+		if (ptrace(PTRACE_SYSCALL, child, NULL, (void *)(long) sig) < 0)
+			return -1;
+		if (wait4(child, status, 0, usage) < 0)
+			return -1;
+		if (WIFEXITED(*status) || WIFSIGNALED(*status))
+			break;
+
+		sig = 0;
+		if (WSTOPSIG(*status) == (SIGTRAP | 0x80))
+			stops++;
+		else if (WSTOPSIG(*status) != SIGTRAP)
+			sig = WSTOPSIG(*status);
+	}
+	return (stops + 1) / 2;
+}
+#else
+static long long count_syscalls(pid_t child, int *status, struct rusage *usage)
+{
+	(void) child;
+	(void) status;
+	(void) usage;
+	return -1;
+}
+#endif
+
+/*
+ * Drain the child's output until it closes it, and return the time the
+ * first of it arrived, or -1.
+ */
+static long long drain_output(int fd)
+{
+	char buf[65536];
+	long long first = -1;
+	ssize_t len;
+
+	for (;;) {
+		len = read(fd, buf, sizeof(buf));
+		if (len < 0 && errno == EINTR)
+			continue;
+		if (len <= 0)
+			break;
+		if (first < 0)
+			first = now_us();
+	}
+	close(fd);
+	return first;
+}
+
+int main(int argc, char **argv)
+{
+	struct rusage usage;
+	long long start, wall, syscalls = -1, first_out = -1;
+	bool trace = false;
+	int status = 0;
+	int out[2] = { -1, -1 };
+	pid_t child;
+	int i = 1;
+
+	if (i < argc && !strcmp(argv[i], "--syscalls")) {
+#ifdef HAVE_SYSCALL_COUNT
+		trace = true;
+#endif
+		i++;
+	}
+	if (i < argc && !strcmp(argv[i], "--"))
+		i++;
+	if (i >= argc) {
+		fprintf(stderr, "Usage: %s [--syscalls] [--] COMMAND [ARGS...]\n", argv[0]);
+		return 2;
+	}
+
+	if (!trace && pipe(out) < 0) {
+		perror("pipe");
+		return 2;
+	}
+
+	memset(&usage, 0, sizeof(usage));
+	start = now_us();
+	child = fork();
+	if (child < 0) {
+		perror("fork");
+		return 2;
+	}
+	if (!child) {
+		if (out[0] >= 0)
+			close(out[0]);
+		exec_child(&argv[i], trace, out[1]);
+	}
+
+	if (!trace) {
+		close(out[1]);
+		first_out = drain_output(out[0]);
+		if (first_out >= 0)
+			first_out -= start;
+	}
+
+	if (trace)
+		syscalls = count_syscalls(child, &status, &usage);
+	else if (wait4(child, &status, 0, &usage) < 0) {
+		perror("wait4");
+		return 2;
+	}
+	wall = now_us() - start;
+
+	printf("%lld %lld %lld %ld %lld %lld\n", wall,
+	       timeval_us(&usage.ru_utime), timeval_us(&usage.ru_stime),
+	       usage.ru_maxrss, syscalls, first_out);
+
+	if (WIFEXITED(status))
+		return WEXITSTATUS(status);
+	return 1;
+}
@@ -43,6 +43,7 @@
 #include "process.h"
 #include "password.h"
 #include "endpoints.h"
+#include "xml.h"
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <time.h>
@@ -55,6 +56,7 @@
 #include <dirent.h>
 #include <fcntl.h>
 #include <signal.h>
+#include <pthread.h>
 
 /* keep around failed updates for a couple of weeks */
 #define FAIL_MAX_AGE	86400 * 14
@@ -162,7 +164,12 @@ static void upload_queue_drop(const char *name)
 	upload_queue_cleanup_failures();
 }
 
-static char *upload_queue_next_entry(unsigned const char key[KDF_HASH_LEN], char **name, char **lock)
+/*
+ * Take the oldest entry queued after the one numbered after, or the
+ * oldest one if that is 0, and lock it.
+ */
+static char *upload_queue_next_entry(unsigned const char key[KDF_HASH_LEN], unsigned long long after,
+				     char **name, char **lock)
 {
 	unsigned long long smallest = ULLONG_MAX, current;
 	_cleanup_free_ char *smallest_name = NULL;
@@ -186,7 +193,7 @@ static char *upload_queue_next_entry(unsigned const char key[KDF_HASH_LEN], char
 		if (*p)
 			continue;
 		current = strtoull(entry->d_name, NULL, 10);
-		if (!current)
+		if (!current || current <= after)
 			continue;
 		if (current < smallest) {
 			smallest = current;
@@ -239,109 +246,278 @@ static void upload_queue_cleanup(int signal)
 	config_unlink("uploader.pid");
 	_exit(EXIT_SUCCESS);
 }
-static void upload_queue_upload_all(const struct session *session, unsigned const char key[KDF_HASH_LEN])
+/* how many queued batches are sent at once */
+#define UPLOAD_QUEUE_JOBS 4
+
+struct upload_job {
+	char *name;
+	char *lock;
+	char *entry;
+	char **argv;
+	unsigned long long serial;
+	bool fetch_blob;
+};
+
+struct upload_jobs {
+	const struct session *session;
+	struct upload_job **jobs;
+	size_t count;
+	size_t next;
+	pthread_mutex_t lock;
+};
+
+static struct upload_job *upload_job_next(unsigned const char key[KDF_HASH_LEN], unsigned long long after)
 {
-	char *entry, *next_entry, *result;
-	int size;
-	char **argv = NULL;
+	struct upload_job *job = new0(struct upload_job, 1);
 	char **argv_ptr;
-	char *name, *lock, *p;
+	char *p, *next_entry;
 	bool do_break;
-	bool should_fetch_new_blob_after = false;
-	int curl_ret;
-	long http_code;
-	bool http_failed_all;
-	int backoff;
-	int backoff_scale = 8;
-
-	while ((entry = upload_queue_next_entry(key, &name, &lock))) {
+	int size;
 
-		lpass_log(LOG_DEBUG, "UQ: processing job %s\n", name);
+	for (;;) {
+		job->entry = upload_queue_next_entry(key, after, &job->name, &job->lock);
+		if (!job->entry) {
+			free(job);
+			return NULL;
+		}
+		job->serial = strtoull(strrchr(job->name, '/') + 1, NULL, 10);
 
+		/* one line per value, the last of which may be empty */
 		size = 0;
-		for (p = entry; *p; ++p) {
+		for (p = job->entry; *p; ++p) {
 			if (*p == '\n')
 				++size;
 		}
-		if (p > entry && p[-1] != '\n')
+		if (p > job->entry)
 			++size;
-		if (size < 1) {
-			config_unlink(name);
-			config_unlink(lock);
-			goto end;
+		if (size >= 1)
+			break;
+
+		config_unlink(job->name);
+		config_unlink(job->lock);
+		free(job->name);
+		free(job->lock);
+		free(job->entry);
+	}
+
+	argv_ptr = job->argv = xcalloc(size + 1, sizeof(char **));
+	for (do_break = false, p = job->entry, next_entry = job->entry; ; ++p) {
+		if (!*p)
+			do_break = true;
+		if (*p == '\n' || !*p) {
+			*p = '\0';
+			*(argv_ptr++) = pinentry_unescape(next_entry);
+			next_entry = p + 1;
+			if (do_break)
+				break;
 		}
-		argv_ptr = argv = xcalloc(size + 1, sizeof(char **));
-		for (do_break = false, p = entry, next_entry = entry; ; ++p) {
-			if (!*p)
-				do_break = true;
-			if (*p == '\n' || !*p) {
-				*p = '\0';
-				*(argv_ptr++) = pinentry_unescape(next_entry);
-				next_entry = p + 1;
-				if (do_break)
-					break;
-			}
+	}
+	job->argv[size] = NULL;
+	return job;
+}
+
+static void upload_job_free(struct upload_job *job)
+{
+	char **argv_ptr;
+
+	for (argv_ptr = job->argv; *argv_ptr; ++argv_ptr)
+		free(*argv_ptr);
+	free(job->argv);
+	free(job->name);
+	free(job->lock);
+	free(job->entry);
+	free(job);
+}
+
+/*
+ * Batches of updated or moved accounts are the api.php requests.  They
+ * can go in any order, unless they touch the same accounts.
+ */
+static bool upload_job_is_batch(struct upload_job *job)
+{
+	return !strcmp(job->argv[0], "lastpass/api.php");
+}
+
+/* Whether two batches update any account in common. */
+static bool upload_jobs_overlap(struct upload_job *a, struct upload_job *b)
+{
+	char **p, **q;
+
+	for (p = &a->argv[1]; p[0] && p[1]; p += 2) {
+		if (!starts_with(p[0], "aid"))
+			continue;
+		for (q = &b->argv[1]; q[0] && q[1]; q += 2) {
+			if (starts_with(q[0], "aid") && !strcmp(p[1], q[1]))
+				return true;
 		}
-		argv[size] = NULL;
-
-		http_failed_all = true;
-		backoff = 1;
-		for (int i = 0; i < 5; ++i) {
-			if (i) {
-				lpass_log(LOG_DEBUG, "UQ: attempt %d, sleeping %d seconds\n", i+1, backoff);
-				sleep(backoff);
-				backoff *= backoff_scale;
-			}
+	}
+	return false;
+}
 
-			lpass_log(LOG_DEBUG, "UQ: posting to %s\n", argv[0]);
+static void upload_job_run(const struct session *session, struct upload_job *job)
+{
+	char **argv = job->argv;
+	char *result;
+	int curl_ret;
+	long http_code;
+	bool http_failed_all;
+	bool refused = false;
+	int backoff;
+	int backoff_scale = 8;
+
+	lpass_log(LOG_DEBUG, "UQ: processing job %s\n", job->name);
 
-			result = http_post_lastpass_v_noexit(session->server, argv[0],
-				session, NULL, &argv[1],
-				&curl_ret, &http_code);
+	http_failed_all = true;
+	backoff = 1;
+	for (int i = 0; i < 5; ++i) {
+		if (i) {
+			lpass_log(LOG_DEBUG, "UQ: attempt %d, sleeping %d seconds\n", i+1, backoff);
+			sleep(backoff);
+			backoff *= backoff_scale;
+		}
 
-			http_failed_all &=
-				(curl_ret == HTTP_ERROR_CODE ||
-				 curl_ret == HTTP_ERROR_CONNECT);
+		lpass_log(LOG_DEBUG, "UQ: posting to %s\n", argv[0]);
 
-			lpass_log(LOG_DEBUG, "UQ: result %d (http_code=%ld)\n", curl_ret, http_code);
+		result = http_post_lastpass_v_noexit(session->server, argv[0],
+			session, NULL, &argv[1],
+			&curl_ret, &http_code);
 
-			if (http_code == 500) {
-				/* not a rate-limit error; try again with less backoff */
-				backoff_scale = 2;
-			} else {
-				backoff_scale = 8;
-			}
+		http_failed_all &=
+			(curl_ret == HTTP_ERROR_CODE ||
+			 curl_ret == HTTP_ERROR_CONNECT);
+
+		lpass_log(LOG_DEBUG, "UQ: result %d (http_code=%ld)\n", curl_ret, http_code);
 
-			if (result && strlen(result))
-				should_fetch_new_blob_after = true;
+		if (http_code == 500) {
+			/* not a rate-limit error; try again with less backoff */
+			backoff_scale = 2;
+		} else {
+			backoff_scale = 8;
+		}
+
+		/*
+		 * A batch the server refused, as when a shared folder's
+		 * key or membership changed under it, would be refused
+		 * again, so it is dropped and the vault fetched again to
+		 * undo what the local copy shows.
+		 */
+		refused = result && upload_job_is_batch(job) && xml_api_err(result);
+		if (refused) {
+			lpass_log(LOG_DEBUG, "UQ: batch refused\n");
+			job->fetch_blob = true;
 			free(result);
-			if (result)
+			result = NULL;
+			break;
+		}
+
+		if (result && strlen(result))
+			job->fetch_blob = true;
+		free(result);
+		if (result)
+			break;
+	}
+	if (!result) {
+		lpass_log(LOG_DEBUG, "UQ: failed, http_failed_all: %d refused: %d\n",
+			  http_failed_all, refused);
+
+		/* server failed response 5 times, remove it */
+		if (http_failed_all || refused)
+			upload_queue_drop(job->name);
+
+		config_unlink(job->lock);
+	} else {
+		lpass_log(LOG_DEBUG, "UQ: succeeded\n");
+		config_unlink(job->name);
+		config_unlink(job->lock);
+	}
+}
+
+static void *upload_jobs_worker(void *arg)
+{
+	struct upload_jobs *state = arg;
+	struct upload_job *job;
+
+	for (;;) {
+		pthread_mutex_lock(&state->lock);
+		job = state->next < state->count ? state->jobs[state->next++] : NULL;
+		pthread_mutex_unlock(&state->lock);
+
+		if (!job)
+			return NULL;
+		upload_job_run(state->session, job);
+	}
+}
+
+/* Send a run of batches, several at a time. */
+static void upload_jobs_run(const struct session *session, struct upload_job **jobs, size_t count)
+{
+	struct upload_jobs state = {
+		.session = session,
+		.jobs = jobs,
+		.count = count,
+	};
+	pthread_t threads[UPLOAD_QUEUE_JOBS - 1];
+	size_t n_threads, i;
+
+	pthread_mutex_init(&state.lock, NULL);
+	n_threads = min(ARRAY_SIZE(threads), count - 1);
+	for (i = 0; i < n_threads; i++) {
+		if (pthread_create(&threads[i], NULL, upload_jobs_worker, &state))
+			break;
+	}
+	upload_jobs_worker(&state);
+	n_threads = i;
+	for (i = 0; i < n_threads; i++)
+		pthread_join(threads[i], NULL);
+	pthread_mutex_destroy(&state.lock);
+}
+
+/*
+ * Send the queued entries, oldest first.  A run of consecutive batches
+ * that touch different entries is sent UPLOAD_QUEUE_JOBS at a time;
+ * everything else, and a batch touching an entry of one before it, is
+ * sent in order.
+ */
+static void upload_queue_upload_all(const struct session *session, unsigned const char key[KDF_HASH_LEN])
+{
+	struct upload_job *jobs[UPLOAD_QUEUE_JOBS];
+	struct upload_job *job, *pending = NULL;
+	bool should_fetch_new_blob_after = false;
+	size_t count, i;
+
+	while ((job = pending ? pending : upload_job_next(key, 0))) {
+		pending = NULL;
+		jobs[0] = job;
+		count = 1;
+
+		while (upload_job_is_batch(job) && count < ARRAY_SIZE(jobs)) {
+			job = upload_job_next(key, jobs[count - 1]->serial);
+			if (!job)
+				break;
+			for (i = 0; i < count && upload_job_is_batch(job); i++) {
+				if (upload_jobs_overlap(jobs[i], job))
+					break;
+			}
+			if (i < count) {
+				pending = job;
 				break;
+			}
+			jobs[count++] = job;
 		}
-		if (!result) {
-			lpass_log(LOG_DEBUG, "UQ: failed, http_failed_all: %d\n", http_failed_all);
 
-			/* server failed response 5 times, remove it */
-			if (http_failed_all)
-				upload_queue_drop(name);
+		if (count > 1)
+			upload_jobs_run(session, jobs, count);
+		else
+			upload_job_run(session, jobs[0]);
 
-			config_unlink(lock);
-		} else {
-			lpass_log(LOG_DEBUG, "UQ: succeeded\n");
-			config_unlink(name);
-			config_unlink(lock);
+		for (i = 0; i < count; i++) {
+			should_fetch_new_blob_after |= jobs[i]->fetch_blob;
+			upload_job_free(jobs[i]);
 		}
-		for (argv_ptr = argv; *argv_ptr; ++argv_ptr)
-			free(*argv_ptr);
-		free(argv);
-end:
-		free(name);
-		free(lock);
-		free(entry);
 	}
 
 	if (should_fetch_new_blob_after)
-		blob_free(lastpass_get_blob(session, key));
+		blob_free(lastpass_get_blob(session, key, true));
 }
 
 static void upload_queue_run(const struct session *session, unsigned const char key[KDF_HASH_LEN])
@@ -0,0 +1,342 @@
+/*
+ * local record of how often entries are used
+ *
+ * Copyright (C) 2014-2018 LastPass.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ *
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ *
+ * See LICENSE.OpenSSL for more details regarding this exception.
+ */
+/*
+ * Every time an entry is shown, an encrypted "id<TAB>time" line is
+ * appended to usage-log, which costs a single write.  Once the log
+ * grows past USAGE_LOG_MAX it is folded into the usage table, an
+ * encrypted "id<TAB>count<TAB>last used" file, and emptied; entries no
+ * longer in the vault are dropped from the table then.  Both are deleted
+ * on logout.
+ *
+ * Writers append to the log under a shared flock(), and the compaction
+ * holds it exclusively from reading the log until it is emptied, so no
+ * record appended meanwhile is lost.  Only one compaction runs at a
+ * time; any other just leaves the log for the next one.
+ */
+#include "usage.h"
+#include "blob.h"
+#include "cipher.h"
+#include "config.h"
+#include "util.h"
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define USAGE_LOG_MAX	(32 * 1024)
+
+static void usage_add(struct usage *usage, size_t *alloced, char *id,
+		      unsigned long count, time_t last_used)
+{
+	if (usage->count == *alloced) {
+		*alloced = *alloced ? *alloced * 2 : 64;
+		usage->entries = xreallocarray(usage->entries, *alloced, sizeof(*usage->entries));
+	}
+	usage->entries[usage->count].id = id;
+	usage->entries[usage->count].count = count;
+	usage->entries[usage->count].last_used = last_used;
+	usage->count++;
+}
+
+static int compare_entry_id(const void *a, const void *b)
+{
+	const struct usage_entry *entry_a = a, *entry_b = b;
+
+	return strcmp(entry_a->id, entry_b->id);
+}
+
+/* sort by id and fold the records of each entry together */
+static void usage_merge(struct usage *usage)
+{
+	size_t i, j;
+
+	if (!usage->count)
+		return;
+
+	qsort(usage->entries, usage->count, sizeof(*usage->entries), compare_entry_id);
+	for (i = 0, j = 1; j < usage->count; j++) {
+		struct usage_entry *last = &usage->entries[i];
+		struct usage_entry *entry = &usage->entries[j];
+
+		if (strcmp(last->id, entry->id)) {
+			usage->entries[++i] = *entry;
+			continue;
+		}
+		last->count += entry->count;
+		if (entry->last_used > last->last_used)
+			last->last_used = entry->last_used;
+		free(entry->id);
+	}
+	usage->count = i + 1;
+}
+
+struct usage *usage_load(unsigned const char key[KDF_HASH_LEN])
+{
+	struct usage *usage = new0(struct usage, 1);
+	_cleanup_free_ char *table = NULL;
+	_cleanup_free_ char *log = NULL;
+	size_t alloced = 0;
+	char *line, *next, *cursor, *id, *count, *last_used;
+
+	table = config_read_encrypted_string("usage", key);
+	for (line = table; line && *line; line = next) {
+		next = strchrnul(line, '\n');
+		if (*next)
+			*next++ = '\0';
+
+		cursor = line;
+		id = strsep(&cursor, "\t");
+		count = strsep(&cursor, "\t");
+		last_used = cursor;
+		if (!count || !last_used)
+			continue;
+		usage_add(usage, &alloced, xstrdup(id),
+			  strtoul(count, NULL, 10), strtoull(last_used, NULL, 10));
+	}
+
+	log = config_read_string("usage-log");
+	for (line = log; line && *line; line = next) {
+		_cleanup_free_ char *record = NULL;
+
+		next = strchrnul(line, '\n');
+		if (*next)
+			*next++ = '\0';
+
+		record = cipher_aes_decrypt_base64(line, key);
+		if (!record)
+			continue;
+		cursor = record;
+		id = strsep(&cursor, "\t");
+		last_used = cursor;
+		if (!last_used)
+			continue;
+		usage_add(usage, &alloced, xstrdup(id), 1, strtoull(last_used, NULL, 10));
+	}
+
+	usage_merge(usage);
+	return usage;
+}
+
+/* whether fd is still the file at path, rather than one since removed */
+static bool same_file(int fd, const char *path)
+{
+	struct stat fd_buf, path_buf;
+
+	return !fstat(fd, &fd_buf) && !stat(path, &path_buf) &&
+	       fd_buf.st_dev == path_buf.st_dev && fd_buf.st_ino == path_buf.st_ino;
+}
+
+static void usage_compact(struct blob *blob, unsigned const char key[KDF_HASH_LEN])
+{
+	_cleanup_free_ char *path = config_path("usage-log");
+	_cleanup_free_ char *table = xstrdup("");
+	_cleanup_free_ bool *present = NULL;
+	const struct usage_entry *entry;
+	struct account *account;
+	struct usage *usage;
+	size_t i;
+	int fd;
+
+	fd = open(path, O_RDWR);
+	if (fd < 0)
+		return;
+	if (flock(fd, LOCK_EX | LOCK_NB) < 0 || !same_file(fd, path)) {
+		close(fd);
+		return;
+	}
+
+	usage = usage_load(key);
+	present = xcalloc(usage->count ? usage->count : 1, sizeof(*present));
+	list_for_each_entry(account, &blob->account_head, list) {
+		entry = usage_find(usage, account->id);
+		if (entry)
+			present[entry - usage->entries] = true;
+	}
+
+	for (i = 0; i < usage->count; i++) {
+		if (!present[i])
+			continue;
+		xstrappendf(&table, "%s\t%lu\t%llu\n", usage->entries[i].id,
+			    usage->entries[i].count,
+			    (unsigned long long) usage->entries[i].last_used);
+	}
+	config_write_encrypted_string("usage", table, key);
+	if (ftruncate(fd, 0) < 0)
+		config_unlink("usage-log");
+	close(fd);
+	usage_free(usage);
+}
+
+/*
+ * Note that the entries in the matches list (linked through
+ * match_list), all from blob, have been used.  Failures are ignored:
+ * the statistics are only a hint.
+ */
+void usage_record_matches(struct list_head *matches, struct blob *blob,
+			  unsigned const char key[KDF_HASH_LEN])
+{
+	_cleanup_free_ char *path = NULL;
+	_cleanup_free_ char *records = xstrdup("");
+	struct account *account;
+	struct stat sbuf;
+	time_t now = time(NULL);
+	size_t len;
+	int fd;
+
+	list_for_each_entry(account, matches, match_list) {
+		_cleanup_free_ char *record = NULL;
+		_cleanup_free_ char *encrypted = NULL;
+
+		xasprintf(&record, "%s\t%llu", account->id, (unsigned long long) now);
+		encrypted = encrypt_and_base64(record, key);
+		xstrappendf(&records, "%s\n", encrypted);
+	}
+
+	path = config_path("usage-log");
+	fd = open(path, O_WRONLY | O_APPEND | O_CREAT, 0600);
+	if (fd < 0)
+		return;
+	len = strlen(records);
+	if (flock(fd, LOCK_SH) < 0 ||
+	    write(fd, records, len) != (ssize_t) len || fstat(fd, &sbuf) < 0) {
+		close(fd);
+		return;
+	}
+	close(fd);
+
+	if (sbuf.st_size > USAGE_LOG_MAX)
+		usage_compact(blob, key);
+}
+
+const struct usage_entry *usage_find(const struct usage *usage, const char *id)
+{
+	struct usage_entry needle = { .id = (char *) id };
+
+	if (!usage->count)
+		return NULL;
+	return bsearch(&needle, usage->entries, usage->count,
+		       sizeof(*usage->entries), compare_entry_id);
+}
+
+struct ranked_account {
+	struct account *account;
+	unsigned long count;
+	time_t last_used;
+	size_t position;
+};
+
+static int compare_rank(const void *a, const void *b)
+{
+	const struct ranked_account *rank_a = a, *rank_b = b;
+
+	if (rank_a->count != rank_b->count)
+		return rank_a->count > rank_b->count ? -1 : 1;
+	if (rank_a->last_used != rank_b->last_used)
+		return rank_a->last_used > rank_b->last_used ? -1 : 1;
+	return rank_a->position < rank_b->position ? -1 : 1;
+}
+
+/*
+ * Order accounts from most to least used, keeping the existing order
+ * among entries used equally often.
+ */
+void usage_sort_accounts(struct account **accounts, size_t count, const struct usage *usage)
+{
+	_cleanup_free_ struct ranked_account *ranked = NULL;
+	const struct usage_entry *entry;
+	size_t i;
+
+	if (!count || !usage->count)
+		return;
+
+	ranked = xcalloc(count, sizeof(*ranked));
+	for (i = 0; i < count; i++) {
+		ranked[i].account = accounts[i];
+		ranked[i].position = i;
+		entry = usage_find(usage, accounts[i]->id);
+		if (entry) {
+			ranked[i].count = entry->count;
+			ranked[i].last_used = entry->last_used;
+		}
+	}
+	qsort(ranked, count, sizeof(*ranked), compare_rank);
+	for (i = 0; i < count; i++)
+		accounts[i] = ranked[i].account;
+}
+
+void usage_sort_matches(struct list_head *matches, const struct usage *usage)
+{
+	_cleanup_free_ struct account **accounts = NULL;
+	struct account *account, *tmp;
+	size_t count = 0, i;
+
+	list_for_each_entry(account, matches, match_list)
+		count++;
+	if (count < 2)
+		return;
+
+	accounts = xcalloc(count, sizeof(*accounts));
+	i = 0;
+	list_for_each_entry_safe(account, tmp, matches, match_list) {
+		accounts[i++] = account;
+		list_del(&account->match_list);
+	}
+	usage_sort_accounts(accounts, count, usage);
+	for (i = 0; i < count; i++)
+		list_add_tail(&accounts[i]->match_list, matches);
+}
+
+void usage_free(struct usage *usage)
+{
+	size_t i;
+
+	if (!usage)
+		return;
+	for (i = 0; i < usage->count; i++)
+		free(usage->entries[i].id);
+	free(usage->entries);
+	free(usage);
+}
+
+void usage_kill(void)
+{
+	config_unlink("usage");
+	config_unlink("usage-log");
+}
@@ -0,0 +1,33 @@
+#ifndef USAGE_H
+#define USAGE_H
+
+#include "kdf.h"
+#include "list.h"
+#include <stddef.h>
+#include <time.h>
+
+struct account;
+struct blob;
+
+struct usage_entry {
+	char *id;
+	unsigned long count;
+	time_t last_used;
+};
+
+/* how often each entry was shown, sorted by id */
+struct usage {
+	struct usage_entry *entries;
+	size_t count;
+};
+
+void usage_record_matches(struct list_head *matches, struct blob *blob,
+			  unsigned const char key[KDF_HASH_LEN]);
+struct usage *usage_load(unsigned const char key[KDF_HASH_LEN]);
+const struct usage_entry *usage_find(const struct usage *usage, const char *id);
+void usage_sort_accounts(struct account **accounts, size_t count, const struct usage *usage);
+void usage_sort_matches(struct list_head *matches, const struct usage *usage);
+void usage_free(struct usage *usage);
+void usage_kill(void);
+
+#endif
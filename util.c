@@ -60,6 +60,8 @@
 #include <ctype.h>
 #include <errno.h>
 #include <limits.h>
+#include <unistd.h>
+#include <sys/socket.h>
 #include <openssl/rand.h>
 
 void warn(const char *err, ...)
@@ -88,6 +90,32 @@ void warn_errno(const char *err, ...)
 	terminal_fprintf(stderr, TERMINAL_FG_YELLOW TERMINAL_BOLD "WARNING" TERMINAL_RESET ": " TERMINAL_FG_YELLOW "%s" TERMINAL_RESET ": %s\n", error_message, message);
 }
 
+static __thread struct error_trap *error_trap;
+
+void error_trap_push(struct error_trap *trap)
+{
+	trap->message[0] = '\0';
+	trap->prev = error_trap;
+	error_trap = trap;
+}
+
+void error_trap_pop(struct error_trap *trap)
+{
+	error_trap = trap->prev;
+}
+
+static void error_trap_raise(const char *message)
+{
+	struct error_trap *trap = error_trap;
+
+	if (!trap)
+		return;
+
+	error_trap_pop(trap);
+	strlcpy(trap->message, message, sizeof(trap->message));
+	longjmp(trap->env, 1);
+}
+
 _noreturn_ void die(const char *err, ...)
 {
 	char message[4096];
@@ -97,6 +125,7 @@ _noreturn_ void die(const char *err, ...)
 	vsnprintf(message, sizeof(message), err, params);
 	va_end(params);
 
+	error_trap_raise(message);
 	terminal_fprintf(stderr, TERMINAL_FG_RED TERMINAL_BOLD "Error" TERMINAL_RESET ": %s\n", message);
 	exit(1);
 }
@@ -111,6 +140,12 @@ _noreturn_ void die_errno(const char *err, ...)
 	vsnprintf(message, sizeof(message), err, params);
 	va_end(params);
 
+	if (error_trap) {
+		char trapped[4096 + 256];
+
+		snprintf(trapped, sizeof(trapped), "%s: %s", error_message, message);
+		error_trap_raise(trapped);
+	}
 	terminal_fprintf(stderr, TERMINAL_FG_RED TERMINAL_BOLD "Error" TERMINAL_RESET ": " TERMINAL_FG_RED "%s" TERMINAL_RESET ": %s\n", error_message, message);
 	exit(1);
 }
@@ -514,3 +549,31 @@ const char *bool_str(bool val)
 {
 	return val ? "1" : "0";
 }
+
+/* Read exactly len bytes from fd; false on error or end of file. */
+bool read_all(int fd, void *buf, size_t len)
+{
+	ssize_t ret;
+	size_t done;
+
+	for (done = 0; done < len; done += ret) {
+		ret = read(fd, (char *) buf + done, len - done);
+		if (ret <= 0)
+			return false;
+	}
+	return true;
+}
+
+/* Write all of buf to socket fd, without SIGPIPE if the peer is gone. */
+bool send_all(int fd, const void *buf, size_t len)
+{
+	ssize_t ret;
+	size_t done;
+
+	for (done = 0; done < len; done += ret) {
+		ret = send(fd, (const char *) buf + done, len - done, MSG_NOSIGNAL);
+		if (ret <= 0)
+			return false;
+	}
+	return true;
+}
@@ -8,6 +8,7 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <stdarg.h>
+#include <setjmp.h>
 
 #ifndef min
 #define min(x,y) (((x) < (y)) ? (x) : (y))
@@ -55,6 +56,20 @@ static inline void freep(void *p) {
 
 void warn(const char *err, ...) _printf_(1, 2);
 void warn_errno(const char *err, ...) _printf_(1, 2);
+
+/*
+ * An error trap catches die() on the calling thread: instead of exiting,
+ * die() stores its message in the innermost trap and longjmps to it.
+ * Used by the library entry points, which must not exit the process.
+ */
+struct error_trap {
+	jmp_buf env;
+	char message[4096];
+	struct error_trap *prev;
+};
+void error_trap_push(struct error_trap *trap);
+void error_trap_pop(struct error_trap *trap);
+
 _noreturn_ void die(const char *err, ...) _printf_(1, 2);
 _noreturn_ void die_errno(const char *err, ...) _printf_(1, 2);
 _noreturn_ void die_usage(const char *usage);
@@ -108,4 +123,7 @@ unsigned long range_rand(unsigned long min, unsigned long max);
 void get_random_bytes(unsigned char *buf, size_t len);
 
 const char *bool_str(bool val);
+
+bool read_all(int fd, void *buf, size_t len);
+bool send_all(int fd, const void *buf, size_t len);
 #endif
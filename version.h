@@ -0,0 +1,2 @@
+#define LASTPASS_CLI_VERSION "1.4.0.GIT"
+#define LASTPASS_CLI_USERAGENT "LastPass-CLI/" LASTPASS_CLI_VERSION